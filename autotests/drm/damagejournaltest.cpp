@@ -0,0 +1,208 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "../../plugins/platforms/drm/damage_journal.h"
+#include <QtTest>
+
+using KWin::DamageJournal;
+
+class DamageJournalTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEmpty();
+    void testAccumulate_data();
+    void testAccumulate();
+    void testUndefinedContent_data();
+    void testUndefinedContent();
+    void testClipToGeometry();
+    void testCapacity();
+    void testGeometryChange_data();
+    void testGeometryChange();
+    void testIndependentOutputs();
+    void testOutputLifecycle();
+};
+
+void DamageJournalTest::testEmpty()
+{
+    DamageJournal journal;
+    journal.setGeometry(QRect(0, 0, 1920, 1080));
+    QCOMPARE(journal.count(), 0);
+    QCOMPARE(journal.capacity(), 10);
+    QCOMPARE(journal.bufferAge(), 0);
+    // nothing is known about any buffer, even the last one has to be repainted completely
+    QCOMPARE(journal.accumulate(1), QRegion(0, 0, 1920, 1080));
+    QCOMPARE(journal.accumulate(2), QRegion(0, 0, 1920, 1080));
+    QCOMPARE(journal.repaintRegion(), QRegion(0, 0, 1920, 1080));
+}
+
+void DamageJournalTest::testAccumulate_data()
+{
+    QTest::addColumn<int>("bufferAge");
+    QTest::addColumn<QRegion>("expected");
+
+    QTest::newRow("1") << 1 << QRegion();
+    QTest::newRow("2") << 2 << QRegion(20, 0, 10, 10);
+    QTest::newRow("3") << 3 << QRegion(20, 0, 10, 10).united(QRect(10, 0, 10, 10));
+    // older than the recorded frames
+    QTest::newRow("4") << 4 << QRegion(0, 0, 100, 100);
+    QTest::newRow("5") << 5 << QRegion(0, 0, 100, 100);
+}
+
+void DamageJournalTest::testAccumulate()
+{
+    DamageJournal journal;
+    journal.setGeometry(QRect(0, 0, 100, 100));
+    journal.add(QRect(0, 0, 10, 10));
+    journal.add(QRect(10, 0, 10, 10));
+    journal.add(QRect(20, 0, 10, 10));
+    QCOMPARE(journal.count(), 3);
+    QFETCH(int, bufferAge);
+    QTEST(journal.accumulate(bufferAge), "expected");
+    journal.setBufferAge(bufferAge);
+    QTEST(journal.repaintRegion(), "expected");
+}
+
+void DamageJournalTest::testUndefinedContent_data()
+{
+    QTest::addColumn<int>("bufferAge");
+
+    QTest::newRow("0") << 0;
+    QTest::newRow("negative") << -1;
+}
+
+void DamageJournalTest::testUndefinedContent()
+{
+    DamageJournal journal;
+    journal.setGeometry(QRect(0, 0, 100, 100));
+    journal.add(QRect(0, 0, 10, 10));
+    journal.add(QRect(10, 0, 10, 10));
+    QFETCH(int, bufferAge);
+    QCOMPARE(journal.accumulate(bufferAge), QRegion(0, 0, 100, 100));
+}
+
+void DamageJournalTest::testClipToGeometry()
+{
+    // damage of other outputs is not recorded
+    DamageJournal journal;
+    journal.setGeometry(QRect(100, 0, 100, 100));
+    journal.add(QRect(100, 0, 10, 10));
+    journal.add(QRegion(0, 0, 100, 100).united(QRect(150, 50, 100, 10)));
+    QCOMPARE(journal.accumulate(2), QRegion(150, 50, 50, 10));
+}
+
+void DamageJournalTest::testCapacity()
+{
+    DamageJournal journal(3);
+    journal.setGeometry(QRect(0, 0, 100, 100));
+    for (int i = 0; i < 5; i++) {
+        journal.add(QRect(i * 10, 0, 10, 10));
+    }
+    QCOMPARE(journal.count(), 3);
+    QCOMPARE(journal.accumulate(3), QRegion(30, 0, 20, 10));
+    // older frames got dropped
+    QCOMPARE(journal.accumulate(4), QRegion(0, 0, 100, 100));
+}
+
+void DamageJournalTest::testGeometryChange_data()
+{
+    QTest::addColumn<QRect>("geometry");
+    QTest::addColumn<bool>("cleared");
+
+    QTest::newRow("unchanged") << QRect(0, 0, 1920, 1080) << false;
+    QTest::newRow("moved") << QRect(1920, 0, 1920, 1080) << true;
+    QTest::newRow("mode") << QRect(0, 0, 1280, 1024) << true;
+    QTest::newRow("rotated") << QRect(0, 0, 1080, 1920) << true;
+}
+
+void DamageJournalTest::testGeometryChange()
+{
+    DamageJournal journal;
+    journal.setGeometry(QRect(0, 0, 1920, 1080));
+    journal.add(QRect(0, 0, 10, 10));
+    journal.add(QRect(10, 0, 10, 10));
+
+    QFETCH(QRect, geometry);
+    journal.setGeometry(geometry);
+    QCOMPARE(journal.geometry(), geometry);
+    QFETCH(bool, cleared);
+    QCOMPARE(journal.count(), cleared ? 0 : 2);
+    // an invalidated journal forces a full repaint until a frame got recorded
+    QCOMPARE(journal.accumulate(1), cleared ? QRegion(geometry) : QRegion());
+    QCOMPARE(journal.accumulate(2), cleared ? QRegion(geometry) : QRegion(10, 0, 10, 10));
+    journal.add(QRect(0, 0, 10, 10));
+    QCOMPARE(journal.accumulate(1), QRegion());
+    QCOMPARE(journal.accumulate(2), cleared ? QRegion(geometry) : QRegion(0, 0, 10, 10));
+}
+
+void DamageJournalTest::testIndependentOutputs()
+{
+    // each output has its own buffers, the frames presented on one output
+    // don't influence the repaint of the other one
+    DamageJournal left;
+    left.setGeometry(QRect(0, 0, 100, 100));
+    DamageJournal right;
+    right.setGeometry(QRect(100, 0, 100, 100));
+
+    const QRegion damage = QRegion(50, 0, 100, 10);
+    left.add(damage);
+    right.add(damage);
+    left.add(QRect(0, 50, 10, 10));
+    right.add(QRect(0, 50, 10, 10));
+    left.add(QRect(0, 60, 10, 10));
+
+    QCOMPARE(left.accumulate(2), QRegion(0, 60, 10, 10));
+    QCOMPARE(left.accumulate(3), QRegion(0, 50, 10, 20));
+    QCOMPARE(right.accumulate(1), QRegion());
+    QCOMPARE(right.accumulate(2), QRegion());
+    QCOMPARE(right.accumulate(3), QRegion(100, 0, 100, 100));
+}
+
+void DamageJournalTest::testOutputLifecycle()
+{
+    // replays what EglGbmBackend does with the journal of an output: created on hotplug,
+    // reset when the surface is recreated for a new mode, buffer age queried after each
+    // presented frame
+    DamageJournal journal;
+    journal.reset();
+    journal.setGeometry(QRect(1920, 0, 1280, 1024));
+    QCOMPARE(journal.repaintRegion(), QRegion(1920, 0, 1280, 1024));
+
+    // double buffering, each buffer has age 2 once both are in use
+    journal.add(QRect(1920, 0, 1280, 1024));
+    journal.setBufferAge(0);
+    QCOMPARE(journal.repaintRegion(), QRegion(1920, 0, 1280, 1024));
+    journal.add(QRect(1920, 0, 1280, 1024));
+    journal.setBufferAge(2);
+    QCOMPARE(journal.repaintRegion(), QRegion(1920, 0, 1280, 1024));
+    journal.add(QRect(1920, 0, 10, 10));
+    QCOMPARE(journal.repaintRegion(), QRegion(1920, 0, 10, 10));
+
+    // a frame without damage isn't presented, the repaired buffer gets reused
+    journal.setBufferAge(1);
+    QCOMPARE(journal.repaintRegion(), QRegion());
+
+    // mode change, the surface gets recreated
+    journal.reset();
+    QCOMPARE(journal.bufferAge(), 0);
+    QCOMPARE(journal.count(), 0);
+    journal.setBufferAge(1);
+    QCOMPARE(journal.repaintRegion(), QRegion(1920, 0, 1280, 1024));
+}
+
+QTEST_GUILESS_MAIN(DamageJournalTest)
+#include "damagejournaltest.moc"
@@ -0,0 +1,191 @@
+/********************************************************************
+KWin - the KDE window manager
+This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "kwin_wayland_test.h"
+#include "platform.h"
+#include "shell_client.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KWayland/Client/surface.h>
+#include <KWayland/Client/xdgshell.h>
+
+using namespace KWin;
+using namespace KWayland::Client;
+
+static const QString s_socketName = QStringLiteral("wayland_test_kwin_client_lookup-0");
+
+class ClientLookupTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testLookup();
+    void testSurfaceDestroyedFirst();
+    void benchmarkFindClientBySurface_data();
+    void benchmarkFindClientBySurface();
+    void benchmarkFindClientById_data();
+    void benchmarkFindClientById();
+
+private:
+    void createClients(int count);
+
+    void destroyClient(int index);
+
+    QList<Surface*> m_surfaces;
+    QList<XdgShellSurface*> m_shellSurfaces;
+    QList<ShellClient*> m_clients;
+};
+
+void ClientLookupTest::initTestCase()
+{
+    qRegisterMetaType<KWin::ShellClient*>();
+    QSignalSpy workspaceCreatedSpy(kwinApp(), &Application::workspaceCreated);
+    QVERIFY(workspaceCreatedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName.toLocal8Bit()));
+
+    kwinApp()->start();
+    QVERIFY(workspaceCreatedSpy.wait());
+    waylandServer()->initWorkspace();
+}
+
+void ClientLookupTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+}
+
+void ClientLookupTest::cleanup()
+{
+    while (!m_clients.isEmpty()) {
+        destroyClient(0);
+    }
+    Test::destroyWaylandConnection();
+}
+
+void ClientLookupTest::createClients(int count)
+{
+    for (int i = 0; i < count; i++) {
+        Surface *surface = Test::createSurface();
+        QVERIFY(surface);
+        XdgShellSurface *shellSurface = Test::createXdgShellStableSurface(surface);
+        QVERIFY(shellSurface);
+        m_surfaces << surface;
+        m_shellSurfaces << shellSurface;
+        ShellClient *client = Test::renderAndWaitForShown(surface, QSize(10, 10), Qt::blue);
+        QVERIFY(client);
+        m_clients << client;
+    }
+}
+
+void ClientLookupTest::destroyClient(int index)
+{
+    ShellClient *client = m_clients.takeAt(index);
+    delete m_shellSurfaces.takeAt(index);
+    delete m_surfaces.takeAt(index);
+    QVERIFY(Test::waitForWindowDestroyed(client));
+}
+
+void ClientLookupTest::testLookup()
+{
+    // verifies that the indexes follow clients being added and removed
+    createClients(3);
+    QCOMPARE(m_clients.count(), 3);
+    for (ShellClient *client : qAsConst(m_clients)) {
+        QVERIFY(client->windowId() != 0);
+        QCOMPARE(waylandServer()->findClient(client->surface()), client);
+        QCOMPARE(waylandServer()->findClient(client->windowId()), client);
+    }
+
+    auto surface = m_clients.first()->surface();
+    const quint32 windowId = m_clients.first()->windowId();
+    destroyClient(0);
+    QVERIFY(!waylandServer()->findClient(surface));
+    QVERIFY(!waylandServer()->findClient(windowId));
+
+    for (ShellClient *client : qAsConst(m_clients)) {
+        QCOMPARE(waylandServer()->findClient(client->surface()), client);
+        QCOMPARE(waylandServer()->findClient(client->windowId()), client);
+    }
+}
+
+void ClientLookupTest::testSurfaceDestroyedFirst()
+{
+    // the client only learns about its removal once the surface is gone, the
+    // index must not keep the stale surface
+    createClients(2);
+    ShellClient *client = m_clients.takeFirst();
+    auto surface = client->surface();
+    const quint32 windowId = client->windowId();
+    delete m_surfaces.takeFirst();
+    delete m_shellSurfaces.takeFirst();
+    QVERIFY(Test::waitForWindowDestroyed(client));
+    QVERIFY(!waylandServer()->findClient(surface));
+    QVERIFY(!waylandServer()->findClient(windowId));
+
+    // a new surface must not find the destroyed client
+    createClients(1);
+    QCOMPARE(waylandServer()->findClient(m_clients.last()->surface()), m_clients.last());
+    QCOMPARE(waylandServer()->findClient(m_clients.first()->surface()), m_clients.first());
+}
+
+void ClientLookupTest::benchmarkFindClientBySurface_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("500") << 500;
+}
+
+void ClientLookupTest::benchmarkFindClientBySurface()
+{
+    // the time per lookup has to be independent of the number of clients
+    QFETCH(int, count);
+    createClients(count);
+    QCOMPARE(m_clients.count(), count);
+    ShellClient *last = m_clients.last();
+
+    QBENCHMARK {
+        QCOMPARE(waylandServer()->findClient(last->surface()), last);
+    }
+}
+
+void ClientLookupTest::benchmarkFindClientById_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("500") << 500;
+}
+
+void ClientLookupTest::benchmarkFindClientById()
+{
+    QFETCH(int, count);
+    createClients(count);
+    QCOMPARE(m_clients.count(), count);
+    ShellClient *last = m_clients.last();
+
+    QBENCHMARK {
+        QCOMPARE(waylandServer()->findClient(last->windowId()), last);
+    }
+}
+
+WAYLANDTEST_MAIN(ClientLookupTest)
+#include "client_lookup_test.moc"
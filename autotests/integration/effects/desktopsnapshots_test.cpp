@@ -0,0 +1,201 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+
+#include "kwin_wayland_test.h"
+
+#include "composite.h"
+#include "effectloader.h"
+#include "effects.h"
+#include "platform.h"
+#include "scene.h"
+#include "shell_client.h"
+#include "virtualdesktops.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include "effect_builtins.h"
+#include "../../../effects/desktopgrid/desktopsnapshots.h"
+
+#include <kwingltexture.h>
+
+#include <KWayland/Client/surface.h>
+#include <KWayland/Client/xdgshell.h>
+
+using namespace KWin;
+
+static const QString s_socketName = QStringLiteral("wayland_test_effects_desktopsnapshots-0");
+
+class DesktopSnapshotsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testMemoryCategory();
+    void testInvalidateOnDamage();
+    void testInvalidateOnDesktopChange();
+    void testClearOnDesktopCountChange();
+};
+
+void DesktopSnapshotsTest::initTestCase()
+{
+    qputenv("XDG_DATA_DIRS", QCoreApplication::applicationDirPath().toUtf8());
+
+    qRegisterMetaType<KWin::ShellClient *>();
+    QSignalSpy workspaceCreatedSpy(kwinApp(), &Application::workspaceCreated);
+    QVERIFY(workspaceCreatedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName.toLocal8Bit()));
+
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    ScriptedEffectLoader loader;
+    const auto builtinNames = BuiltInEffects::availableEffectNames() << loader.listOfKnownEffects();
+    for (const QString &name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("O2"));
+
+    kwinApp()->start();
+    QVERIFY(workspaceCreatedSpy.wait());
+    waylandServer()->initWorkspace();
+
+    auto scene = Compositor::self()->scene();
+    QVERIFY(scene);
+    QCOMPARE(scene->compositingType(), OpenGL2Compositing);
+}
+
+void DesktopSnapshotsTest::init()
+{
+    VirtualDesktopManager::self()->setCount(2);
+    QVERIFY(Test::setupWaylandConnection());
+    // the snapshots are usually rendered while the compositor paints
+    QVERIFY(effects->makeOpenGLContextCurrent());
+}
+
+void DesktopSnapshotsTest::cleanup()
+{
+    Test::destroyWaylandConnection();
+    VirtualDesktopManager::self()->setCount(1);
+}
+
+void DesktopSnapshotsTest::testMemoryCategory()
+{
+    // the snapshots are accounted as effect memory
+    DesktopSnapshots snapshots([](EffectWindow *) { return true; });
+    GLTexture *texture = snapshots.snapshot(1, 0, QSize(128, 102));
+    QVERIFY(texture);
+    QCOMPARE(texture->memoryCategory(), GLTexture::MemoryCategory::Effect);
+    QVERIFY(GLTexture::memoryUsage(GLTexture::MemoryCategory::Effect) >= texture->memoryUsage());
+
+    // a new size replaces the texture
+    texture = snapshots.snapshot(1, 0, QSize(256, 205));
+    QVERIFY(texture);
+    QCOMPARE(texture->size(), QSize(256, 205));
+    QCOMPARE(texture->memoryCategory(), GLTexture::MemoryCategory::Effect);
+}
+
+void DesktopSnapshotsTest::testInvalidateOnDamage()
+{
+    // damaging a window only invalidates the snapshots of its desktop
+    using namespace KWayland::Client;
+    QScopedPointer<Surface> surface(Test::createSurface());
+    QVERIFY(!surface.isNull());
+    QScopedPointer<XdgShellSurface> shellSurface(Test::createXdgShellStableSurface(surface.data()));
+    QVERIFY(!shellSurface.isNull());
+    ShellClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+    QCOMPARE(client->desktop(), 1);
+
+    DesktopSnapshots snapshots([](EffectWindow *) { return true; });
+    QVERIFY(!snapshots.isValid(1, 0));
+    QVERIFY(snapshots.snapshot(1, 0, QSize(128, 102)));
+    QVERIFY(snapshots.snapshot(2, 0, QSize(128, 102)));
+    QVERIFY(snapshots.isValid(1, 0));
+    QVERIFY(snapshots.isValid(2, 0));
+
+    QSignalSpy damagedSpy(effects, &EffectsHandler::windowDamaged);
+    QVERIFY(damagedSpy.isValid());
+    Test::render(surface.data(), QSize(100, 50), Qt::red);
+    QVERIFY(damagedSpy.wait());
+    QVERIFY(!snapshots.isValid(1, 0));
+    QVERIFY(snapshots.isValid(2, 0));
+
+    // rendering the snapshot again makes it valid
+    QVERIFY(snapshots.snapshot(1, 0, QSize(128, 102)));
+    QVERIFY(snapshots.isValid(1, 0));
+
+    // and so does a new size
+    QVERIFY(snapshots.snapshot(2, 0, QSize(64, 51)));
+    QVERIFY(snapshots.isValid(2, 0));
+}
+
+void DesktopSnapshotsTest::testInvalidateOnDesktopChange()
+{
+    // moving a window to another desktop invalidates the snapshots of both desktops
+    using namespace KWayland::Client;
+    QScopedPointer<Surface> surface(Test::createSurface());
+    QVERIFY(!surface.isNull());
+    QScopedPointer<XdgShellSurface> shellSurface(Test::createXdgShellStableSurface(surface.data()));
+    QVERIFY(!shellSurface.isNull());
+    ShellClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+    QCOMPARE(client->desktop(), 1);
+
+    DesktopSnapshots snapshots([](EffectWindow *) { return true; });
+    QVERIFY(snapshots.snapshot(1, 0, QSize(128, 102)));
+    QVERIFY(snapshots.snapshot(2, 0, QSize(128, 102)));
+
+    QSignalSpy desktopPresenceChangedSpy(effects, &EffectsHandler::desktopPresenceChanged);
+    QVERIFY(desktopPresenceChangedSpy.isValid());
+    workspace()->sendClientToDesktop(client, 2, true);
+    QCOMPARE(desktopPresenceChangedSpy.count(), 1);
+    QVERIFY(!snapshots.isValid(1, 0));
+    QVERIFY(!snapshots.isValid(2, 0));
+
+    // a window on all desktops invalidates all snapshots
+    QVERIFY(snapshots.snapshot(1, 0, QSize(128, 102)));
+    QVERIFY(snapshots.snapshot(2, 0, QSize(128, 102)));
+    client->setOnAllDesktops(true);
+    QCOMPARE(desktopPresenceChangedSpy.count(), 2);
+    QVERIFY(!snapshots.isValid(1, 0));
+    QVERIFY(!snapshots.isValid(2, 0));
+}
+
+void DesktopSnapshotsTest::testClearOnDesktopCountChange()
+{
+    DesktopSnapshots snapshots([](EffectWindow *) { return true; });
+    QVERIFY(snapshots.snapshot(1, 0, QSize(128, 102)));
+    QVERIFY(snapshots.snapshot(2, 0, QSize(128, 102)));
+    const qint64 usage = GLTexture::memoryUsage(GLTexture::MemoryCategory::Effect);
+
+    VirtualDesktopManager::self()->setCount(3);
+    QVERIFY(!snapshots.isValid(1, 0));
+    QVERIFY(!snapshots.isValid(2, 0));
+    // the textures got released
+    QVERIFY(GLTexture::memoryUsage(GLTexture::MemoryCategory::Effect) < usage);
+}
+
+WAYLANDTEST_MAIN(DesktopSnapshotsTest)
+#include "desktopsnapshots_test.moc"
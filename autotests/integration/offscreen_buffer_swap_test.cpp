@@ -0,0 +1,161 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "kwin_wayland_test.h"
+#include "composite.h"
+#include "effects.h"
+#include "options.h"
+#include "platform.h"
+#include "scene.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <kwinglutils.h>
+
+#include <KConfigGroup>
+
+using namespace KWin;
+
+Q_DECLARE_METATYPE(KWin::Options::GlSwapStrategy)
+
+static const QString s_socketName = QStringLiteral("wayland_test_kwin_offscreen_buffer_swap-0");
+
+class OffscreenBufferSwapTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanup();
+
+    void testOption_data();
+    void testOption();
+    void testPopRestoresScreenRenderTarget();
+    void testCreateKeepsScreenRenderTarget();
+};
+
+static GLint boundFramebuffer()
+{
+    GLint framebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    return framebuffer;
+}
+
+void OffscreenBufferSwapTest::initTestCase()
+{
+    QSignalSpy workspaceCreatedSpy(kwinApp(), &Application::workspaceCreated);
+    QVERIFY(workspaceCreatedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName.toLocal8Bit()));
+
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    config->group("Compositing").writeEntry("GLPreferBufferSwap", QStringLiteral("b"));
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("O2"));
+
+    kwinApp()->start();
+    QVERIFY(workspaceCreatedSpy.wait());
+    waylandServer()->initWorkspace();
+
+    auto scene = Compositor::self()->scene();
+    QVERIFY(scene);
+    QCOMPARE(scene->compositingType(), OpenGL2Compositing);
+    QCOMPARE(options->glPreferBufferSwap(), Options::OffscreenBuffer);
+}
+
+void OffscreenBufferSwapTest::cleanup()
+{
+    kwinApp()->config()->group("Compositing").writeEntry("GLPreferBufferSwap", QStringLiteral("b"));
+    options->reloadCompositingSettings(true);
+}
+
+void OffscreenBufferSwapTest::testOption_data()
+{
+    QTest::addColumn<QString>("value");
+    QTest::addColumn<Options::GlSwapStrategy>("expected");
+
+    QTest::newRow("offscreen") << QStringLiteral("b") << Options::OffscreenBuffer;
+    QTest::newRow("copy") << QStringLiteral("c") << Options::CopyFrontBuffer;
+    QTest::newRow("paint") << QStringLiteral("p") << Options::PaintFullScreen;
+    QTest::newRow("extend") << QStringLiteral("e") << Options::ExtendDamage;
+    QTest::newRow("invalid") << QStringLiteral("x") << Options::NoSwapEncourage;
+}
+
+void OffscreenBufferSwapTest::testOption()
+{
+    QFETCH(QString, value);
+    kwinApp()->config()->group("Compositing").writeEntry("GLPreferBufferSwap", value);
+    options->reloadCompositingSettings(true);
+    QTEST(options->glPreferBufferSwap(), "expected");
+}
+
+void OffscreenBufferSwapTest::testPopRestoresScreenRenderTarget()
+{
+    // the screen render target stands in for the default framebuffer once the stack is empty
+    QVERIFY(effects->makeOpenGLContextCurrent());
+    QVERIFY(GLRenderTarget::supported());
+    QCOMPARE(GLRenderTarget::screenRenderTarget(), nullptr);
+
+    GLTexture screenTexture(GL_RGBA8, QSize(64, 64));
+    GLRenderTarget screen(screenTexture);
+    QVERIFY(screen.valid());
+    GLTexture texture(GL_RGBA8, QSize(32, 32));
+    GLRenderTarget target(texture);
+    QVERIFY(target.valid());
+
+    GLRenderTarget::setScreenRenderTarget(&screen);
+    const GLint screenFramebuffer = boundFramebuffer();
+    QVERIFY(screenFramebuffer != 0);
+
+    GLRenderTarget::pushRenderTarget(&target);
+    QVERIFY(boundFramebuffer() != screenFramebuffer);
+    QCOMPARE(GLRenderTarget::popRenderTarget(), &target);
+    QCOMPARE(boundFramebuffer(), screenFramebuffer);
+    QCOMPARE(GLRenderTarget::screenRenderTarget(), &screen);
+
+    GLRenderTarget::setScreenRenderTarget(nullptr);
+    QCOMPARE(boundFramebuffer(), 0);
+}
+
+void OffscreenBufferSwapTest::testCreateKeepsScreenRenderTarget()
+{
+    // creating or disabling a render target while painting keeps rendering into the screen render target
+    QVERIFY(effects->makeOpenGLContextCurrent());
+    QVERIFY(GLRenderTarget::supported());
+
+    GLTexture screenTexture(GL_RGBA8, QSize(64, 64));
+    GLRenderTarget screen(screenTexture);
+    QVERIFY(screen.valid());
+
+    GLRenderTarget::setScreenRenderTarget(&screen);
+    const GLint screenFramebuffer = boundFramebuffer();
+
+    GLTexture texture(GL_RGBA8, QSize(32, 32));
+    GLRenderTarget target(texture);
+    QVERIFY(target.valid());
+    QCOMPARE(boundFramebuffer(), screenFramebuffer);
+
+    QVERIFY(target.enable());
+    QVERIFY(target.disable());
+    QCOMPARE(boundFramebuffer(), screenFramebuffer);
+
+    GLRenderTarget::setScreenRenderTarget(nullptr);
+}
+
+WAYLANDTEST_MAIN(OffscreenBufferSwapTest)
+#include "offscreen_buffer_swap_test.moc"
@@ -0,0 +1,246 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "kwin_wayland_test.h"
+#include "platform.h"
+#include "shell_client.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KWayland/Client/connection_thread.h>
+#include <KWayland/Client/event_queue.h>
+#include <KWayland/Client/registry.h>
+#include <KWayland/Client/surface.h>
+#include <KWayland/Client/xdgshell.h>
+
+#include "wayland-presentation-time-client-protocol.h"
+
+using namespace KWin;
+using namespace KWayland::Client;
+
+static const QString s_socketName = QStringLiteral("wayland_test_kwin_presentation_time-0");
+
+// KWayland doesn't wrap wp_presentation
+class PresentationFeedback : public QObject
+{
+    Q_OBJECT
+public:
+    PresentationFeedback(wp_presentation *presentation, Surface *surface)
+        : m_feedback(wp_presentation_feedback(presentation, *surface))
+    {
+        wp_presentation_feedback_add_listener(m_feedback, &s_listener, this);
+    }
+    ~PresentationFeedback() override {
+        release();
+    }
+
+Q_SIGNALS:
+    void presented();
+    void discarded();
+
+private:
+    void release() {
+        if (m_feedback) {
+            wp_presentation_feedback_destroy(m_feedback);
+            m_feedback = nullptr;
+        }
+    }
+    static void syncOutputCallback(void *data, wp_presentation_feedback *feedback, wl_output *output) {
+        Q_UNUSED(data)
+        Q_UNUSED(feedback)
+        Q_UNUSED(output)
+    }
+    static void presentedCallback(void *data, wp_presentation_feedback *feedback,
+                                  uint32_t tvSecHi, uint32_t tvSecLo, uint32_t tvNsec, uint32_t refresh,
+                                  uint32_t seqHi, uint32_t seqLo, uint32_t flags) {
+        Q_UNUSED(feedback)
+        Q_UNUSED(tvSecHi)
+        Q_UNUSED(tvSecLo)
+        Q_UNUSED(tvNsec)
+        Q_UNUSED(refresh)
+        Q_UNUSED(seqHi)
+        Q_UNUSED(seqLo)
+        Q_UNUSED(flags)
+        auto p = reinterpret_cast<PresentationFeedback*>(data);
+        p->release();
+        emit p->presented();
+    }
+    static void discardedCallback(void *data, wp_presentation_feedback *feedback) {
+        Q_UNUSED(feedback)
+        auto p = reinterpret_cast<PresentationFeedback*>(data);
+        p->release();
+        emit p->discarded();
+    }
+    static const wp_presentation_feedback_listener s_listener;
+
+    wp_presentation_feedback *m_feedback;
+};
+
+const wp_presentation_feedback_listener PresentationFeedback::s_listener = {
+    syncOutputCallback,
+    presentedCallback,
+    discardedCallback
+};
+
+class PresentationTimeTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testPresented();
+    void testReplacedBeforePaint();
+    void testSurfaceDestroyed();
+
+private:
+    EventQueue *m_queue = nullptr;
+    Registry *m_registry = nullptr;
+    wp_presentation *m_presentation = nullptr;
+};
+
+void PresentationTimeTest::initTestCase()
+{
+    qRegisterMetaType<KWin::ShellClient*>();
+
+    QSignalSpy workspaceCreatedSpy(kwinApp(), &Application::workspaceCreated);
+    QVERIFY(workspaceCreatedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName.toLocal8Bit()));
+
+    kwinApp()->start();
+    QVERIFY(workspaceCreatedSpy.wait());
+    waylandServer()->initWorkspace();
+}
+
+void PresentationTimeTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+
+    m_queue = new EventQueue(this);
+    m_queue->setup(Test::waylandConnection());
+    QVERIFY(m_queue->isValid());
+    m_registry = new Registry(this);
+    m_registry->setEventQueue(m_queue);
+    connect(m_registry, &Registry::interfaceAnnounced, this,
+        [this] (const QByteArray &interface, quint32 name, quint32 version) {
+            Q_UNUSED(version)
+            if (interface == QByteArrayLiteral("wp_presentation")) {
+                m_presentation = reinterpret_cast<wp_presentation*>(
+                    wl_registry_bind(*m_registry, name, &wp_presentation_interface, 1));
+            }
+        }
+    );
+    QSignalSpy allAnnounced(m_registry, &Registry::interfacesAnnounced);
+    QVERIFY(allAnnounced.isValid());
+    m_registry->create(Test::waylandConnection());
+    QVERIFY(m_registry->isValid());
+    m_registry->setup();
+    QVERIFY(allAnnounced.wait());
+    QVERIFY(m_presentation);
+}
+
+void PresentationTimeTest::cleanup()
+{
+    if (m_presentation) {
+        wp_presentation_destroy(m_presentation);
+        m_presentation = nullptr;
+    }
+    delete m_registry;
+    m_registry = nullptr;
+    delete m_queue;
+    m_queue = nullptr;
+    Test::destroyWaylandConnection();
+}
+
+void PresentationTimeTest::testPresented()
+{
+    // a committed buffer gets presented once the compositor painted it
+    QScopedPointer<Surface> surface(Test::createSurface());
+    QVERIFY(!surface.isNull());
+    QScopedPointer<XdgShellSurface> shellSurface(Test::createXdgShellStableSurface(surface.data()));
+    QVERIFY(!shellSurface.isNull());
+    ShellClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+
+    PresentationFeedback feedback(m_presentation, surface.data());
+    QSignalSpy presentedSpy(&feedback, &PresentationFeedback::presented);
+    QVERIFY(presentedSpy.isValid());
+    QSignalSpy discardedSpy(&feedback, &PresentationFeedback::discarded);
+    QVERIFY(discardedSpy.isValid());
+    Test::render(surface.data(), QSize(100, 50), Qt::red);
+    Test::flushWaylandConnection();
+    QVERIFY(presentedSpy.wait());
+    QCOMPARE(discardedSpy.count(), 0);
+}
+
+void PresentationTimeTest::testReplacedBeforePaint()
+{
+    // a buffer replaced before the compositor painted it gets discarded
+    QScopedPointer<Surface> surface(Test::createSurface());
+    QVERIFY(!surface.isNull());
+    QScopedPointer<XdgShellSurface> shellSurface(Test::createXdgShellStableSurface(surface.data()));
+    QVERIFY(!shellSurface.isNull());
+    ShellClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+
+    // both commits reach the server in the same dispatch, before the next frame
+    PresentationFeedback replaced(m_presentation, surface.data());
+    QSignalSpy replacedDiscardedSpy(&replaced, &PresentationFeedback::discarded);
+    QVERIFY(replacedDiscardedSpy.isValid());
+    QSignalSpy replacedPresentedSpy(&replaced, &PresentationFeedback::presented);
+    QVERIFY(replacedPresentedSpy.isValid());
+    Test::render(surface.data(), QSize(100, 50), Qt::red);
+
+    PresentationFeedback feedback(m_presentation, surface.data());
+    QSignalSpy presentedSpy(&feedback, &PresentationFeedback::presented);
+    QVERIFY(presentedSpy.isValid());
+    Test::render(surface.data(), QSize(100, 50), Qt::green);
+    Test::flushWaylandConnection();
+
+    QVERIFY(replacedDiscardedSpy.wait());
+    QVERIFY(!presentedSpy.isEmpty() || presentedSpy.wait());
+    QCOMPARE(replacedPresentedSpy.count(), 0);
+}
+
+void PresentationTimeTest::testSurfaceDestroyed()
+{
+    // a surface destroyed with a feedback still pending discards the feedback
+    QScopedPointer<Surface> surface(Test::createSurface());
+    QVERIFY(!surface.isNull());
+    QScopedPointer<XdgShellSurface> shellSurface(Test::createXdgShellStableSurface(surface.data()));
+    QVERIFY(!shellSurface.isNull());
+    ShellClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+
+    PresentationFeedback feedback(m_presentation, surface.data());
+    QSignalSpy discardedSpy(&feedback, &PresentationFeedback::discarded);
+    QVERIFY(discardedSpy.isValid());
+    QSignalSpy presentedSpy(&feedback, &PresentationFeedback::presented);
+    QVERIFY(presentedSpy.isValid());
+    Test::render(surface.data(), QSize(100, 50), Qt::red);
+    shellSurface.reset();
+    surface.reset();
+    Test::flushWaylandConnection();
+
+    QVERIFY(discardedSpy.wait());
+    QCOMPARE(presentedSpy.count(), 0);
+}
+
+WAYLANDTEST_MAIN(PresentationTimeTest)
+#include "presentation_time_test.moc"
@@ -0,0 +1,464 @@
+/********************************************************************
+KWin - the KDE window manager
+This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "kwin_wayland_test.h"
+#include "composite.h"
+#include "cursor.h"
+#include "platform.h"
+#include "replay_trace.h"
+#include "shell_client.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KWayland/Client/connection_thread.h>
+#include <KWayland/Client/shm_pool.h>
+#include <KWayland/Client/surface.h>
+#include <KWayland/Client/xdgshell.h>
+
+#include <QBuffer>
+#include <QTemporaryFile>
+
+#include <linux/input.h>
+
+using namespace KWin;
+using namespace KWayland::Client;
+
+static const QString s_socketName = QStringLiteral("wayland_test_kwin_replay-0");
+
+/**
+ * Replays a trace recorded with KWIN_REPLAY_RECORD as fast as possible.
+ *
+ * Mapped windows are emulated with xdg-shell windows of the same geometry, commits
+ * attach a new buffer of the recorded size with the recorded damage. The time spent
+ * in each subsystem is reported at the end.
+ */
+class ReplayPlayer
+{
+public:
+    ~ReplayPlayer();
+    bool replay(ReplayTraceReader &reader);
+    void report() const;
+
+private:
+    struct Window {
+        Surface *surface = nullptr;
+        XdgShellSurface *shellSurface = nullptr;
+        ShellClient *client = nullptr;
+    };
+    struct Timing {
+        quint64 count = 0;
+        qint64 nanoseconds = 0;
+    };
+    bool map(const ReplayEvent &event);
+    bool unmap(const ReplayEvent &event);
+    bool commit(const ReplayEvent &event);
+    void input(const ReplayEvent &event);
+    void destroyWindow(Window &window);
+
+    QHash<quint32, Window> m_windows;
+    QHash<QPair<int, int>, QImage> m_images;
+    Timing m_input;
+    Timing m_commits;
+    Timing m_windowManagement;
+    Timing m_compositing;
+};
+
+ReplayPlayer::~ReplayPlayer()
+{
+    for (auto it = m_windows.begin(); it != m_windows.end(); ++it) {
+        destroyWindow(it.value());
+    }
+}
+
+bool ReplayPlayer::replay(ReplayTraceReader &reader)
+{
+    QMetaObject::Connection framePainted = QObject::connect(Compositor::self(), &Compositor::framePainted,
+        [this] (qint64 nanoseconds) {
+            m_compositing.count++;
+            m_compositing.nanoseconds += nanoseconds;
+        }
+    );
+    bool ok = true;
+    ReplayEvent event;
+    while (ok && reader.read(&event)) {
+        switch (event.type) {
+        case ReplayEvent::Type::WindowMapped:
+            ok = map(event);
+            break;
+        case ReplayEvent::Type::WindowUnmapped:
+            ok = unmap(event);
+            break;
+        case ReplayEvent::Type::Commit:
+            ok = commit(event);
+            break;
+        default:
+            input(event);
+            break;
+        }
+    }
+    QObject::disconnect(framePainted);
+    return ok && reader.isValid();
+}
+
+bool ReplayPlayer::map(const ReplayEvent &event)
+{
+    QElapsedTimer timer;
+    timer.start();
+    Window window;
+    window.surface = Test::createSurface();
+    window.shellSurface = Test::createXdgShellStableSurface(window.surface);
+    if (!window.surface || !window.shellSurface) {
+        return false;
+    }
+    window.client = Test::renderAndWaitForShown(window.surface, event.geometry.size(), Qt::blue);
+    if (!window.client) {
+        return false;
+    }
+    window.client->move(event.geometry.topLeft());
+    m_windows.insert(event.window, window);
+    m_windowManagement.count++;
+    m_windowManagement.nanoseconds += timer.nsecsElapsed();
+    return true;
+}
+
+bool ReplayPlayer::unmap(const ReplayEvent &event)
+{
+    auto it = m_windows.find(event.window);
+    if (it == m_windows.end()) {
+        return true;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    ShellClient *client = it->client;
+    destroyWindow(*it);
+    m_windows.erase(it);
+    if (!Test::waitForWindowDestroyed(client)) {
+        return false;
+    }
+    m_windowManagement.count++;
+    m_windowManagement.nanoseconds += timer.nsecsElapsed();
+    return true;
+}
+
+bool ReplayPlayer::commit(const ReplayEvent &event)
+{
+    auto it = m_windows.constFind(event.window);
+    if (it == m_windows.constEnd() || event.geometry.isEmpty() || event.damage.isEmpty()) {
+        return true;
+    }
+    const auto size = qMakePair(event.geometry.width(), event.geometry.height());
+    auto imageIt = m_images.find(size);
+    if (imageIt == m_images.end()) {
+        QImage image(event.geometry.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::blue);
+        imageIt = m_images.insert(size, image);
+    }
+    QSignalSpy damagedSpy(it->client, &Toplevel::damaged);
+    QElapsedTimer timer;
+    timer.start();
+    it->surface->attachBuffer(Test::waylandShmPool()->createBuffer(*imageIt));
+    it->surface->damage(QRect(QPoint(0, 0), event.damage));
+    it->surface->commit(Surface::CommitFlag::None);
+    Test::flushWaylandConnection();
+    if (!damagedSpy.wait()) {
+        return false;
+    }
+    m_commits.count++;
+    m_commits.nanoseconds += timer.nsecsElapsed();
+    return true;
+}
+
+void ReplayPlayer::input(const ReplayEvent &event)
+{
+    Platform *platform = kwinApp()->platform();
+    QElapsedTimer timer;
+    timer.start();
+    switch (event.type) {
+    case ReplayEvent::Type::PointerMotion:
+        platform->pointerMotion(event.position, event.time);
+        break;
+    case ReplayEvent::Type::PointerButtonPressed:
+        platform->pointerButtonPressed(event.code, event.time);
+        break;
+    case ReplayEvent::Type::PointerButtonReleased:
+        platform->pointerButtonReleased(event.code, event.time);
+        break;
+    case ReplayEvent::Type::PointerAxis:
+        if (event.code == Qt::Horizontal) {
+            platform->pointerAxisHorizontal(event.position.x(), event.time);
+        } else {
+            platform->pointerAxisVertical(event.position.x(), event.time);
+        }
+        break;
+    case ReplayEvent::Type::KeyPressed:
+        platform->keyboardKeyPressed(event.code, event.time);
+        break;
+    case ReplayEvent::Type::KeyReleased:
+        platform->keyboardKeyReleased(event.code, event.time);
+        break;
+    case ReplayEvent::Type::TouchDown:
+        platform->touchDown(event.code, event.position, event.time);
+        platform->touchFrame();
+        break;
+    case ReplayEvent::Type::TouchMotion:
+        platform->touchMotion(event.code, event.position, event.time);
+        platform->touchFrame();
+        break;
+    case ReplayEvent::Type::TouchUp:
+        platform->touchUp(event.code, event.time);
+        platform->touchFrame();
+        break;
+    default:
+        Q_UNREACHABLE();
+    }
+    m_input.count++;
+    m_input.nanoseconds += timer.nsecsElapsed();
+    // let the compositor and the clients catch up without waiting for anything
+    QCoreApplication::processEvents();
+}
+
+void ReplayPlayer::destroyWindow(Window &window)
+{
+    delete window.shellSurface;
+    window.shellSurface = nullptr;
+    delete window.surface;
+    window.surface = nullptr;
+    Test::flushWaylandConnection();
+}
+
+void ReplayPlayer::report() const
+{
+    auto print = [] (const char *subsystem, const Timing &timing) {
+        qInfo("%-20s %8llu events %10.3f ms total %10.3f us/event", subsystem, timing.count,
+              timing.nanoseconds / 1000000.0, timing.count ? timing.nanoseconds / 1000.0 / timing.count : 0.0);
+    };
+    print("input", m_input);
+    print("commits", m_commits);
+    print("window management", m_windowManagement);
+    print("compositing", m_compositing);
+}
+
+class ReplayTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testTraceFormat();
+    void testRecord();
+    void testReplay();
+};
+
+void ReplayTest::initTestCase()
+{
+    qRegisterMetaType<KWin::ShellClient*>();
+    QSignalSpy workspaceCreatedSpy(kwinApp(), &Application::workspaceCreated);
+    QVERIFY(workspaceCreatedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName.toLocal8Bit()));
+
+    kwinApp()->start();
+    QVERIFY(workspaceCreatedSpy.wait());
+    waylandServer()->initWorkspace();
+}
+
+void ReplayTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+    KWin::Cursor::setPos(QPoint(640, 512));
+}
+
+void ReplayTest::cleanup()
+{
+    Test::destroyWaylandConnection();
+}
+
+void ReplayTest::testTraceFormat()
+{
+    // writes an event of each type and verifies that they are read back unchanged
+    QVector<ReplayEvent> events;
+    for (quint8 type = 0; type <= quint8(ReplayEvent::Type::Commit); type++) {
+        ReplayEvent event;
+        event.type = ReplayEvent::Type(type);
+        event.time = type * 10;
+        switch (event.type) {
+        case ReplayEvent::Type::PointerMotion:
+            event.position = QPointF(10.5, 20.25);
+            break;
+        case ReplayEvent::Type::PointerAxis:
+            event.code = Qt::Vertical;
+            event.position = QPointF(-15, 0);
+            break;
+        case ReplayEvent::Type::TouchDown:
+        case ReplayEvent::Type::TouchMotion:
+            event.code = 1;
+            event.position = QPointF(100, 200);
+            break;
+        case ReplayEvent::Type::WindowMapped:
+            event.window = 3;
+            event.geometry = QRect(-10, 20, 300, 200);
+            break;
+        case ReplayEvent::Type::WindowUnmapped:
+            event.window = 3;
+            break;
+        case ReplayEvent::Type::Commit:
+            event.window = 3;
+            event.geometry = QRect(0, 0, 300, 200);
+            event.damage = QSize(30, 20);
+            break;
+        default:
+            event.code = BTN_LEFT;
+            break;
+        }
+        events << event;
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    ReplayTraceWriter writer(&buffer);
+    for (const ReplayEvent &event : qAsConst(events)) {
+        writer.write(event);
+    }
+    buffer.seek(0);
+
+    ReplayTraceReader reader(&buffer);
+    QVERIFY(reader.isValid());
+    ReplayEvent read;
+    for (const ReplayEvent &event : qAsConst(events)) {
+        QVERIFY(reader.read(&read));
+        QVERIFY(read == event);
+    }
+    QVERIFY(!reader.read(&read));
+    QVERIFY(reader.isValid());
+
+    QBuffer garbage;
+    garbage.setData(QByteArrayLiteral("not a trace"));
+    QVERIFY(garbage.open(QIODevice::ReadOnly));
+    QVERIFY(!ReplayTraceReader(&garbage).isValid());
+}
+
+void ReplayTest::testRecord()
+{
+    // records a small session and verifies the trace
+    QTemporaryFile trace;
+    QVERIFY(trace.open());
+    QScopedPointer<ReplayRecorder> recorder(new ReplayRecorder(trace.fileName()));
+    QVERIFY(recorder->isRecording());
+
+    quint32 timestamp = 1;
+    kwinApp()->platform()->pointerMotion(QPointF(100, 100), timestamp++);
+
+    QScopedPointer<Surface> surface(Test::createSurface());
+    QScopedPointer<XdgShellSurface> shellSurface(Test::createXdgShellStableSurface(surface.data()));
+    ShellClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+
+    QSignalSpy damagedSpy(client, &Toplevel::damaged);
+    QVERIFY(damagedSpy.isValid());
+    Test::render(surface.data(), QSize(100, 50), Qt::red);
+    QVERIFY(damagedSpy.wait());
+
+    kwinApp()->platform()->pointerButtonPressed(BTN_LEFT, timestamp++);
+    kwinApp()->platform()->pointerButtonReleased(BTN_LEFT, timestamp++);
+    kwinApp()->platform()->keyboardKeyPressed(KEY_A, timestamp++);
+    kwinApp()->platform()->keyboardKeyReleased(KEY_A, timestamp++);
+
+    shellSurface.reset();
+    surface.reset();
+    QVERIFY(Test::waitForWindowDestroyed(client));
+    recorder.reset();
+
+    ReplayTraceReader reader(&trace);
+    QVERIFY(reader.isValid());
+    QVector<ReplayEvent::Type> types;
+    ReplayEvent event;
+    quint32 lastTime = 0;
+    while (reader.read(&event)) {
+        QVERIFY(event.time >= lastTime);
+        lastTime = event.time;
+        if (types.isEmpty() || types.last() != event.type) {
+            types << event.type;
+        }
+        if (event.type == ReplayEvent::Type::WindowMapped) {
+            QCOMPARE(event.window, 1u);
+            QCOMPARE(event.geometry.size(), QSize(100, 50));
+        }
+        if (event.type == ReplayEvent::Type::Commit) {
+            QCOMPARE(event.geometry.size(), QSize(100, 50));
+        }
+    }
+    QVERIFY(reader.isValid());
+    QCOMPARE(types.first(), ReplayEvent::Type::PointerMotion);
+    QVERIFY(types.contains(ReplayEvent::Type::WindowMapped));
+    QVERIFY(types.indexOf(ReplayEvent::Type::Commit) > types.indexOf(ReplayEvent::Type::WindowMapped));
+    QVERIFY(types.contains(ReplayEvent::Type::PointerButtonPressed));
+    QVERIFY(types.contains(ReplayEvent::Type::KeyReleased));
+    QCOMPARE(types.last(), ReplayEvent::Type::WindowUnmapped);
+}
+
+void ReplayTest::testReplay()
+{
+    // replays the trace given by KWIN_REPLAY_TRACE or a generated one
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    QScopedPointer<QFile> file;
+    QIODevice *device = &buffer;
+    const QString fileName = qEnvironmentVariable("KWIN_REPLAY_TRACE");
+    if (!fileName.isEmpty()) {
+        file.reset(new QFile(fileName));
+        QVERIFY(file->open(QIODevice::ReadOnly));
+        device = file.data();
+    } else {
+        ReplayTraceWriter writer(&buffer);
+        ReplayEvent event;
+        event.type = ReplayEvent::Type::WindowMapped;
+        event.window = 1;
+        event.geometry = QRect(100, 100, 400, 300);
+        writer.write(event);
+        for (int i = 0; i < 100; i++) {
+            event = ReplayEvent();
+            event.type = ReplayEvent::Type::PointerMotion;
+            event.time = i;
+            event.position = QPointF(150 + i, 150 + i);
+            writer.write(event);
+            event = ReplayEvent();
+            event.type = ReplayEvent::Type::Commit;
+            event.time = i;
+            event.window = 1;
+            event.geometry = QRect(0, 0, 400, 300);
+            event.damage = QSize(40, 30);
+            writer.write(event);
+        }
+        event = ReplayEvent();
+        event.type = ReplayEvent::Type::WindowUnmapped;
+        event.time = 100;
+        event.window = 1;
+        writer.write(event);
+        buffer.seek(0);
+    }
+
+    ReplayTraceReader reader(device);
+    QVERIFY(reader.isValid());
+    ReplayPlayer player;
+    QVERIFY(player.replay(reader));
+    player.report();
+}
+
+WAYLANDTEST_MAIN(ReplayTest)
+#include "replay_test.moc"
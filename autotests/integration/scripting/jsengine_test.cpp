@@ -0,0 +1,134 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "kwin_wayland_test.h"
+
+#include "platform.h"
+#include "scripting/scripting.h"
+#include "shell_client.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KWayland/Client/surface.h>
+
+namespace KWin
+{
+
+static const QString s_socketName = QStringLiteral("wayland_test_kwin_scripting_jsengine-0");
+
+class JSEngineScriptTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testBatchedChanges();
+};
+
+void JSEngineScriptTest::initTestCase()
+{
+    qRegisterMetaType<AbstractClient *>();
+    qRegisterMetaType<ShellClient *>();
+
+    QSignalSpy workspaceCreatedSpy(kwinApp(), &Application::workspaceCreated);
+    QVERIFY(workspaceCreatedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName.toLocal8Bit()));
+
+    kwinApp()->start();
+    QVERIFY(workspaceCreatedSpy.wait());
+    waylandServer()->initWorkspace();
+    QVERIFY(Scripting::self());
+}
+
+void JSEngineScriptTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+}
+
+void JSEngineScriptTest::cleanup()
+{
+    Test::destroyWaylandConnection();
+
+    const QString script = QFINDTESTDATA("./scripts/batchedchanges.js");
+    if (Scripting::self()->isScriptLoaded(script)) {
+        QVERIFY(Scripting::self()->unloadScript(script));
+        QTRY_VERIFY(!Scripting::self()->isScriptLoaded(script));
+    }
+}
+
+void JSEngineScriptTest::testBatchedChanges()
+{
+    // this test verifies that changes of several windows within one event loop
+    // iteration reach the script as a single batch
+    using namespace KWayland::Client;
+
+    const QString scriptToLoad = QFINDTESTDATA("./scripts/batchedchanges.js");
+    QVERIFY(!scriptToLoad.isEmpty());
+    const int id = Scripting::self()->loadJSEngineScript(scriptToLoad);
+    QVERIFY(id != -1);
+    QVERIFY(Scripting::self()->isScriptLoaded(scriptToLoad));
+    AbstractScript *script = Scripting::self()->findScript(scriptToLoad);
+    QVERIFY(script);
+    QVERIFY(qobject_cast<JSEngineScript*>(script));
+    QSignalSpy runningChangedSpy(script, &AbstractScript::runningChanged);
+    QVERIFY(runningChangedSpy.isValid());
+    QSignalSpy printSpy(script, &AbstractScript::print);
+    QVERIFY(printSpy.isValid());
+    script->run();
+    QCOMPARE(runningChangedSpy.count(), 1);
+
+    QScopedPointer<Surface> surface1(Test::createSurface());
+    QScopedPointer<XdgShellSurface> shellSurface1(Test::createXdgShellStableSurface(surface1.data()));
+    ShellClient *client1 = Test::renderAndWaitForShown(surface1.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client1);
+    QScopedPointer<Surface> surface2(Test::createSurface());
+    QScopedPointer<XdgShellSurface> shellSurface2(Test::createXdgShellStableSurface(surface2.data()));
+    ShellClient *client2 = Test::renderAndWaitForShown(surface2.data(), QSize(100, 50), Qt::red);
+    QVERIFY(client2);
+
+    // flush the batches of mapping the windows
+    QCoreApplication::processEvents();
+    printSpy.clear();
+
+    // moving both windows several times results in one batch listing each window once
+    for (int i = 1; i <= 3; ++i) {
+        client1->move(QPoint(10 * i, 10 * i));
+        client2->move(QPoint(100 + 10 * i, 100 + 10 * i));
+    }
+    QVERIFY(printSpy.wait());
+    QCOMPARE(printSpy.count(), 1);
+    QCOMPARE(printSpy.first().first().toString(), QStringLiteral("geometry:2 removed:0"));
+
+    // closing a window is reported with its id
+    printSpy.clear();
+    shellSurface2.reset();
+    QVERIFY(Test::waitForWindowDestroyed(client2));
+    QTRY_VERIFY(!printSpy.isEmpty());
+    QCOMPARE(printSpy.last().first().toString(), QStringLiteral("geometry:0 removed:1"));
+
+    shellSurface1.reset();
+    QVERIFY(Test::waitForWindowDestroyed(client1));
+}
+
+}
+
+WAYLANDTEST_MAIN(KWin::JSEngineScriptTest)
+#include "jsengine_test.moc"
@@ -0,0 +1,3 @@
+workspace.changesBatched.connect(function(changes) {
+    print("geometry:" + changes.geometryChanged.length + " removed:" + changes.removed.length);
+});
@@ -0,0 +1,185 @@
+/********************************************************************
+KWin - the KDE window manager
+This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "mock_libinput.h"
+#include "../../libinput/device.h"
+#include "../../libinput/events.h"
+#include "../../libinput/eventqueue.h"
+
+#include <QtTest>
+#include <QThread>
+
+#include <memory>
+
+using namespace KWin::LibInput;
+
+class TestLibinputEventQueue : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void testCapacity_data();
+    void testCapacity();
+    void testOrder();
+    void testFull();
+    void testThreaded();
+
+private:
+    libinput_event_keyboard *createKeyEvent(quint32 key) const;
+    bool enqueue(EventQueue &queue, quint32 key) const;
+
+    std::unique_ptr<libinput_device> m_nativeDevice;
+    std::unique_ptr<Device> m_device;
+};
+
+void TestLibinputEventQueue::init()
+{
+    m_nativeDevice = std::make_unique<libinput_device>();
+    m_nativeDevice->keyboard = true;
+    m_device = std::make_unique<Device>(m_nativeDevice.get());
+}
+
+void TestLibinputEventQueue::cleanup()
+{
+    m_device.reset();
+    m_nativeDevice.reset();
+}
+
+libinput_event_keyboard *TestLibinputEventQueue::createKeyEvent(quint32 key) const
+{
+    libinput_event_keyboard *keyEvent = new libinput_event_keyboard;
+    keyEvent->device = m_nativeDevice.get();
+    keyEvent->key = key;
+    keyEvent->time = key;
+    return keyEvent;
+}
+
+bool TestLibinputEventQueue::enqueue(EventQueue &queue, quint32 key) const
+{
+    void *storage = queue.reserve();
+    if (!storage) {
+        return false;
+    }
+    queue.commit(Event::create(createKeyEvent(key), storage));
+    return true;
+}
+
+void TestLibinputEventQueue::testCapacity_data()
+{
+    QTest::addColumn<quint32>("requested");
+    QTest::addColumn<quint32>("expected");
+
+    QTest::newRow("0") << 0u << 2u;
+    QTest::newRow("1") << 1u << 2u;
+    QTest::newRow("2") << 2u << 2u;
+    QTest::newRow("3") << 3u << 4u;
+    QTest::newRow("1000") << 1000u << 1024u;
+    QTest::newRow("1024") << 1024u << 1024u;
+}
+
+void TestLibinputEventQueue::testCapacity()
+{
+    QFETCH(quint32, requested);
+    EventQueue queue(requested);
+    QTEST(queue.capacity(), "expected");
+}
+
+void TestLibinputEventQueue::testOrder()
+{
+    EventQueue queue(4);
+    QVERIFY(queue.isEmpty());
+    QVERIFY(!queue.head());
+
+    // run through the ring several times to cover the wrap around
+    quint32 next = 0;
+    for (quint32 key = 0; key < 20; key++) {
+        QVERIFY(enqueue(queue, key));
+        QVERIFY(!queue.isEmpty());
+        if (key % 3 == 2) {
+            while (Event *event = queue.head()) {
+                QCOMPARE(event->type(), LIBINPUT_EVENT_KEYBOARD_KEY);
+                QCOMPARE(event->device(), m_device.get());
+                KeyEvent *keyEvent = dynamic_cast<KeyEvent*>(event);
+                QVERIFY(keyEvent);
+                QCOMPARE(keyEvent->key(), next++);
+                queue.pop();
+            }
+            QVERIFY(queue.isEmpty());
+        }
+    }
+    // the remaining events are destroyed with the queue
+    QVERIFY(!queue.isEmpty());
+}
+
+void TestLibinputEventQueue::testFull()
+{
+    EventQueue queue(4);
+    for (quint32 key = 0; key < 4; key++) {
+        QVERIFY(enqueue(queue, key));
+    }
+    QVERIFY(!queue.reserve());
+
+    // releasing one slot allows to add one more event
+    queue.pop();
+    QVERIFY(enqueue(queue, 4));
+    QVERIFY(!queue.reserve());
+
+    for (quint32 key = 1; key < 5; key++) {
+        QCOMPARE(static_cast<KeyEvent*>(queue.head())->key(), key);
+        queue.pop();
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void TestLibinputEventQueue::testThreaded()
+{
+    // a producer thread fills a small queue as fast as possible, all events
+    // have to arrive in order
+    const quint32 count = 100000;
+    EventQueue queue(16);
+    std::unique_ptr<QThread> producer(QThread::create(
+        [this, &queue, count] {
+            for (quint32 key = 0; key < count; key++) {
+                while (!enqueue(queue, key)) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }
+    ));
+    producer->start();
+
+    quint32 next = 0;
+    bool inOrder = true;
+    while (next < count) {
+        Event *event = queue.head();
+        if (!event) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        inOrder = inOrder && static_cast<KeyEvent*>(event)->key() == next;
+        next++;
+        queue.pop();
+    }
+    QVERIFY(producer->wait());
+    QVERIFY(inOrder);
+    QVERIFY(queue.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestLibinputEventQueue)
+#include "eventqueue_test.moc"
@@ -0,0 +1,237 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+
+#include "../../effects/wobblywindows/wobblymesh.h"
+
+#include <QtTest>
+
+using namespace KWin;
+
+class WobblyMeshTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testRestingMesh_data();
+    void testRestingMesh();
+    void testKernelsAgree();
+    void testBezierRegularGrid_data();
+    void testBezierRegularGrid();
+    void benchmarkIntegrate_data();
+    void benchmarkIntegrate();
+    void benchmarkBezier_data();
+    void benchmarkBezier();
+};
+
+static const WobblyParameters s_parameters = {
+    0.15f, // stiffness
+    0.80f, // drag
+    0.10f, // move factor
+    0.0f, // min velocity
+    1000.0f, // max velocity
+    0.0f, // min acceleration
+    1000.0f // max acceleration
+};
+
+static const float s_xLength = 200.0f;
+static const float s_yLength = 150.0f;
+
+static WobblyMesh restingMesh()
+{
+    WobblyMesh mesh;
+    for (int j = 0; j < WobblyMesh::Height; ++j) {
+        for (int i = 0; i < WobblyMesh::Width; ++i) {
+            const int index = j * WobblyMesh::Width + i;
+            mesh.origin.x[index] = 100.0f + i * s_xLength;
+            mesh.origin.y[index] = 50.0f + j * s_yLength;
+            mesh.position.x[index] = mesh.origin.x[index];
+            mesh.position.y[index] = mesh.origin.y[index];
+            mesh.velocity.x[index] = 0.0f;
+            mesh.velocity.y[index] = 0.0f;
+            mesh.constraint[index] = false;
+        }
+    }
+    return mesh;
+}
+
+// A mesh that has just been dragged to the right by one of its inner points.
+static WobblyMesh draggedMesh()
+{
+    WobblyMesh mesh = restingMesh();
+    for (int i = 0; i < WobblyMesh::Count; ++i) {
+        mesh.origin.x[i] += 80.0f;
+        mesh.origin.y[i] += 20.0f;
+    }
+    mesh.constraint[5] = true;
+    mesh.position.x[5] = mesh.origin.x[5];
+    mesh.position.y[5] = mesh.origin.y[5];
+    return mesh;
+}
+
+static void integrate(bool simd, WobblyMesh &mesh, float *accelerationSum, float *velocitySum)
+{
+    if (simd) {
+        WobblyKernels::integrate(mesh, s_parameters, s_xLength, s_yLength, 10.0f, accelerationSum, velocitySum);
+    } else {
+        WobblyKernels::integrateScalar(mesh, s_parameters, s_xLength, s_yLength, 10.0f, accelerationSum, velocitySum);
+    }
+}
+
+static void evaluateBezier(bool simd, const WobblyMesh::Points &points, float tx, float ty, float *x, float *y)
+{
+    if (simd) {
+        WobblyKernels::evaluateBezier(points, tx, ty, x, y);
+    } else {
+        WobblyKernels::evaluateBezierScalar(points, tx, ty, x, y);
+    }
+}
+
+static void addKernelRows()
+{
+    QTest::addColumn<bool>("simd");
+
+    QTest::newRow("default") << true;
+    QTest::newRow("scalar") << false;
+}
+
+void WobblyMeshTest::testRestingMesh_data()
+{
+    addKernelRows();
+}
+
+void WobblyMeshTest::testRestingMesh()
+{
+    // a mesh whose springs have their rest length must not move
+    QFETCH(bool, simd);
+
+    WobblyMesh mesh = restingMesh();
+    float accelerationSum = -1.0f;
+    float velocitySum = -1.0f;
+    integrate(simd, mesh, &accelerationSum, &velocitySum);
+
+    QCOMPARE(accelerationSum, 0.0f);
+    QCOMPARE(velocitySum, 0.0f);
+    for (int i = 0; i < WobblyMesh::Count; ++i) {
+        QCOMPARE(mesh.position.x[i], mesh.origin.x[i]);
+        QCOMPARE(mesh.position.y[i], mesh.origin.y[i]);
+    }
+}
+
+void WobblyMeshTest::testKernelsAgree()
+{
+    WobblyMesh vectorized = draggedMesh();
+    WobblyMesh scalar = draggedMesh();
+
+    for (int step = 0; step < 100; ++step) {
+        float vectorizedAcceleration, vectorizedVelocity;
+        float scalarAcceleration, scalarVelocity;
+        integrate(true, vectorized, &vectorizedAcceleration, &vectorizedVelocity);
+        integrate(false, scalar, &scalarAcceleration, &scalarVelocity);
+
+        QVERIFY(qAbs(vectorizedAcceleration - scalarAcceleration) < 1e-2f);
+        QVERIFY(qAbs(vectorizedVelocity - scalarVelocity) < 1e-2f);
+        for (int i = 0; i < WobblyMesh::Count; ++i) {
+            QVERIFY(qAbs(vectorized.position.x[i] - scalar.position.x[i]) < 1e-2f);
+            QVERIFY(qAbs(vectorized.position.y[i] - scalar.position.y[i]) < 1e-2f);
+        }
+    }
+
+    // the window stopped moving, so the mesh must have settled
+    float accelerationSum, velocitySum;
+    integrate(true, vectorized, &accelerationSum, &velocitySum);
+    QVERIFY(accelerationSum < 0.5f);
+    QVERIFY(velocitySum < 0.5f);
+}
+
+void WobblyMeshTest::testBezierRegularGrid_data()
+{
+    addKernelRows();
+}
+
+void WobblyMeshTest::testBezierRegularGrid()
+{
+    // evenly spaced control points span a plane, so the surface is the identity
+    QFETCH(bool, simd);
+
+    const WobblyMesh mesh = restingMesh();
+    for (int j = 0; j <= 10; ++j) {
+        for (int i = 0; i <= 10; ++i) {
+            const float tx = i / 10.0f;
+            const float ty = j / 10.0f;
+            float x, y;
+            evaluateBezier(simd, mesh.position, tx, ty, &x, &y);
+            QVERIFY(qAbs(x - (100.0f + tx * 3 * s_xLength)) < 1e-3f);
+            QVERIFY(qAbs(y - (50.0f + ty * 3 * s_yLength)) < 1e-3f);
+        }
+    }
+}
+
+void WobblyMeshTest::benchmarkIntegrate_data()
+{
+    addKernelRows();
+}
+
+void WobblyMeshTest::benchmarkIntegrate()
+{
+    QFETCH(bool, simd);
+
+    const WobblyMesh initial = draggedMesh();
+    WobblyMesh mesh = initial;
+    float accelerationSum, velocitySum;
+    QBENCHMARK {
+        // one second of wobbling at 100 Hz
+        mesh = initial;
+        for (int step = 0; step < 100; ++step) {
+            integrate(simd, mesh, &accelerationSum, &velocitySum);
+        }
+    }
+}
+
+void WobblyMeshTest::benchmarkBezier_data()
+{
+    addKernelRows();
+}
+
+void WobblyMeshTest::benchmarkBezier()
+{
+    QFETCH(bool, simd);
+
+    WobblyMesh mesh = draggedMesh();
+    float accelerationSum, velocitySum;
+    integrate(true, mesh, &accelerationSum, &velocitySum);
+
+    // the default tesselation of 20x20 quads has 21x21 distinct vertices
+    float x = 0.0f;
+    float y = 0.0f;
+    QBENCHMARK {
+        for (int j = 0; j <= 20; ++j) {
+            for (int i = 0; i <= 20; ++i) {
+                float vx, vy;
+                evaluateBezier(simd, mesh.position, i / 20.0f, j / 20.0f, &vx, &vy);
+                x += vx;
+                y += vy;
+            }
+        }
+    }
+    QVERIFY(x > 0.0f);
+    QVERIFY(y > 0.0f);
+}
+
+QTEST_MAIN(WobblyMeshTest)
+
+#include "wobblymeshtest.moc"
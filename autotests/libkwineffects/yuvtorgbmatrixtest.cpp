@@ -0,0 +1,96 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include <kwinglutils.h>
+
+#include <QMatrix4x4>
+#include <QVector3D>
+#include <QVector4D>
+#include <QtTest>
+
+using namespace KWin;
+
+Q_DECLARE_METATYPE(KWin::YuvCoefficients)
+Q_DECLARE_METATYPE(KWin::YuvRange)
+
+class YuvToRgbMatrixTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testConvert_data();
+    void testConvert();
+};
+
+void YuvToRgbMatrixTest::testConvert_data()
+{
+    QTest::addColumn<KWin::YuvCoefficients>("coefficients");
+    QTest::addColumn<KWin::YuvRange>("range");
+    // 8 bit Y, Cb, Cr
+    QTest::addColumn<QVector3D>("yuv");
+    // 8 bit R, G, B
+    QTest::addColumn<QVector3D>("rgb");
+
+    const auto bt601 = YuvCoefficients::BT601;
+    const auto bt709 = YuvCoefficients::BT709;
+    const auto limited = YuvRange::Limited;
+    const auto full = YuvRange::Full;
+
+    QTest::newRow("BT.601 limited black") << bt601 << limited << QVector3D(16, 128, 128) << QVector3D(0, 0, 0);
+    QTest::newRow("BT.601 limited white") << bt601 << limited << QVector3D(235, 128, 128) << QVector3D(255, 255, 255);
+    QTest::newRow("BT.601 limited red") << bt601 << limited << QVector3D(81, 90, 240) << QVector3D(255, 0, 0);
+    QTest::newRow("BT.601 limited green") << bt601 << limited << QVector3D(145, 54, 34) << QVector3D(0, 255, 0);
+    QTest::newRow("BT.601 limited blue") << bt601 << limited << QVector3D(41, 240, 110) << QVector3D(0, 0, 255);
+
+    QTest::newRow("BT.709 limited black") << bt709 << limited << QVector3D(16, 128, 128) << QVector3D(0, 0, 0);
+    QTest::newRow("BT.709 limited white") << bt709 << limited << QVector3D(235, 128, 128) << QVector3D(255, 255, 255);
+    QTest::newRow("BT.709 limited red") << bt709 << limited << QVector3D(63, 102, 240) << QVector3D(255, 0, 0);
+    QTest::newRow("BT.709 limited green") << bt709 << limited << QVector3D(173, 42, 26) << QVector3D(0, 255, 0);
+    QTest::newRow("BT.709 limited blue") << bt709 << limited << QVector3D(32, 240, 118) << QVector3D(0, 0, 255);
+
+    QTest::newRow("BT.601 full black") << bt601 << full << QVector3D(0, 128, 128) << QVector3D(0, 0, 0);
+    QTest::newRow("BT.601 full white") << bt601 << full << QVector3D(255, 128, 128) << QVector3D(255, 255, 255);
+    QTest::newRow("BT.601 full red") << bt601 << full << QVector3D(76, 85, 255) << QVector3D(255, 0, 0);
+    QTest::newRow("BT.601 full green") << bt601 << full << QVector3D(150, 44, 21) << QVector3D(0, 255, 0);
+    QTest::newRow("BT.601 full blue") << bt601 << full << QVector3D(29, 255, 107) << QVector3D(0, 0, 255);
+
+    QTest::newRow("BT.709 full black") << bt709 << full << QVector3D(0, 128, 128) << QVector3D(0, 0, 0);
+    QTest::newRow("BT.709 full white") << bt709 << full << QVector3D(255, 128, 128) << QVector3D(255, 255, 255);
+    QTest::newRow("BT.709 full red") << bt709 << full << QVector3D(54, 99, 255) << QVector3D(255, 0, 0);
+    QTest::newRow("BT.709 full green") << bt709 << full << QVector3D(182, 30, 12) << QVector3D(0, 255, 0);
+    QTest::newRow("BT.709 full blue") << bt709 << full << QVector3D(18, 255, 116) << QVector3D(0, 0, 255);
+}
+
+void YuvToRgbMatrixTest::testConvert()
+{
+    QFETCH(KWin::YuvCoefficients, coefficients);
+    QFETCH(KWin::YuvRange, range);
+    QFETCH(QVector3D, yuv);
+    QFETCH(QVector3D, rgb);
+
+    // the shader samples normalized values
+    const QMatrix4x4 matrix = yuvToRgbMatrix(coefficients, range);
+    const QVector4D result = matrix * QVector4D(yuv / 255.0f, 1.0f) * 255.0f;
+
+    // the 8 bit samples are rounded, so allow for an error of less than two steps
+    const float tolerance = 1.5f;
+    QVERIFY2(qAbs(result.x() - rgb.x()) < tolerance, qPrintable(QString::number(result.x())));
+    QVERIFY2(qAbs(result.y() - rgb.y()) < tolerance, qPrintable(QString::number(result.y())));
+    QVERIFY2(qAbs(result.z() - rgb.z()) < tolerance, qPrintable(QString::number(result.z())));
+}
+
+QTEST_GUILESS_MAIN(YuvToRgbMatrixTest)
+#include "yuvtorgbmatrixtest.moc"
@@ -197,6 +197,11 @@ public:
     QPainter *scenePainter() override {
         return nullptr;
     }
+    void reserveScreenCapture(KWin::Effect *) override {}
+    void unreserveScreenCapture(KWin::Effect *) override {}
+    KWin::GLTexture *screenCaptureTexture() const override {
+        return nullptr;
+    }
     int screenNumber(const QPoint &) const override {
         return 0;
     }
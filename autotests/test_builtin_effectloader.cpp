@@ -67,6 +67,7 @@ private Q_SLOTS:
     void testLoadBuiltInEffect_data();
     void testLoadBuiltInEffect();
     void testLoadAllEffects();
+    void testLoadDeferredEffects();
 };
 
 void TestBuiltInEffectLoader::initTestCase()
@@ -562,6 +563,50 @@ void TestBuiltInEffectLoader::testLoadAllEffects()
     QCOMPARE(loadedEffects.at(1), QStringLiteral("mouseclick"));
 }
 
+void TestBuiltInEffectLoader::testLoadDeferredEffects()
+{
+    QScopedPointer<MockEffectsHandler, QScopedPointerDeleteLater>mockHandler(new MockEffectsHandler(KWin::XRenderCompositing));
+    KWin::BuiltInEffectLoader loader;
+
+    KSharedConfig::Ptr config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+
+    // only enable mouseclick and the deferred mousemark
+    KConfigGroup plugins = config->group("Plugins");
+    const auto effects = KWin::BuiltInEffects::availableEffects();
+    for (auto effect : effects) {
+        plugins.writeEntry(KWin::BuiltInEffects::nameForEffect(effect) + QStringLiteral("Enabled"), false);
+    }
+    plugins.writeEntry(QStringLiteral("mouseclickEnabled"), true);
+    plugins.writeEntry(QStringLiteral("mousemarkEnabled"), true);
+    plugins.sync();
+
+    loader.setConfig(config);
+
+    qRegisterMetaType<KWin::Effect*>();
+    QSignalSpy spy(&loader, &KWin::BuiltInEffectLoader::effectLoaded);
+    connect(&loader, &KWin::BuiltInEffectLoader::effectLoaded,
+        [](KWin::Effect *effect) {
+            effect->deleteLater();
+        }
+    );
+
+    loader.setDeferredEffectsHeld(true);
+    loader.queryAndLoadAll();
+
+    // only the regular effect gets loaded
+    QVERIFY(spy.wait(10));
+    QVERIFY(!spy.wait(10));
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(spy.takeFirst().at(1).toString(), QStringLiteral("mouseclick"));
+
+    // releasing the deferred effects loads the held back one
+    loader.setDeferredEffectsHeld(false);
+    QVERIFY(spy.wait(10));
+    QVERIFY(!spy.wait(10));
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(spy.takeFirst().at(1).toString(), QStringLiteral("mousemark"));
+}
+
 Q_CONSTRUCTOR_FUNCTION(forceXcb)
 QTEST_MAIN(TestBuiltInEffectLoader)
 #include "test_builtin_effectloader.moc"
@@ -0,0 +1,96 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "../kcmkwin/kwincompositing/compositing.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <QtTest>
+
+using KWin::Compositing::Compositing;
+
+class TestCompositingKcm : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testReadGlSwapStrategy_data();
+    void testReadGlSwapStrategy();
+    void testWriteGlSwapStrategy_data();
+    void testWriteGlSwapStrategy();
+};
+
+void TestCompositingKcm::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestCompositingKcm::init()
+{
+    KSharedConfig::openConfig(QStringLiteral("kwinrc"))->deleteGroup("Compositing");
+}
+
+static void glSwapStrategyData()
+{
+    QTest::addColumn<QString>("value");
+    QTest::addColumn<int>("index");
+
+    // the order of the entries in the combo box
+    QTest::newRow("never") << QStringLiteral("n") << 0;
+    QTest::newRow("automatic") << QStringLiteral("a") << 1;
+    QTest::newRow("extend damage") << QStringLiteral("e") << 2;
+    QTest::newRow("full repaints") << QStringLiteral("p") << 3;
+    QTest::newRow("copy front buffer") << QStringLiteral("c") << 4;
+    QTest::newRow("off-screen buffer") << QStringLiteral("b") << 5;
+}
+
+void TestCompositingKcm::testReadGlSwapStrategy_data()
+{
+    glSwapStrategyData();
+}
+
+void TestCompositingKcm::testReadGlSwapStrategy()
+{
+    QFETCH(QString, value);
+    KConfigGroup group(KSharedConfig::openConfig(QStringLiteral("kwinrc")), "Compositing");
+    group.writeEntry("GLPreferBufferSwap", value);
+
+    Compositing compositing;
+    QTEST(compositing.glSwapStrategy(), "index");
+}
+
+void TestCompositingKcm::testWriteGlSwapStrategy_data()
+{
+    glSwapStrategyData();
+}
+
+void TestCompositingKcm::testWriteGlSwapStrategy()
+{
+    Compositing compositing;
+    QFETCH(int, index);
+    compositing.setGlSwapStrategy(index);
+    compositing.save();
+
+    KConfigGroup group(KSharedConfig::openConfig(QStringLiteral("kwinrc")), "Compositing");
+    QTEST(group.readEntry("GLPreferBufferSwap", QString()), "value");
+}
+
+QTEST_GUILESS_MAIN(TestCompositingKcm)
+#include "test_compositing_kcm.moc"
@@ -0,0 +1,211 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "../plugins/scenes/opengl/effectframetexturecache.h"
+
+#include <kwingltexture.h>
+
+#include <QPixmap>
+#include <QtTest>
+
+using namespace KWin;
+
+// doesn't touch OpenGL, a null GLTexture doesn't own any GL resources
+class MockTextureCache : public EffectFrameTextureCache
+{
+public:
+    MockTextureCache(int textCost, int pixmapCost)
+        : EffectFrameTextureCache(textCost, pixmapCost)
+    {
+    }
+    ~MockTextureCache() override {
+        clear();
+    }
+
+    int created = 0;
+
+protected:
+    QSharedPointer<GLTexture> createTexture(const QImage &image) override {
+        Q_UNUSED(image)
+        created++;
+        return QSharedPointer<GLTexture>::create();
+    }
+};
+
+class TestEffectFrameTextureCache : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testTextHit();
+    void testTextMiss_data();
+    void testTextMiss();
+    void testRenderTextSize();
+    void testPixmapHit();
+    void testEviction();
+    void testClear();
+    void testAlignedRect_data();
+    void testAlignedRect();
+};
+
+static EffectFrameTextureCache::Text caption(const QString &text)
+{
+    EffectFrameTextureCache::Text key;
+    key.text = text;
+    key.font = QFont(QStringLiteral("Sans"), 10);
+    key.color = QColor(Qt::white).rgba();
+    key.alignment = Qt::AlignCenter;
+    return key;
+}
+
+void TestEffectFrameTextureCache::testTextHit()
+{
+    // the same caption shown in frames of different sizes and vertical alignments shares the texture
+    MockTextureCache cache(1024, 1024);
+    EffectFrameTextureCache::Text key = caption(QStringLiteral("Konsole"));
+    const auto texture = cache.textTexture(key);
+    QVERIFY(texture);
+    QCOMPARE(cache.created, 1);
+
+    key.alignment = Qt::AlignHCenter | Qt::AlignTop;
+    QCOMPARE(cache.textTexture(key), texture);
+    QCOMPARE(cache.textTexture(caption(QStringLiteral("Konsole"))), texture);
+    QCOMPARE(cache.created, 1);
+}
+
+void TestEffectFrameTextureCache::testTextMiss_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QFont>("font");
+    QTest::addColumn<QRgb>("color");
+    QTest::addColumn<Qt::Alignment>("alignment");
+
+    const EffectFrameTextureCache::Text key = caption(QStringLiteral("Konsole"));
+    QTest::newRow("text") << QStringLiteral("Dolphin") << key.font << key.color << key.alignment;
+    QTest::newRow("font") << key.text << QFont(QStringLiteral("Sans"), 12) << key.color << key.alignment;
+    QTest::newRow("color") << key.text << key.font << QColor(Qt::black).rgba() << key.alignment;
+    QTest::newRow("alignment") << key.text << key.font << key.color << Qt::Alignment(Qt::AlignRight);
+}
+
+void TestEffectFrameTextureCache::testTextMiss()
+{
+    MockTextureCache cache(1024, 1024);
+    const auto texture = cache.textTexture(caption(QStringLiteral("Konsole")));
+    QCOMPARE(cache.created, 1);
+
+    EffectFrameTextureCache::Text key;
+    QFETCH(QString, text);
+    key.text = text;
+    QFETCH(QFont, font);
+    key.font = font;
+    QFETCH(QRgb, color);
+    key.color = color;
+    QFETCH(Qt::Alignment, alignment);
+    key.alignment = alignment;
+    QVERIFY(cache.textTexture(key) != texture);
+    QCOMPARE(cache.created, 2);
+}
+
+void TestEffectFrameTextureCache::testRenderTextSize()
+{
+    // the text is rasterized at its bounding size instead of the size of the frame
+    const EffectFrameTextureCache::Text key = caption(QStringLiteral("Konsole"));
+    const QImage image = EffectFrameTextureCache::renderText(key);
+    QCOMPARE(image.size(), QFontMetrics(key.font).boundingRect(QRect(), Qt::AlignHCenter, key.text).size());
+
+    const QImage twoLines = EffectFrameTextureCache::renderText(caption(QStringLiteral("Konsole\nKonsole")));
+    QCOMPARE(twoLines.width(), image.width());
+    QVERIFY(twoLines.height() > image.height());
+}
+
+void TestEffectFrameTextureCache::testPixmapHit()
+{
+    MockTextureCache cache(1024, 1024);
+    QPixmap pixmap(16, 16);
+    pixmap.fill(Qt::red);
+    const auto texture = cache.pixmapTexture(pixmap);
+    QCOMPARE(cache.created, 1);
+
+    // copies share the cache key
+    const QPixmap copy = pixmap;
+    QCOMPARE(cache.pixmapTexture(copy), texture);
+    QCOMPARE(cache.created, 1);
+
+    QPixmap other(16, 16);
+    other.fill(Qt::red);
+    QVERIFY(cache.pixmapTexture(other) != texture);
+    QCOMPARE(cache.created, 2);
+}
+
+void TestEffectFrameTextureCache::testEviction()
+{
+    // 16x16 pixmaps cost 1 KiB each, so the cache holds two of them
+    MockTextureCache cache(1024, 2);
+    QPixmap a(16, 16), b(16, 16), c(16, 16);
+    a.fill(Qt::red);
+    b.fill(Qt::green);
+    c.fill(Qt::blue);
+
+    const auto textureA = cache.pixmapTexture(a);
+    const auto textureB = cache.pixmapTexture(b);
+    QCOMPARE(cache.created, 2);
+    // makes b the least recently used one
+    QCOMPARE(cache.pixmapTexture(a), textureA);
+    cache.pixmapTexture(c);
+    QCOMPARE(cache.created, 3);
+
+    QCOMPARE(cache.pixmapTexture(a), textureA);
+    QCOMPARE(cache.created, 3);
+    // the evicted texture stays alive while still in use, but is not shared any more
+    QVERIFY(!textureB.isNull());
+    QVERIFY(cache.pixmapTexture(b) != textureB);
+    QCOMPARE(cache.created, 4);
+}
+
+void TestEffectFrameTextureCache::testClear()
+{
+    MockTextureCache cache(1024, 1024);
+    QPixmap pixmap(16, 16);
+    pixmap.fill(Qt::red);
+    const auto pixmapTexture = cache.pixmapTexture(pixmap);
+    const auto textTexture = cache.textTexture(caption(QStringLiteral("Konsole")));
+    QCOMPARE(cache.created, 2);
+
+    cache.clear();
+    QVERIFY(cache.pixmapTexture(pixmap) != pixmapTexture);
+    QVERIFY(cache.textTexture(caption(QStringLiteral("Konsole"))) != textTexture);
+    QCOMPARE(cache.created, 4);
+}
+
+void TestEffectFrameTextureCache::testAlignedRect_data()
+{
+    QTest::addColumn<Qt::Alignment>("alignment");
+    QTest::addColumn<QRect>("expected");
+
+    QTest::newRow("top left") << Qt::Alignment(Qt::AlignLeft | Qt::AlignTop) << QRect(10, 20, 40, 10);
+    QTest::newRow("center") << Qt::Alignment(Qt::AlignCenter) << QRect(40, 45, 40, 10);
+    QTest::newRow("bottom right") << Qt::Alignment(Qt::AlignRight | Qt::AlignBottom) << QRect(70, 70, 40, 10);
+    QTest::newRow("left vcenter") << Qt::Alignment(Qt::AlignLeft | Qt::AlignVCenter) << QRect(10, 45, 40, 10);
+}
+
+void TestEffectFrameTextureCache::testAlignedRect()
+{
+    QFETCH(Qt::Alignment, alignment);
+    QTEST(EffectFrameTextureCache::alignedRect(alignment, QSize(40, 10), QRect(10, 20, 100, 60)), "expected");
+}
+
+QTEST_MAIN(TestEffectFrameTextureCache)
+#include "test_effectframe_texture_cache.moc"
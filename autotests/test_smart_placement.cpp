@@ -0,0 +1,323 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "../smartplacement.h"
+
+#include <QRandomGenerator>
+#include <QtTest>
+
+using namespace KWin;
+
+struct TestWindow {
+    QRect geometry;
+    int weight;
+};
+
+Q_DECLARE_METATYPE(QVector<TestWindow>)
+
+/**
+ * The smart placement as it used to be implemented in Placement::placeSmart(), walking
+ * all windows for every candidate position. Serves as reference for the results and the speed.
+ */
+static QPoint referencePlacement(const QSize &size, const QRect &area, const QVector<TestWindow> &windows, qint64 *overlapResult)
+{
+    const int none = 0, h_wrong = -1, w_wrong = -2; // overlap types
+    long int overlap, min_overlap = 0;
+    int x_optimal, y_optimal;
+    int possible;
+
+    int cxl, cxr, cyt, cyb;     //temp coords
+    int  xl, xr, yt, yb;     //temp coords
+    int basket;                 //temp holder
+
+    int x = area.left();
+    int y = area.top();
+    x_optimal = x; y_optimal = y;
+
+    int ch = size.height() - 1;
+    int cw = size.width()  - 1;
+
+    bool first_pass = true;
+
+    do {
+        if (y + ch > area.bottom() && ch < area.height()) {
+            overlap = h_wrong;
+        } else if (x + cw > area.right()) {
+            overlap = w_wrong;
+        } else {
+            overlap = none;
+
+            cxl = x; cxr = x + cw;
+            cyt = y; cyb = y + ch;
+            for (const TestWindow &window : windows) {
+                xl = window.geometry.x();          yt = window.geometry.y();
+                xr = xl + window.geometry.width(); yb = yt + window.geometry.height();
+
+                if ((cxl < xr) && (cxr > xl) &&
+                        (cyt < yb) && (cyb > yt)) {
+                    xl = qMax(cxl, xl); xr = qMin(cxr, xr);
+                    yt = qMax(cyt, yt); yb = qMin(cyb, yb);
+                    overlap += window.weight * (xr - xl) * (yb - yt);
+                }
+            }
+        }
+
+        if (overlap == none) {
+            x_optimal = x;
+            y_optimal = y;
+            min_overlap = none;
+            break;
+        }
+
+        if (first_pass) {
+            first_pass = false;
+            min_overlap = overlap;
+        } else if (overlap >= none && overlap < min_overlap) {
+            min_overlap = overlap;
+            x_optimal = x;
+            y_optimal = y;
+        }
+
+        if (overlap > none) {
+            possible = area.right();
+            if (possible - cw > x) possible -= cw;
+
+            for (const TestWindow &window : windows) {
+                xl = window.geometry.x();          yt = window.geometry.y();
+                xr = xl + window.geometry.width(); yb = yt + window.geometry.height();
+
+                if ((y < yb) && (yt < ch + y)) {
+                    if ((xr > x) && (possible > xr)) possible = xr;
+
+                    basket = xl - cw;
+                    if ((basket > x) && (possible > basket)) possible = basket;
+                }
+            }
+            x = possible;
+        } else if (overlap == w_wrong) {
+            x = area.left();
+            possible = area.bottom();
+
+            if (possible - ch > y) possible -= ch;
+
+            for (const TestWindow &window : windows) {
+                xl = window.geometry.x();          yt = window.geometry.y();
+                xr = xl + window.geometry.width(); yb = yt + window.geometry.height();
+
+                if ((yb > y) && (possible > yb)) possible = yb;
+
+                basket = yt - ch;
+                if ((basket > y) && (possible > basket)) possible = basket;
+            }
+            y = possible;
+        }
+    } while ((overlap != none) && (overlap != h_wrong) && (y < area.bottom()));
+
+    if (ch >= area.height()) {
+        y_optimal = area.top();
+    }
+    if (overlapResult) {
+        *overlapResult = min_overlap;
+    }
+    return QPoint(x_optimal, y_optimal);
+}
+
+static qint64 overlapAt(const QPoint &position, const QSize &size, const QVector<TestWindow> &windows)
+{
+    // the placement treats the window as one pixel smaller, like the reference does
+    const QRect rect(position, size - QSize(1, 1));
+    qint64 overlap = 0;
+    for (const TestWindow &window : windows) {
+        const QRect intersected = rect & window.geometry;
+        if (!intersected.isEmpty()) {
+            overlap += window.weight * qint64(intersected.width()) * intersected.height();
+        }
+    }
+    return overlap;
+}
+
+static QVector<TestWindow> randomWindows(QRandomGenerator &generator, const QRect &area, int count)
+{
+    QVector<TestWindow> windows;
+    windows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int width = generator.bounded(50, area.width() / 2);
+        const int height = generator.bounded(50, area.height() / 2);
+        const int x = area.x() + generator.bounded(area.width() - width / 2);
+        const int y = area.y() + generator.bounded(area.height() - height / 2);
+        int weight = SmartPlacement::NormalWeight;
+        switch (generator.bounded(10)) {
+        case 0:
+            weight = SmartPlacement::KeepAboveWeight;
+            break;
+        case 1:
+            weight = SmartPlacement::IgnoreWeight;
+            break;
+        default:
+            break;
+        }
+        windows << TestWindow{QRect(x, y, width, height), weight};
+    }
+    return windows;
+}
+
+static SmartPlacement createPlacement(const QRect &area, const QVector<TestWindow> &windows)
+{
+    SmartPlacement placement(area);
+    for (const TestWindow &window : windows) {
+        placement.addWindow(window.geometry, window.weight);
+    }
+    return placement;
+}
+
+class TestSmartPlacement : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEmpty();
+    void testTooLarge_data();
+    void testTooLarge();
+    void testFixedLayout_data();
+    void testFixedLayout();
+    void testRandom_data();
+    void testRandom();
+    void benchmark_data();
+    void benchmark();
+};
+
+void TestSmartPlacement::testEmpty()
+{
+    const QRect area(100, 50, 1280, 1024);
+    SmartPlacement placement(area);
+    QCOMPARE(placement.place(QSize(500, 400)), area.topLeft());
+}
+
+void TestSmartPlacement::testTooLarge_data()
+{
+    QTest::addColumn<QSize>("size");
+
+    QTest::newRow("wide") << QSize(1400, 400);
+    QTest::newRow("tall") << QSize(400, 1100);
+    QTest::newRow("both") << QSize(1400, 1100);
+}
+
+void TestSmartPlacement::testTooLarge()
+{
+    const QRect area(0, 0, 1280, 1024);
+    const QVector<TestWindow> windows = {
+        {QRect(0, 0, 600, 500), SmartPlacement::NormalWeight},
+        {QRect(700, 600, 500, 400), SmartPlacement::NormalWeight}
+    };
+    QFETCH(QSize, size);
+    QCOMPARE(createPlacement(area, windows).place(size), referencePlacement(size, area, windows, nullptr));
+}
+
+void TestSmartPlacement::testFixedLayout_data()
+{
+    QTest::addColumn<QVector<TestWindow>>("windows");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<QPoint>("expected");
+
+    const QRect left(0, 0, 640, 1024);
+    const QRect topRight(640, 0, 640, 512);
+    QTest::newRow("right of") << QVector<TestWindow>{{left, SmartPlacement::NormalWeight}} << QSize(400, 300) << QPoint(640, 0);
+    QTest::newRow("below") << QVector<TestWindow>{{left, SmartPlacement::NormalWeight}, {topRight, SmartPlacement::NormalWeight}}
+                           << QSize(400, 300) << QPoint(640, 512);
+    QTest::newRow("keep below ignored") << QVector<TestWindow>{{left, SmartPlacement::IgnoreWeight}} << QSize(700, 300) << QPoint(0, 0);
+    // no free spot, prefer to cover the normal window instead of the keep above one
+    QTest::newRow("keep above") << QVector<TestWindow>{{QRect(0, 0, 1280, 512), SmartPlacement::KeepAboveWeight},
+                                                       {QRect(0, 512, 1280, 512), SmartPlacement::NormalWeight}}
+                                << QSize(400, 300) << QPoint(0, 512);
+}
+
+void TestSmartPlacement::testFixedLayout()
+{
+    QFETCH(QVector<TestWindow>, windows);
+    QFETCH(QSize, size);
+    const QRect area(0, 0, 1280, 1024);
+    QTEST(createPlacement(area, windows).place(size), "expected");
+}
+
+void TestSmartPlacement::testRandom_data()
+{
+    QTest::addColumn<QRect>("area");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("few") << QRect(0, 0, 1920, 1080) << 3;
+    QTest::newRow("some") << QRect(0, 0, 1920, 1080) << 10;
+    QTest::newRow("many") << QRect(0, 0, 3840, 2160) << 50;
+    QTest::newRow("offset") << QRect(1920, 100, 2560, 1340) << 20;
+}
+
+void TestSmartPlacement::testRandom()
+{
+    QFETCH(QRect, area);
+    QFETCH(int, count);
+
+    QRandomGenerator generator(count);
+    for (int i = 0; i < 200; ++i) {
+        const QVector<TestWindow> windows = randomWindows(generator, area, count);
+        const QSize size(generator.bounded(100, area.width()), generator.bounded(100, area.height()));
+
+        qint64 referenceOverlap = 0;
+        const QPoint expected = referencePlacement(size, area, windows, &referenceOverlap);
+        const QPoint position = createPlacement(area, windows).place(size);
+        if (referenceOverlap == 0) {
+            // without overlap both take the first free position
+            QCOMPARE(position, expected);
+        } else {
+            // otherwise more candidates get tested, the result can only get better
+            QVERIFY(overlapAt(position, size, windows) <= overlapAt(expected, size, windows));
+        }
+    }
+}
+
+void TestSmartPlacement::benchmark_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("reference");
+
+    for (int count : {10, 50, 200}) {
+        QTest::addRow("reference/%d", count) << count << true;
+        QTest::addRow("summed-area/%d", count) << count << false;
+    }
+}
+
+void TestSmartPlacement::benchmark()
+{
+    QFETCH(int, count);
+    QFETCH(bool, reference);
+
+    // an 8K screen packed with windows, so most positions overlap
+    const QRect area(0, 0, 7680, 4320);
+    QRandomGenerator generator(count);
+    const QVector<TestWindow> windows = randomWindows(generator, area, count);
+    const QSize size(1600, 1200);
+
+    if (reference) {
+        QBENCHMARK {
+            referencePlacement(size, area, windows, nullptr);
+        }
+    } else {
+        QBENCHMARK {
+            createPlacement(area, windows).place(size);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSmartPlacement)
+#include "test_smart_placement.moc"
@@ -546,7 +546,12 @@ void Client::updateFrameExtents()
 
 Xcb::Property Client::fetchGtkFrameExtents() const
 {
-    return Xcb::Property(false, m_client, atoms->gtk_frame_extents, XCB_ATOM_CARDINAL, 0, 4);
+    return fetchGtkFrameExtents(m_client);
+}
+
+Xcb::Property Client::fetchGtkFrameExtents(xcb_window_t window)
+{
+    return Xcb::Property(false, window, atoms->gtk_frame_extents, XCB_ATOM_CARDINAL, 0, 4);
 }
 
 void Client::readGtkFrameExtents(Xcb::Property &prop)
@@ -913,8 +918,14 @@ void Client::updateVisibility()
 {
     if (deleting)
         return;
+    // Skip the property change if nothing changes, desktop switches call this for many windows
+    auto setHiddenState = [this](bool hiddenState) {
+        if (info->state().testFlag(NET::Hidden) != hiddenState) {
+            info->setState(hiddenState ? NET::Hidden : NET::States(), NET::Hidden);
+        }
+    };
     if (hidden) {
-        info->setState(NET::Hidden, NET::Hidden);
+        setHiddenState(true);
         setSkipTaskbar(true);   // Also hide from taskbar
         if (compositing() && options->hiddenPreviews() == HiddenPreviewsAlways)
             internalKeep();
@@ -924,14 +935,14 @@ void Client::updateVisibility()
     }
     setSkipTaskbar(originalSkipTaskbar());   // Reset from 'hidden'
     if (isMinimized()) {
-        info->setState(NET::Hidden, NET::Hidden);
+        setHiddenState(true);
         if (compositing() && options->hiddenPreviews() == HiddenPreviewsAlways)
             internalKeep();
         else
             internalHide();
         return;
     }
-    info->setState(NET::States(), NET::Hidden);
+    setHiddenState(false);
     if (!isOnCurrentDesktop()) {
         if (compositing() && options->hiddenPreviews() != HiddenPreviewsNever)
             internalKeep();
@@ -1473,6 +1484,30 @@ QString Client::readName() const
     }
 }
 
+Xcb::Property Client::fetchWmName(xcb_window_t window)
+{
+    return Xcb::Property(false, window, XCB_ATOM_WM_NAME, XCB_ATOM_ANY, 0, 10000);
+}
+
+QString Client::readName(Xcb::Property &wmName) const
+{
+    if (info->name() && info->name()[0] != '\0') {
+        return QString::fromUtf8(info->name()).simplified();
+    }
+    // WM_NAME can be either STRING or UTF8_STRING, see readNameProperty()
+    const xcb_get_property_reply_t *reply = wmName.data();
+    if (!reply || reply->format != 8) {
+        return QString();
+    }
+    const QByteArray name(reinterpret_cast<const char*>(xcb_get_property_value(reply)), xcb_get_property_value_length(reply));
+    if (reply->type == atoms->utf8_string) {
+        return QString::fromUtf8(name).simplified();
+    } else if (reply->type == XCB_ATOM_STRING) {
+        return QString::fromLocal8Bit(name).simplified();
+    }
+    return QString();
+}
+
 // The list is taken from https://www.unicode.org/reports/tr9/ (#154840)
 static const QChar LRM(0x200E);
 
@@ -1652,14 +1687,32 @@ void Client::getIcons()
     setIcon(icon);
 }
 
-void Client::getSyncCounter()
+static bool isSyncSupported()
 {
     // TODO: make sync working on XWayland
     static const bool isX11 = kwinApp()->operationMode() == Application::OperationModeX11;
-    if (!Xcb::Extensions::self()->isSyncAvailable() || !isX11)
+    return Xcb::Extensions::self()->isSyncAvailable() && isX11;
+}
+
+Xcb::Property Client::fetchSyncCounter(xcb_window_t window)
+{
+    if (!isSyncSupported()) {
+        return Xcb::Property();
+    }
+    return Xcb::Property(false, window, atoms->net_wm_sync_request_counter, XCB_ATOM_CARDINAL, 0, 1);
+}
+
+void Client::getSyncCounter()
+{
+    Xcb::Property syncProp = fetchSyncCounter(window());
+    readSyncCounter(syncProp);
+}
+
+void Client::readSyncCounter(Xcb::Property &syncProp)
+{
+    if (!isSyncSupported())
         return;
 
-    Xcb::Property syncProp(false, window(), atoms->net_wm_sync_request_counter, XCB_ATOM_CARDINAL, 0, 1);
     const xcb_sync_counter_t counter = syncProp.value<xcb_sync_counter_t>(XCB_NONE);
     if (counter != XCB_NONE) {
         syncRequest.counter = counter;
@@ -1812,10 +1865,16 @@ void Client::debug(QDebug& stream) const
 }
 
 Xcb::StringProperty Client::fetchActivities() const
+{
+    return fetchActivities(window());
+}
+
+Xcb::StringProperty Client::fetchActivities(xcb_window_t window)
 {
 #ifdef KWIN_BUILD_ACTIVITIES
-    return Xcb::StringProperty(window(), atoms->activities);
+    return Xcb::StringProperty(window, atoms->activities);
 #else
+    Q_UNUSED(window)
     return Xcb::StringProperty();
 #endif
 }
@@ -1896,7 +1955,12 @@ QRect Client::decorationRect() const
 
 Xcb::Property Client::fetchFirstInTabBox() const
 {
-    return Xcb::Property(false, m_client, atoms->kde_first_in_window_list,
+    return fetchFirstInTabBox(m_client);
+}
+
+Xcb::Property Client::fetchFirstInTabBox(xcb_window_t window)
+{
+    return Xcb::Property(false, window, atoms->kde_first_in_window_list,
                          atoms->kde_first_in_window_list, 0, 1);
 }
 
@@ -1914,7 +1978,12 @@ void Client::updateFirstInTabBox()
 
 Xcb::StringProperty Client::fetchColorScheme() const
 {
-    return Xcb::StringProperty(m_client, atoms->kde_color_sheme);
+    return fetchColorScheme(m_client);
+}
+
+Xcb::StringProperty Client::fetchColorScheme(xcb_window_t window)
+{
+    return Xcb::StringProperty(window, atoms->kde_color_sheme);
 }
 
 void Client::readColorScheme(Xcb::StringProperty &property)
@@ -1968,7 +2037,12 @@ xcb_window_t Client::frameId() const
 
 Xcb::Property Client::fetchShowOnScreenEdge() const
 {
-    return Xcb::Property(false, window(), atoms->kde_screen_edge_show, XCB_ATOM_CARDINAL, 0, 1);
+    return fetchShowOnScreenEdge(window());
+}
+
+Xcb::Property Client::fetchShowOnScreenEdge(xcb_window_t window)
+{
+    return Xcb::Property(false, window, atoms->kde_screen_edge_show, XCB_ATOM_CARDINAL, 0, 1);
 }
 
 void Client::readShowOnScreenEdge(Xcb::Property &property)
@@ -2080,7 +2154,12 @@ QSize Client::resizeIncrements() const
 
 Xcb::StringProperty Client::fetchApplicationMenuServiceName() const
 {
-    return Xcb::StringProperty(m_client, atoms->kde_net_wm_appmenu_service_name);
+    return fetchApplicationMenuServiceName(m_client);
+}
+
+Xcb::StringProperty Client::fetchApplicationMenuServiceName(xcb_window_t window)
+{
+    return Xcb::StringProperty(window, atoms->kde_net_wm_appmenu_service_name);
 }
 
 void Client::readApplicationMenuServiceName(Xcb::StringProperty &property)
@@ -2096,7 +2175,12 @@ void Client::checkApplicationMenuServiceName()
 
 Xcb::StringProperty Client::fetchApplicationMenuObjectPath() const
 {
-    return Xcb::StringProperty(m_client, atoms->kde_net_wm_appmenu_object_path);
+    return fetchApplicationMenuObjectPath(m_client);
+}
+
+Xcb::StringProperty Client::fetchApplicationMenuObjectPath(xcb_window_t window)
+{
+    return Xcb::StringProperty(window, atoms->kde_net_wm_appmenu_object_path);
 }
 
 void Client::readApplicationMenuObjectPath(Xcb::StringProperty &property)
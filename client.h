@@ -45,6 +45,7 @@ class KStartupInfoId;
 namespace KWin
 {
 
+class ClientManageRequests;
 
 /**
  * @brief Defines Predicates on how to search for a Client.
@@ -117,6 +118,7 @@ public:
     NET::WindowType windowType(bool direct = false, int supported_types = 0) const override;
 
     bool manage(xcb_window_t w, bool isMapped);
+    bool manage(ClientManageRequests &requests, bool isMapped);
     void releaseWindow(bool on_shutdown = false);
     void destroyClient();
 
@@ -272,9 +274,11 @@ public:
     void layoutDecorationRects(QRect &left, QRect &top, QRect &right, QRect &bottom) const override;
 
     Xcb::Property fetchFirstInTabBox() const;
+    static Xcb::Property fetchFirstInTabBox(xcb_window_t window);
     void readFirstInTabBox(Xcb::Property &property);
     void updateFirstInTabBox();
     Xcb::StringProperty fetchColorScheme() const;
+    static Xcb::StringProperty fetchColorScheme(xcb_window_t window);
     void readColorScheme(Xcb::StringProperty &property);
     void updateColorScheme() override;
 
@@ -294,10 +298,12 @@ public:
     void showOnScreenEdge() override;
 
     Xcb::StringProperty fetchApplicationMenuServiceName() const;
+    static Xcb::StringProperty fetchApplicationMenuServiceName(xcb_window_t window);
     void readApplicationMenuServiceName(Xcb::StringProperty &property);
     void checkApplicationMenuServiceName();
 
     Xcb::StringProperty fetchApplicationMenuObjectPath() const;
+    static Xcb::StringProperty fetchApplicationMenuObjectPath(xcb_window_t window);
     void readApplicationMenuObjectPath(Xcb::StringProperty &property);
     void checkApplicationMenuObjectPath();
 
@@ -410,6 +416,8 @@ private:
     void fetchName();
     void fetchIconicName();
     QString readName() const;
+    static Xcb::Property fetchWmName(xcb_window_t window);
+    QString readName(Xcb::Property &wmName) const;
     void setCaption(const QString& s, bool force = false);
     bool hasTransientInternal(const Client* c, bool indirect, ConstClientList& set) const;
     void setShortcutInternal() override;
@@ -417,6 +425,8 @@ private:
     void configureRequest(int value_mask, int rx, int ry, int rw, int rh, int gravity, bool from_tool);
     NETExtendedStrut strut() const;
     int checkShadeGeometry(int w, int h);
+    static Xcb::Property fetchSyncCounter(xcb_window_t window);
+    void readSyncCounter(Xcb::Property &syncProp);
     void getSyncCounter();
     void sendSyncRequest();
     void leaveMoveResize() override;
@@ -436,6 +446,7 @@ private:
     void embedClient(xcb_window_t w, xcb_visualid_t visualid, xcb_colormap_t colormap, uint8_t depth);
     void detectNoBorder();
     Xcb::Property fetchGtkFrameExtents() const;
+    static Xcb::Property fetchGtkFrameExtents(xcb_window_t window);
     void readGtkFrameExtents(Xcb::Property &prop);
     void detectGtkFrameExtents();
     void destroyDecoration() override;
@@ -458,6 +469,7 @@ private:
     void updateInputWindow();
 
     Xcb::Property fetchShowOnScreenEdge() const;
+    static Xcb::Property fetchShowOnScreenEdge(xcb_window_t window);
     void readShowOnScreenEdge(Xcb::Property &property);
     /**
      * Reads the property and creates/destroys the screen edge if required
@@ -486,6 +498,7 @@ private:
     MappingState mapping_state;
 
     Xcb::TransientFor fetchTransient() const;
+    static Xcb::TransientFor fetchTransient(xcb_window_t window);
     void readTransientProperty(Xcb::TransientFor &transientFor);
     void readTransient();
     xcb_window_t verifyTransientFor(xcb_window_t transient_for, bool set);
@@ -532,8 +545,10 @@ private:
     friend struct ResetupRulesProcedure;
 
     friend bool performTransiencyCheck();
+    friend class ClientManageRequests;
 
     Xcb::StringProperty fetchActivities() const;
+    static Xcb::StringProperty fetchActivities(xcb_window_t window);
     void readActivities(Xcb::StringProperty &property);
     void checkActivities();
     bool activitiesDefined; //whether the x property was actually set
@@ -553,6 +568,52 @@ private:
     QMetaObject::Connection m_edgeGeometryTrackingConnection;
 };
 
+/**
+ * @brief The X11 requests Client::manage() needs the replies of.
+ *
+ * Creating an instance only issues the requests, the replies are waited for once
+ * Client::manage() reads them. When adopting many windows at once, e.g. all existing
+ * windows during startup, the requests for all windows can be created first, so that
+ * the round trips for all windows are pipelined instead of being done one after another.
+ *
+ * The NET properties are not part of it: NETWinInfo can't be created from pre-fetched
+ * replies, so constructing it remains one round trip per window.
+ */
+class ClientManageRequests
+{
+public:
+    explicit ClientManageRequests(xcb_window_t window);
+    /**
+     * Takes over the already issued @p attributes and @p geometry requests for @p window.
+     */
+    ClientManageRequests(xcb_window_t window, const Xcb::WindowAttributes &attributes, const Xcb::WindowGeometry &geometry);
+
+    xcb_window_t window() const {
+        return m_window;
+    }
+
+private:
+    xcb_window_t m_window;
+    Xcb::WindowAttributes m_attributes;
+    Xcb::WindowGeometry m_geometry;
+    Xcb::Property m_wmClientLeader;
+    Xcb::Property m_skipCloseAnimation;
+    Xcb::Property m_gtkFrameExtents;
+    Xcb::Property m_showOnScreenEdge;
+    Xcb::StringProperty m_colorScheme;
+    Xcb::Property m_firstInTabBox;
+    Xcb::TransientFor m_transient;
+    Xcb::StringProperty m_activities;
+    Xcb::StringProperty m_applicationMenuServiceName;
+    Xcb::StringProperty m_applicationMenuObjectPath;
+    Xcb::GeometryHints m_geometryHints;
+    Xcb::MotifHints m_motif;
+    Xcb::Property m_wmName;
+    Xcb::Property m_syncCounter;
+    Xcb::ShapeExtents m_shapeExtents;
+    friend class Client;
+};
+
 inline xcb_window_t Client::wrapperId() const
 {
     return m_wrapper;
@@ -68,6 +68,11 @@ public:
     ~ClientMachine() override;
 
     void resolve(xcb_window_t window, xcb_window_t clientLeader);
+    /**
+     * Like resolve(xcb_window_t, xcb_window_t), but with the already read WM_CLIENT_MACHINE
+     * property of @p window. Only the @p clientLeader is queried if it is empty.
+     */
+    void resolve(const QByteArray &windowHostName, xcb_window_t window, xcb_window_t clientLeader);
     const QByteArray &hostName() const;
     bool isLocal() const;
     static QByteArray localhost();
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "effects.h"
 #include "overlaywindow.h"
 #include "platform.h"
+#include "presentation_time.h"
 #include "scene.h"
 #include "screens.h"
 #include "shadow.h"
@@ -146,6 +147,13 @@ Compositor::Compositor(QObject* workspace)
     connect(&m_unusedSupportPropertyTimer, &QTimer::timeout,
             this, &Compositor::deleteUnusedSupportProperties);
 
+    // Windows which are not visible get their frame callbacks once per second,
+    // they should not render more frames, but must not stall either.
+    m_throttledFrameCallbackTimer.setInterval(1000);
+    m_throttledFrameCallbackTimer.setSingleShot(true);
+    connect(&m_throttledFrameCallbackTimer, &QTimer::timeout,
+            this, &Compositor::sendThrottledFrameCallbacks);
+
     // Delay the call to start by one event cycle.
     // The ctor of this class is invoked from the Workspace ctor, that means before
     // Workspace is completely constructed, so calling Workspace::self() would result
@@ -589,6 +597,11 @@ void Compositor::bufferSwapComplete()
     Q_ASSERT(m_bufferSwapPending);
     m_bufferSwapPending = false;
 
+    if (waylandServer()) {
+        // outputs which didn't report a page flip of their own
+        waylandServer()->presentationTime()->presentedUnsynchronized();
+    }
+
     emit bufferSwapCompleted();
 
     if (m_composeAtSwapCompletion) {
@@ -607,6 +620,9 @@ void Compositor::performCompositing()
         return;
     }
 
+    // Allows to apply held back state, e.g. merged pointer motion, right before the frame
+    emit aboutToComposite();
+
     // If outputs are disabled, we return to the event loop and
     // continue processing events until the outputs are enabled again
     if (!kwinApp()->platform()->areOutputsEnabled()) {
@@ -690,6 +706,7 @@ void Compositor::performCompositing()
         kwinApp()->platform()->createOpenGLSafePoint(Platform::OpenGLSafePoint::PreFrame);
     }
     m_timeSinceLastVBlank = m_scene->paint(repaints, windows);
+    emit framePainted(m_timeSinceLastVBlank);
     if (m_framesToTestForSafety > 0) {
         if (m_scene->compositingType() & OpenGLCompositing) {
             kwinApp()->platform()->createOpenGLSafePoint(Platform::OpenGLSafePoint::PostFrame);
@@ -702,11 +719,10 @@ void Compositor::performCompositing()
     }
 
     if (waylandServer()) {
-        const auto currentTime = static_cast<quint32>(m_monotonicClock.elapsed());
-        for (Toplevel *win : qAsConst(windows)) {
-            if (auto surface = win->surface()) {
-                surface->frameRendered(currentTime);
-            }
+        sendFrameCallbacks(windows);
+        if (!m_bufferSwapPending) {
+            // the platform doesn't tell when the frame reaches the screen
+            waylandServer()->presentationTime()->presentedUnsynchronized();
         }
     }
 
@@ -725,6 +741,39 @@ void Compositor::performCompositing()
     }
 }
 
+void Compositor::sendFrameCallbacks(const QList<Toplevel*> &windows)
+{
+    const auto currentTime = static_cast<quint32>(m_monotonicClock.elapsed());
+    QList<Toplevel*> visibleWindows;
+    for (Toplevel *win : windows) {
+        auto surface = win->surface();
+        if (!surface) {
+            continue;
+        }
+        if (m_scene->isVisibleInFrame(win)) {
+            surface->frameRendered(currentTime);
+            visibleWindows << win;
+        } else if (!m_throttledSurfaces.contains(surface)) {
+            m_throttledSurfaces << surface;
+        }
+    }
+    if (!m_throttledSurfaces.isEmpty() && !m_throttledFrameCallbackTimer.isActive()) {
+        m_throttledFrameCallbackTimer.start();
+    }
+    waylandServer()->presentationTime()->lock(visibleWindows);
+}
+
+void Compositor::sendThrottledFrameCallbacks()
+{
+    const auto currentTime = static_cast<quint32>(m_monotonicClock.elapsed());
+    for (const auto &surface : qAsConst(m_throttledSurfaces)) {
+        if (surface) {
+            surface->frameRendered(currentTime);
+        }
+    }
+    m_throttledSurfaces.clear();
+}
+
 template <class T>
 static bool repaintsPending(const QList<T*> &windows)
 {
@@ -24,15 +24,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QObject>
 #include <QElapsedTimer>
+#include <QPointer>
 #include <QTimer>
 #include <QBasicTimer>
 #include <QRegion>
+#include <QVector>
+
+namespace KWayland
+{
+namespace Server
+{
+class SurfaceInterface;
+}
+}
 
 namespace KWin
 {
 class Client;
 class CompositorSelectionOwner;
 class Scene;
+class Toplevel;
 
 class KWIN_EXPORT Compositor : public QObject
 {
@@ -115,6 +126,14 @@ Q_SIGNALS:
     void aboutToToggleCompositing();
     void sceneCreated();
     void bufferSwapCompleted();
+    /**
+     * Emitted when the compositor starts to prepare a new frame, before the damage is collected.
+     */
+    void aboutToComposite();
+    /**
+     * Emitted after the scene painted a frame, @p nanoseconds is the time the scene took.
+     */
+    void framePainted(qint64 nanoseconds);
 
 protected:
     explicit Compositor(QObject *parent = nullptr);
@@ -150,6 +169,8 @@ private:
 
     void releaseCompositorSelection();
     void deleteUnusedSupportProperties();
+    void sendFrameCallbacks(const QList<Toplevel*> &windows);
+    void sendThrottledFrameCallbacks();
 
     State m_state;
 
@@ -158,6 +179,8 @@ private:
     QTimer m_releaseSelectionTimer;
     QList<xcb_atom_t> m_unusedSupportProperties;
     QTimer m_unusedSupportPropertyTimer;
+    QTimer m_throttledFrameCallbackTimer;
+    QVector<QPointer<KWayland::Server::SurfaceInterface>> m_throttledSurfaces;
     qint64 vBlankInterval, fpsInterval;
     QRegion repaints_region;
 
@@ -38,6 +38,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef KWIN_BUILD_ACTIVITIES
 #include "activities.h"
 #endif
+#include <kwingltexture.h>
+#include <kwinglutils.h>
 
 // Qt
 #include <QOpenGLContext>
@@ -307,6 +309,64 @@ bool CompositorDBusInterface::platformRequiresCompositing() const
     return kwinApp()->platform()->requiresCompositing();
 }
 
+QVariantMap CompositorDBusInterface::textureMemoryUsage() const
+{
+    QVariantMap usage;
+    if (!m_compositor->scene() || m_compositor->scene()->compositingType() != OpenGL2Compositing) {
+        return usage;
+    }
+    usage.insert(QStringLiteral("windowPixmaps"), GLTexture::memoryUsage(GLTexture::MemoryCategory::WindowPixmap));
+    usage.insert(QStringLiteral("previousWindowPixmaps"), GLTexture::memoryUsage(GLTexture::MemoryCategory::PreviousWindowPixmap));
+    usage.insert(QStringLiteral("decorations"), GLTexture::memoryUsage(GLTexture::MemoryCategory::Decoration));
+    usage.insert(QStringLiteral("shadows"), GLTexture::memoryUsage(GLTexture::MemoryCategory::Shadow));
+    usage.insert(QStringLiteral("caches"), GLTexture::memoryUsage(GLTexture::MemoryCategory::Cache));
+    usage.insert(QStringLiteral("effects"), GLTexture::memoryUsage(GLTexture::MemoryCategory::Effect));
+    usage.insert(QStringLiteral("other"), GLTexture::memoryUsage(GLTexture::MemoryCategory::Other));
+    usage.insert(QStringLiteral("total"), GLTexture::totalMemoryUsage());
+    return usage;
+}
+
+qlonglong CompositorDBusInterface::textureMemoryBudget() const
+{
+    return GLTexture::memoryBudget();
+}
+
+bool CompositorDBusInterface::isGpuProfiling() const
+{
+    return GLProfiler::isEnabled();
+}
+
+void CompositorDBusInterface::setGpuProfiling(bool enabled)
+{
+    if (enabled && (!m_compositor->scene() || m_compositor->scene()->compositingType() != OpenGL2Compositing
+                    || !GLProfiler::isSupported())) {
+        return;
+    }
+    GLProfiler::setEnabled(enabled);
+}
+
+QVariantMap CompositorDBusInterface::gpuFrameProfile() const
+{
+    QVariantMap profile;
+    const GLProfiler::Frame frame = GLProfiler::lastFrame();
+    if (frame.sequence == 0) {
+        return profile;
+    }
+    QVariantList passes;
+    for (const GLProfiler::Pass &pass : frame.passes) {
+        passes << QVariantMap({
+            {QStringLiteral("name"), pass.name},
+            {QStringLiteral("depth"), pass.depth},
+            {QStringLiteral("time"), pass.time},
+            {QStringLiteral("selfTime"), pass.selfTime}
+        });
+    }
+    profile.insert(QStringLiteral("sequence"), frame.sequence);
+    profile.insert(QStringLiteral("time"), frame.time);
+    profile.insert(QStringLiteral("passes"), passes);
+    return profile;
+}
+
 void CompositorDBusInterface::resume()
 {
     if (kwinApp()->operationMode() == Application::OperationModeX11) {
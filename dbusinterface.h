@@ -123,6 +123,34 @@ class CompositorDBusInterface : public QObject
      */
     Q_PROPERTY(QStringList supportedOpenGLPlatformInterfaces READ supportedOpenGLPlatformInterfaces)
     Q_PROPERTY(bool platformRequiresCompositing READ platformRequiresCompositing)
+    /**
+     * @brief Estimated texture memory in bytes per category.
+     *
+     * Keys are @c windowPixmaps, @c previousWindowPixmaps, @c decorations, @c shadows,
+     * @c caches, @c effects, @c other and @c total. Empty if not compositing with OpenGL.
+     */
+    Q_PROPERTY(QVariantMap textureMemoryUsage READ textureMemoryUsage)
+    /**
+     * @brief The texture memory budget in bytes, caches are dropped above it. @c 0 if unlimited.
+     *
+     * Configured with the @c TextureMemoryBudget entry (in MiB) of the @c Compositing group.
+     */
+    Q_PROPERTY(qlonglong textureMemoryBudget READ textureMemoryBudget)
+    /**
+     * @brief Whether the GPU time of effects and windows is measured each frame.
+     *
+     * Only available when compositing with OpenGL 3.3 or GL_ARB_timer_query.
+     */
+    Q_PROPERTY(bool gpuProfiling READ isGpuProfiling WRITE setGpuProfiling)
+    /**
+     * @brief The GPU time breakdown of the most recent profiled frame.
+     *
+     * Contains the @c sequence number of the frame, its total @c time in nanoseconds and
+     * the @c passes in the order they began. Each pass has a @c name, its nesting @c depth,
+     * its @c time including nested passes and its @c selfTime without them, both in
+     * nanoseconds. Empty if gpuProfiling has not produced a frame yet.
+     */
+    Q_PROPERTY(QVariantMap gpuFrameProfile READ gpuFrameProfile)
 public:
     explicit CompositorDBusInterface(Compositor *parent);
     ~CompositorDBusInterface() override = default;
@@ -134,6 +162,11 @@ public:
     QString compositingType() const;
     QStringList supportedOpenGLPlatformInterfaces() const;
     bool platformRequiresCompositing() const;
+    QVariantMap textureMemoryUsage() const;
+    qlonglong textureMemoryBudget() const;
+    bool isGpuProfiling() const;
+    void setGpuProfiling(bool enabled);
+    QVariantMap gpuFrameProfile() const;
 
 public Q_SLOTS:
     /**
@@ -47,10 +47,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QMouseEvent>
 #include <QMetaProperty>
 #include <QMetaType>
+#include <QTimer>
 
 // xkb
 #include <xkbcommon/xkbcommon.h>
 
+#include <algorithm>
 #include <functional>
 
 namespace KWin
@@ -514,6 +516,9 @@ DebugConsole::DebugConsole()
                 m_inputFilter.reset(new DebugConsoleFilter(m_ui->inputTextEdit));
                 input()->installInputEventSpy(m_inputFilter.data());
             }
+            if (index == 4) {
+                updateTextureMemory();
+            }
             if (index == 5) {
                 updateKeyboardTab();
                 connect(input(), &InputRedirection::keyStateChanged, this, &DebugConsole::updateKeyboardTab);
@@ -559,6 +564,90 @@ void DebugConsole::initGLTab()
 
     m_ui->platformExtensionsLabel->setText(extensionsString(Compositor::self()->scene()->openGLPlatformInterfaceExtensions()));
     m_ui->openGLExtensionsLabel->setText(extensionsString(openGLExtensions()));
+    updateTextureMemory();
+
+    m_gpuTimeTimer = new QTimer(this);
+    m_gpuTimeTimer->setInterval(1000);
+    connect(m_gpuTimeTimer, &QTimer::timeout, this, &DebugConsole::updateGpuTime);
+    m_ui->gpuProfilingCheckBox->setEnabled(GLProfiler::isSupported());
+    m_ui->gpuProfilingCheckBox->setChecked(GLProfiler::isEnabled());
+    connect(m_ui->gpuProfilingCheckBox, &QCheckBox::toggled, this,
+        [this] (bool enabled) {
+            GLProfiler::setEnabled(enabled);
+            updateGpuTime();
+        }
+    );
+    updateGpuTime();
+}
+
+void DebugConsole::updateGpuTime()
+{
+    if (!GLProfiler::isEnabled()) {
+        m_gpuTimeTimer->stop();
+        m_ui->gpuTimeLabel->clear();
+        return;
+    }
+    m_gpuTimeTimer->start();
+    const GLProfiler::Frame frame = GLProfiler::lastFrame();
+    if (frame.sequence == 0) {
+        m_ui->gpuTimeLabel->setText(i18n("Waiting for the first frame"));
+        return;
+    }
+    // the same pass may run many times per frame, e.g. an effect painting several windows
+    QHash<QString, qint64> selfTimes;
+    for (const GLProfiler::Pass &pass : frame.passes) {
+        selfTimes[pass.name] += pass.selfTime;
+    }
+    QVector<QPair<QString, qint64>> sorted;
+    sorted.reserve(selfTimes.count());
+    for (auto it = selfTimes.constBegin(); it != selfTimes.constEnd(); ++it) {
+        sorted << qMakePair(it.key(), it.value());
+    }
+    std::sort(sorted.begin(), sorted.end(),
+        [] (const QPair<QString, qint64> &a, const QPair<QString, qint64> &b) {
+            return a.second > b.second;
+        }
+    );
+    auto toMs = [] (qint64 nsecs) {
+        return i18nc("Duration", "%1 ms", QString::number(nsecs / 1000000.0, 'f', 3));
+    };
+    QString text = QStringLiteral("<ul>");
+    text.append(QStringLiteral("<li><b>%1: %2</b></li>").arg(i18n("Frame"), toMs(frame.time)));
+    const int shown = qMin(sorted.count(), 20);
+    for (int i = 0; i < shown; ++i) {
+        text.append(QStringLiteral("<li>%1: %2</li>").arg(sorted.at(i).first.toHtmlEscaped(), toMs(sorted.at(i).second)));
+    }
+    text.append(QStringLiteral("</ul>"));
+    m_ui->gpuTimeLabel->setText(text);
+}
+
+void DebugConsole::updateTextureMemory()
+{
+    if (!effects || !effects->isOpenGLCompositing()) {
+        return;
+    }
+    const std::initializer_list<std::pair<GLTexture::MemoryCategory, QString>> categories = {
+        {GLTexture::MemoryCategory::WindowPixmap, i18n("Window contents")},
+        {GLTexture::MemoryCategory::PreviousWindowPixmap, i18n("Previous window contents")},
+        {GLTexture::MemoryCategory::Decoration, i18n("Decorations")},
+        {GLTexture::MemoryCategory::Shadow, i18n("Shadows")},
+        {GLTexture::MemoryCategory::Cache, i18n("Caches")},
+        {GLTexture::MemoryCategory::Effect, i18n("Effects")},
+        {GLTexture::MemoryCategory::Other, i18n("Other")}
+    };
+    auto toMiB = [] (qint64 bytes) {
+        return i18nc("Amount of memory", "%1 MiB", QString::number(bytes / (1024.0 * 1024.0), 'f', 1));
+    };
+    QString text = QStringLiteral("<ul>");
+    for (const auto &category : categories) {
+        text.append(QStringLiteral("<li>%1: %2</li>").arg(category.second, toMiB(GLTexture::memoryUsage(category.first))));
+    }
+    text.append(QStringLiteral("<li><b>%1: %2</b></li>").arg(i18n("Total"), toMiB(GLTexture::totalMemoryUsage())));
+    if (GLTexture::memoryBudget() > 0) {
+        text.append(QStringLiteral("<li>%1: %2</li>").arg(i18n("Budget"), toMiB(GLTexture::memoryBudget())));
+    }
+    text.append(QStringLiteral("</ul>"));
+    m_ui->textureMemoryLabel->setText(text);
 }
 
 template <typename T>
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QVector>
 
 class QTextEdit;
+class QTimer;
 
 namespace Ui
 {
@@ -107,10 +108,13 @@ protected:
 
 private:
     void initGLTab();
+    void updateTextureMemory();
+    void updateGpuTime();
     void updateKeyboardTab();
 
     QScopedPointer<Ui::DebugConsole> m_ui;
     QScopedPointer<DebugConsoleFilter> m_inputFilter;
+    QTimer *m_gpuTimeTimer = nullptr;
 };
 
 class SurfaceTreeModel : public QAbstractItemModel
@@ -31,10 +31,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <KPackage/Package>
 #include <KPackage/PackageLoader>
 // Qt
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 #include <QDebug>
 #include <QFutureWatcher>
 #include <QMap>
+#include <QPluginLoader>
 #include <QStringList>
 
 namespace KWin
@@ -115,7 +117,7 @@ void BuiltInEffectLoader::queryAndLoadAll()
         const QString key = BuiltInEffects::nameForEffect(effect);
         const LoadEffectFlags flags = readConfig(key, BuiltInEffects::enabledByDefault(effect));
         if (flags.testFlag(LoadEffectFlag::Load)) {
-            m_queue->enqueue(qMakePair(effect, flags));
+            m_queue->enqueue(qMakePair(effect, flags), BuiltInEffects::effectData(effect).deferred);
         }
     }
 }
@@ -183,10 +185,20 @@ void BuiltInEffectLoader::clear()
     m_queue->clear();
 }
 
+void BuiltInEffectLoader::setDeferredEffectsHeld(bool held)
+{
+    m_queue->setHoldDeferred(held);
+}
+
 static const QString s_nameProperty = QStringLiteral("X-KDE-PluginInfo-Name");
 static const QString s_jsConstraint = QStringLiteral("[X-Plasma-API] == 'javascript'");
 static const QString s_serviceType = QStringLiteral("KWin/Effect");
 
+static bool isDeferred(const KPluginMetaData &metadata)
+{
+    return metadata.value(QStringLiteral("X-KWin-Deferred-Loading")) == QLatin1String("true");
+}
+
 ScriptedEffectLoader::ScriptedEffectLoader(QObject *parent)
     : AbstractEffectLoader(parent)
     , m_queue(new EffectLoadQueue<ScriptedEffectLoader, KPluginMetaData>(this))
@@ -277,7 +289,7 @@ void ScriptedEffectLoader::queryAndLoadAll()
             for (auto effect : effects) {
                 const LoadEffectFlags flags = readConfig(effect.pluginId(), effect.isEnabledByDefault());
                 if (flags.testFlag(LoadEffectFlag::Load)) {
-                    m_queue->enqueue(qMakePair(effect, flags));
+                    m_queue->enqueue(qMakePair(effect, flags), isDeferred(effect));
                 }
             }
             watcher->deleteLater();
@@ -313,15 +325,25 @@ void ScriptedEffectLoader::clear()
     m_queue->clear();
 }
 
+void ScriptedEffectLoader::setDeferredEffectsHeld(bool held)
+{
+    m_queue->setHoldDeferred(held);
+}
+
 PluginEffectLoader::PluginEffectLoader(QObject *parent)
     : AbstractEffectLoader(parent)
     , m_queue(new EffectLoadQueue< PluginEffectLoader, KPluginMetaData>(this))
     , m_pluginSubDirectory(QStringLiteral("kwin/effects/plugins/"))
+    , m_preloadWatcher(new QFutureWatcher<void>(this))
 {
+    connect(m_preloadWatcher, &QFutureWatcher<void>::finished, this, &PluginEffectLoader::releasePreloadedLibraries);
 }
 
 PluginEffectLoader::~PluginEffectLoader()
 {
+    m_preloadWatcher->waitForFinished();
+    m_releasedLibraries = m_preloadedLibraries.keys();
+    releasePreloadedLibraries();
 }
 
 bool PluginEffectLoader::hasEffect(const QString &name) const
@@ -405,6 +427,8 @@ bool PluginEffectLoader::loadEffect(const KPluginMetaData &info, LoadEffectFlags
         return false;
     }
     EffectPluginFactory *effectFactory = factory(info);
+    // the factory holds its own reference to the library now
+    releasePreloadedLibrary(info.fileName());
     if (!effectFactory) {
         qCDebug(KWIN_CORE) << "Couldn't get an EffectPluginFactory for: " << name;
         return false;
@@ -453,12 +477,15 @@ void PluginEffectLoader::queryAndLoadAll()
     m_queryConnection = connect(watcher, &QFutureWatcher<QVector<KPluginMetaData>>::finished, this,
         [this, watcher]() {
             const auto effects = watcher->result();
+            QStringList libraries;
             for (const auto &effect : effects) {
                 const LoadEffectFlags flags = readConfig(effect.pluginId(), effect.isEnabledByDefault());
                 if (flags.testFlag(LoadEffectFlag::Load)) {
-                    m_queue->enqueue(qMakePair(effect, flags));
+                    m_queue->enqueue(qMakePair(effect, flags), isDeferred(effect));
+                    libraries << effect.fileName();
                 }
             }
+            preloadLibraries(libraries);
             watcher->deleteLater();
             m_queryConnection = QMetaObject::Connection();
         },
@@ -466,6 +493,58 @@ void PluginEffectLoader::queryAndLoadAll()
     watcher->setFuture(QtConcurrent::run(this, &PluginEffectLoader::findAllEffects));
 }
 
+void PluginEffectLoader::preloadLibraries(const QStringList &libraries)
+{
+    if (libraries.isEmpty() || m_preloadWatcher->isRunning()) {
+        return;
+    }
+    // Resolving and relocating the plugin libraries is the expensive part of loading
+    // a plugin effect. Do it for all libraries concurrently while the queue is processed,
+    // the plugin instance is still created on the main thread. As QPluginLoader shares the
+    // library handle, the preloaded library stays resident and the later load is cheap.
+    QVector<QPluginLoader*> loaders;
+    for (const QString &fileName : libraries) {
+        if (m_preloadedLibraries.contains(fileName)) {
+            continue;
+        }
+        QPluginLoader *loader = new QPluginLoader(fileName);
+        m_preloadedLibraries.insert(fileName, loader);
+        loaders << loader;
+    }
+    m_preloadWatcher->setFuture(QtConcurrent::run([loaders] {
+        QtConcurrent::blockingMap(loaders, [] (QPluginLoader *loader) {
+            if (!loader->load()) {
+                qCDebug(KWIN_CORE) << "Could not preload plugin effect" << loader->fileName() << loader->errorString();
+            }
+        });
+    }));
+}
+
+void PluginEffectLoader::releasePreloadedLibrary(const QString &fileName)
+{
+    if (!m_preloadedLibraries.contains(fileName)) {
+        return;
+    }
+    m_releasedLibraries << fileName;
+    if (!m_preloadWatcher->isRunning()) {
+        releasePreloadedLibraries();
+    }
+}
+
+void PluginEffectLoader::releasePreloadedLibraries()
+{
+    for (const QString &fileName : qAsConst(m_releasedLibraries)) {
+        QPluginLoader *loader = m_preloadedLibraries.take(fileName);
+        if (!loader) {
+            continue;
+        }
+        // only drops the reference of the preload, the library stays loaded while an effect uses it
+        loader->unload();
+        delete loader;
+    }
+    m_releasedLibraries.clear();
+}
+
 QVector<KPluginMetaData> PluginEffectLoader::findAllEffects() const
 {
     return KPluginLoader::findPlugins(m_pluginSubDirectory, [] (const KPluginMetaData &data) { return data.serviceTypes().contains(s_serviceType); });
@@ -481,6 +560,16 @@ void PluginEffectLoader::clear()
     disconnect(m_queryConnection);
     m_queryConnection = QMetaObject::Connection();
     m_queue->clear();
+    // the queued effects won't be created, so don't keep their libraries around
+    m_releasedLibraries = m_preloadedLibraries.keys();
+    if (!m_preloadWatcher->isRunning()) {
+        releasePreloadedLibraries();
+    }
+}
+
+void PluginEffectLoader::setDeferredEffectsHeld(bool held)
+{
+    m_queue->setHoldDeferred(held);
 }
 
 EffectLoader::EffectLoader(QObject *parent)
@@ -555,4 +644,11 @@ void EffectLoader::clear()
     }
 }
 
+void EffectLoader::setDeferredEffectsHeld(bool held)
+{
+    for (auto it = m_loaders.constBegin(); it != m_loaders.constEnd(); ++it) {
+        (*it)->setDeferredEffectsHeld(held);
+    }
+}
+
 } // namespace KWin
@@ -26,10 +26,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // Qt
 #include <QObject>
 #include <QFlags>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QMap>
 #include <QPair>
 #include <QQueue>
 
+class QPluginLoader;
+
 namespace KWin
 {
 class Effect;
@@ -168,6 +172,21 @@ public:
      */
     virtual void clear() = 0;
 
+    /**
+     * @brief Whether Effects which are only activated on user request are held back.
+     *
+     * While held, queryAndLoadAll() keeps the Effects which are marked as deferred, e.g. the
+     * Desktop Grid or the Screenshot Effect, in a separate queue. Once released they get loaded
+     * after all other queued Effects. This allows the Compositor to present the first frame
+     * without waiting for Effects which are not needed yet. Loading an Effect explicitly
+     * through loadEffect(const QString &) is not affected.
+     *
+     * By default deferred Effects are not held back.
+     *
+     * @param held @c true to hold deferred Effects back, @c false to load them
+     */
+    virtual void setDeferredEffectsHeld(bool held) = 0;
+
 Q_SIGNALS:
     /**
      * @brief The loader emits this signal when it successfully loaded an effect.
@@ -214,6 +233,8 @@ private:
  *
  * The queue operates like a normal queue providing enqueue and a scheduleDequeue instead of dequeue.
  *
+ * Effects enqueued as deferred are kept in a second queue while setHoldDeferred() is enabled
+ * and are appended to the normal queue once it gets disabled again.
  */
 class AbstractEffectLoadQueue : public QObject
 {
@@ -235,16 +256,33 @@ public:
         : AbstractEffectLoadQueue(parent)
         , m_effectLoader(parent)
         , m_dequeueScheduled(false)
+        , m_holdDeferred(false)
     {
     }
-    void enqueue(const QPair<QueueType, LoadEffectFlags> value)
+    void enqueue(const QPair<QueueType, LoadEffectFlags> value, bool deferred = false)
     {
+        if (deferred && m_holdDeferred) {
+            m_deferredQueue.enqueue(value);
+            return;
+        }
         m_queue.enqueue(value);
         scheduleDequeue();
     }
+    void setHoldDeferred(bool hold)
+    {
+        m_holdDeferred = hold;
+        if (hold) {
+            return;
+        }
+        while (!m_deferredQueue.isEmpty()) {
+            m_queue.enqueue(m_deferredQueue.dequeue());
+        }
+        scheduleDequeue();
+    }
     void clear()
     {
         m_queue.clear();
+        m_deferredQueue.clear();
         m_dequeueScheduled = false;
     }
 protected:
@@ -269,7 +307,9 @@ private:
     }
     Loader *m_effectLoader;
     bool m_dequeueScheduled;
+    bool m_holdDeferred;
     QQueue<QPair<QueueType, LoadEffectFlags>> m_queue;
+    QQueue<QPair<QueueType, LoadEffectFlags>> m_deferredQueue;
 };
 
 /**
@@ -287,6 +327,7 @@ public:
     QStringList listOfKnownEffects() const override;
 
     void clear() override;
+    void setDeferredEffectsHeld(bool held) override;
     void queryAndLoadAll() override;
     bool loadEffect(const QString& name) override;
     bool loadEffect(BuiltInEffect effect, LoadEffectFlags flags);
@@ -313,6 +354,7 @@ public:
     QStringList listOfKnownEffects() const override;
 
     void clear() override;
+    void setDeferredEffectsHeld(bool held) override;
     void queryAndLoadAll() override;
     bool loadEffect(const QString &name) override;
     bool loadEffect(const KPluginMetaData &effect, LoadEffectFlags flags);
@@ -337,6 +379,7 @@ public:
     QStringList listOfKnownEffects() const override;
 
     void clear() override;
+    void setDeferredEffectsHeld(bool held) override;
     void queryAndLoadAll() override;
     bool loadEffect(const QString &name) override;
     bool loadEffect(const KPluginMetaData &info, LoadEffectFlags flags);
@@ -345,12 +388,20 @@ public:
 
 private:
     QVector<KPluginMetaData> findAllEffects() const;
+    void preloadLibraries(const QStringList &libraries);
+    void releasePreloadedLibrary(const QString &fileName);
+    void releasePreloadedLibraries();
     KPluginMetaData findEffect(const QString &name) const;
     EffectPluginFactory *factory(const KPluginMetaData &info) const;
     QStringList m_loadedEffects;
     EffectLoadQueue< PluginEffectLoader, KPluginMetaData> *m_queue;
     QString m_pluginSubDirectory;
     QMetaObject::Connection m_queryConnection;
+    // keep the preloaded libraries referenced until their effect got created, keyed by file name
+    QHash<QString, QPluginLoader*> m_preloadedLibraries;
+    // released while the preloading was still running
+    QStringList m_releasedLibraries;
+    QFutureWatcher<void> *m_preloadWatcher;
 };
 
 class EffectLoader : public AbstractEffectLoader
@@ -366,6 +417,7 @@ public:
     void queryAndLoadAll() override;
     void setConfig(KSharedConfig::Ptr config) override;
     void clear() override;
+    void setDeferredEffectsHeld(bool held) override;
 
 private:
     QList<AbstractEffectLoader*> m_loaders;
@@ -125,6 +125,7 @@ EffectsHandlerImpl::EffectsHandlerImpl(Compositor *compositor, Scene *scene)
     , m_desktopRendering(false)
     , m_currentRenderedDesktop(0)
     , m_effectLoader(new EffectLoader(this))
+    , m_deferredEffectsHeld(true)
     , m_trackingCursorChanges(0)
 {
     qRegisterMetaType<QVector<KWin::EffectWindow*>>();
@@ -136,6 +137,8 @@ EffectsHandlerImpl::EffectsHandlerImpl(Compositor *compositor, Scene *scene)
         }
     );
     m_effectLoader->setConfig(kwinApp()->config());
+    // effects only activated on user request are loaded once the first frame is on screen
+    m_effectLoader->setDeferredEffectsHeld(m_deferredEffectsHeld);
     new EffectsAdaptor(this);
     QDBusConnection dbus = QDBusConnection::sessionBus();
     dbus.registerObject(QStringLiteral("/Effects"), this);
@@ -269,6 +272,7 @@ EffectsHandlerImpl::EffectsHandlerImpl(Compositor *compositor, Scene *scene)
 EffectsHandlerImpl::~EffectsHandlerImpl()
 {
     unloadAllEffects();
+    destroyScreenCaptures();
 }
 
 void EffectsHandlerImpl::unloadAllEffects()
@@ -390,10 +394,16 @@ void EffectsHandlerImpl::prePaintScreen(ScreenPrePaintData& data, int time)
 void EffectsHandlerImpl::paintScreen(int mask, QRegion region, ScreenPaintData& data)
 {
     if (m_currentPaintScreenIterator != m_activeEffects.constEnd()) {
-        (*m_currentPaintScreenIterator++)->paintScreen(mask, region, data);
+        Effect *effect = *m_currentPaintScreenIterator++;
+        GLProfilerScope profile(GLProfiler::isEnabled() ? profiledPassName(effect, "paintScreen") : QString());
+        effect->paintScreen(mask, region, data);
         --m_currentPaintScreenIterator;
-    } else
+    } else {
         m_scene->finalPaintScreen(mask, region, data);
+        if (!m_screenCaptureEffects.isEmpty() && !m_desktopRendering) {
+            updateScreenCapture();
+        }
+    }
 }
 
 void EffectsHandlerImpl::paintDesktop(int desktop, int mask, QRegion region, ScreenPaintData &data)
@@ -417,8 +427,22 @@ void EffectsHandlerImpl::postPaintScreen()
     if (m_currentPaintScreenIterator != m_activeEffects.constEnd()) {
         (*m_currentPaintScreenIterator++)->postPaintScreen();
         --m_currentPaintScreenIterator;
+    } else {
+        if (m_deferredEffectsHeld) {
+            // the loader only schedules the effects, they get loaded after this paint pass
+            m_deferredEffectsHeld = false;
+            m_effectLoader->setDeferredEffectsHeld(false);
+        }
+        if (!m_screenCaptureEffects.isEmpty()) {
+            // an effect did not let the scene paint the screen, so the capture missed
+            // this frame and has to be refreshed completely
+            ScreenCapture *capture = findScreenCapture(GLRenderTarget::virtualScreenGeometry());
+            if (capture && !capture->updated && capture->valid) {
+                capture->valid = false;
+                addRepaintFull();
+            }
+        }
     }
-    // no special final code
 }
 
 void EffectsHandlerImpl::prePaintWindow(EffectWindow* w, WindowPrePaintData& data, int time)
@@ -433,7 +457,9 @@ void EffectsHandlerImpl::prePaintWindow(EffectWindow* w, WindowPrePaintData& dat
 void EffectsHandlerImpl::paintWindow(EffectWindow* w, int mask, QRegion region, WindowPaintData& data)
 {
     if (m_currentPaintWindowIterator != m_activeEffects.constEnd()) {
-        (*m_currentPaintWindowIterator++)->paintWindow(w, mask, region, data);
+        Effect *effect = *m_currentPaintWindowIterator++;
+        GLProfilerScope profile(GLProfiler::isEnabled() ? profiledPassName(effect, "paintWindow") : QString());
+        effect->paintWindow(w, mask, region, data);
         --m_currentPaintWindowIterator;
     } else
         m_scene->finalPaintWindow(static_cast<EffectWindowImpl*>(w), mask, region, data);
@@ -470,12 +496,25 @@ Effect *EffectsHandlerImpl::provides(Effect::Feature ef)
 void EffectsHandlerImpl::drawWindow(EffectWindow* w, int mask, QRegion region, WindowPaintData& data)
 {
     if (m_currentDrawWindowIterator != m_activeEffects.constEnd()) {
-        (*m_currentDrawWindowIterator++)->drawWindow(w, mask, region, data);
+        Effect *effect = *m_currentDrawWindowIterator++;
+        GLProfilerScope profile(GLProfiler::isEnabled() ? profiledPassName(effect, "drawWindow") : QString());
+        effect->drawWindow(w, mask, region, data);
         --m_currentDrawWindowIterator;
     } else
         m_scene->finalDrawWindow(static_cast<EffectWindowImpl*>(w), mask, region, data);
 }
 
+QString EffectsHandlerImpl::profiledPassName(const Effect *effect, const char *pass) const
+{
+    auto it = std::find_if(loaded_effects.constBegin(), loaded_effects.constEnd(),
+        [effect](const EffectPair &pair) {
+            return pair.second == effect;
+        }
+    );
+    const QString name = it != loaded_effects.constEnd() ? it->first : QString::fromLatin1(effect->metaObject()->className());
+    return name + QLatin1Char(':') + QLatin1String(pass);
+}
+
 void EffectsHandlerImpl::buildQuads(EffectWindow* w, WindowQuadList& quadList)
 {
     static bool initIterator = true;
@@ -520,6 +559,9 @@ void EffectsHandlerImpl::startPaint()
     m_currentPaintWindowIterator = m_activeEffects.constBegin();
     m_currentPaintScreenIterator = m_activeEffects.constBegin();
     m_currentPaintEffectFrameIterator = m_activeEffects.constBegin();
+    if (ScreenCapture *capture = findScreenCapture(GLRenderTarget::virtualScreenGeometry())) {
+        capture->updated = false;
+    }
 }
 
 void EffectsHandlerImpl::slotClientMaximized(KWin::AbstractClient *c, MaximizeMode maxMode)
@@ -1374,6 +1416,114 @@ QPainter *EffectsHandlerImpl::scenePainter()
     return m_scene->scenePainter();
 }
 
+void EffectsHandlerImpl::reserveScreenCapture(Effect *effect)
+{
+    if (m_screenCaptureEffects.contains(effect)) {
+        return;
+    }
+    m_screenCaptureEffects.append(effect);
+    if (m_screenCaptureEffects.count() == 1) {
+        // the capture needs one completely painted frame to be usable
+        addRepaintFull();
+    }
+}
+
+void EffectsHandlerImpl::unreserveScreenCapture(Effect *effect)
+{
+    if (!m_screenCaptureEffects.removeOne(effect)) {
+        return;
+    }
+    if (m_screenCaptureEffects.isEmpty()) {
+        destroyScreenCaptures();
+    }
+}
+
+GLTexture *EffectsHandlerImpl::screenCaptureTexture() const
+{
+    const ScreenCapture *capture = findScreenCapture(GLRenderTarget::virtualScreenGeometry());
+    if (!capture || !capture->valid) {
+        return nullptr;
+    }
+    return capture->texture;
+}
+
+EffectsHandlerImpl::ScreenCapture *EffectsHandlerImpl::findScreenCapture(const QRect &geometry)
+{
+    auto it = std::find_if(m_screenCaptures.begin(), m_screenCaptures.end(),
+        [&geometry] (const ScreenCapture &capture) {
+            return capture.geometry == geometry;
+        }
+    );
+    return it != m_screenCaptures.end() ? &(*it) : nullptr;
+}
+
+const EffectsHandlerImpl::ScreenCapture *EffectsHandlerImpl::findScreenCapture(const QRect &geometry) const
+{
+    return const_cast<EffectsHandlerImpl*>(this)->findScreenCapture(geometry);
+}
+
+void EffectsHandlerImpl::updateScreenCapture()
+{
+    if (!isOpenGLCompositing() || !GLRenderTarget::blitSupported()) {
+        return;
+    }
+    if (GLRenderTarget::isRenderTargetBound()) {
+        // an effect redirected the rendering, the screen is not in the back buffer
+        return;
+    }
+    const QRect geometry = GLRenderTarget::virtualScreenGeometry();
+    const qreal scale = GLRenderTarget::virtualScreenScale();
+    const QSize size = geometry.size() * scale;
+
+    ScreenCapture *capture = findScreenCapture(geometry);
+    if (!capture) {
+        ScreenCapture newCapture;
+        newCapture.geometry = geometry;
+        m_screenCaptures.append(newCapture);
+        capture = &m_screenCaptures.last();
+    }
+    if (!capture->texture || capture->texture->size() != size) {
+        delete capture->renderTarget;
+        delete capture->texture;
+        capture->texture = new GLTexture(GL_RGBA8, size);
+        capture->texture->setFilter(GL_LINEAR);
+        capture->texture->setWrapMode(GL_CLAMP_TO_EDGE);
+        capture->renderTarget = new GLRenderTarget(*capture->texture);
+        capture->valid = false;
+    }
+    if (!capture->renderTarget->valid()) {
+        return;
+    }
+
+    // Only the repainted areas changed, everything else in the capture is still up to date
+    const QRegion painted = m_scene->paintedRegion() & geometry;
+    if (!capture->valid) {
+        if (painted != QRegion(geometry)) {
+            // parts of the output were not repainted in this frame, their content in
+            // the back buffer is not necessarily up to date
+            addRepaintFull();
+            return;
+        }
+        capture->valid = true;
+    }
+    for (const QRect &rect : painted) {
+        const QRect target((rect.x() - geometry.x()) * scale, (rect.y() - geometry.y()) * scale,
+                           rect.width() * scale, rect.height() * scale);
+        capture->renderTarget->blitFromFramebuffer(rect, target, GL_NEAREST);
+    }
+    capture->updated = true;
+}
+
+void EffectsHandlerImpl::destroyScreenCaptures()
+{
+    makeOpenGLContextCurrent();
+    for (const ScreenCapture &capture : qAsConst(m_screenCaptures)) {
+        delete capture.renderTarget;
+        delete capture.texture;
+    }
+    m_screenCaptures.clear();
+}
+
 void EffectsHandlerImpl::toggleEffect(const QString& name)
 {
     if (isEffectLoaded(name))
@@ -1438,6 +1588,7 @@ void EffectsHandlerImpl::destroyEffect(Effect *effect)
     }
 
     stopMouseInterception(effect);
+    unreserveScreenCapture(effect);
 
     const QList<QByteArray> properties = m_propertiesForEffects.keys();
     for (const QByteArray &property : properties) {
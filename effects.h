@@ -59,6 +59,7 @@ class Client;
 class Compositor;
 class Deleted;
 class EffectLoader;
+class GLRenderTarget;
 class Toplevel;
 class Unmanaged;
 class WindowPropertyNotifyX11Filter;
@@ -181,6 +182,9 @@ public:
 
     unsigned long xrenderBufferPicture() override;
     QPainter* scenePainter() override;
+    void reserveScreenCapture(Effect *effect) override;
+    void unreserveScreenCapture(Effect *effect) override;
+    GLTexture *screenCaptureTexture() const override;
     void reconfigure() override;
     QByteArray readRootProperty(long atom, long type, int format) const override;
     xcb_atom_t announceSupportProperty(const QByteArray& propertyName, Effect* effect) override;
@@ -343,6 +347,28 @@ protected:
 private:
     void registerPropertyType(long atom, bool reg);
     void destroyEffect(Effect *effect);
+    /**
+     * The name under which the GLProfiler records @p pass of @p effect.
+     */
+    QString profiledPassName(const Effect *effect, const char *pass) const;
+
+    struct ScreenCapture {
+        QRect geometry;
+        GLTexture *texture = nullptr;
+        GLRenderTarget *renderTarget = nullptr;
+        /**
+         * Whether the texture holds the complete content of the output.
+         */
+        bool valid = false;
+        /**
+         * Whether the capture got updated since the current frame started.
+         */
+        bool updated = false;
+    };
+    ScreenCapture *findScreenCapture(const QRect &geometry);
+    const ScreenCapture *findScreenCapture(const QRect &geometry) const;
+    void updateScreenCapture();
+    void destroyScreenCaptures();
 
     typedef QVector< Effect*> EffectsList;
     typedef EffectsList::const_iterator EffectsIterator;
@@ -361,8 +387,11 @@ private:
     int m_currentRenderedDesktop;
     QList<Effect*> m_grabbedMouseEffects;
     EffectLoader *m_effectLoader;
+    bool m_deferredEffectsHeld;
     int m_trackingCursorChanges;
     std::unique_ptr<WindowPropertyNotifyX11Filter> m_x11WindowPropertyNotify;
+    QList<Effect*> m_screenCaptureEffects;
+    QVector<ScreenCapture> m_screenCaptures;
 };
 
 class EffectWindowImpl : public EffectWindow
@@ -153,6 +153,7 @@ void BlurEffect::updateTexture()
 
     for (int i = 0; i <= m_downSampleIterations; i++) {
         m_renderTextures.append(GLTexture(textureFormat, effects->virtualScreenSize() / (1 << i)));
+        m_renderTextures.last().setMemoryCategory(GLTexture::MemoryCategory::Effect);
         m_renderTextures.last().setFilter(GL_LINEAR);
         m_renderTextures.last().setWrapMode(GL_CLAMP_TO_EDGE);
 
@@ -161,6 +162,7 @@ void BlurEffect::updateTexture()
 
     // This last set is used as a temporary helper texture
     m_renderTextures.append(GLTexture(textureFormat, effects->virtualScreenSize()));
+    m_renderTextures.last().setMemoryCategory(GLTexture::MemoryCategory::Effect);
     m_renderTextures.last().setFilter(GL_LINEAR);
     m_renderTextures.last().setWrapMode(GL_CLAMP_TO_EDGE);
 
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "desktopgrid.h"
 // KConfigSkeleton
 #include "desktopgridconfig.h"
+#include "desktopsnapshots.h"
 
 #include "../presentwindows/presentwindows_proxy.h"
 #include "../effect_builtins.h"
@@ -41,7 +42,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QQuickItem>
 
 #include <KWayland/Server/surface_interface.h>
+#include <kwinglutils.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace KWin
@@ -188,6 +191,9 @@ void DesktopGridEffect::paintScreen(int mask, QRegion region, ScreenPaintData& d
         return;
     }
     for (int desktop = 1; desktop <= effects->numberOfDesktops(); desktop++) {
+        if (paintSnapshot(desktop, region, data)) {
+            continue;
+        }
         ScreenPaintData d = data;
         paintingDesktop = desktop;
         effects->paintScreen(mask, region, d);
@@ -250,6 +256,45 @@ void DesktopGridEffect::paintScreen(int mask, QRegion region, ScreenPaintData& d
     }
 }
 
+bool DesktopGridEffect::paintSnapshot(int desktop, const QRegion &region, const ScreenPaintData &data)
+{
+    // only the settled grid is painted from snapshots, the zoom animation and
+    // the current desktop stay live
+    if (!m_snapshots || timeline.currentValue() != 1.0 || desktop == effects->currentDesktop()) {
+        return false;
+    }
+    if (windowMove && windowMove->isOnDesktop(desktop)) {
+        return false;
+    }
+    QVector<GLTexture*> textures;
+    for (int screen = 0; screen < effects->numScreens(); screen++) {
+        GLTexture *texture = m_snapshots->snapshot(desktop, screen, scaledSize[screen].toSize());
+        if (!texture) {
+            return false;
+        }
+        textures << texture;
+    }
+
+    const float brightness = 1.0 - (0.3 * (1.0 - hoverTimeline[desktop - 1]->currentValue()));
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    ShaderBinder binder(ShaderTrait::MapTexture | ShaderTrait::Modulate);
+    binder.shader()->setUniform(GLShader::ModulationConstant, QVector4D(brightness, brightness, brightness, 1.0));
+    for (int screen = 0; screen < effects->numScreens(); screen++) {
+        const QRect screenGeom = effects->clientArea(ScreenArea, screen, 0);
+        const QPointF pos = scalePos(screenGeom.topLeft(), desktop, screen);
+        const QRect rect(qRound(pos.x()), qRound(pos.y()), textures[screen]->width(), textures[screen]->height());
+        QMatrix4x4 mvp = data.projectionMatrix();
+        mvp.translate(rect.x(), rect.y());
+        binder.shader()->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+        textures[screen]->bind();
+        textures[screen]->render(region, rect);
+        textures[screen]->unbind();
+    }
+    glDisable(GL_BLEND);
+    return true;
+}
+
 void DesktopGridEffect::postPaintScreen()
 {
     if (activated ? timeline.currentValue() != 1 : timeline.currentValue() != 0)
@@ -1110,6 +1155,20 @@ void DesktopGridEffect::setup()
     // setup the motion managers
     if (m_usePresentWindows)
         m_proxy = static_cast<PresentWindowsEffectProxy*>(effects->getProxy(BuiltInEffects::nameForEffect(BuiltInEffect::PresentWindows)));
+    if (isUsingPresentWindows() || !effects->isOpenGLCompositing() || !GLRenderTarget::supported()) {
+        m_snapshots.reset();
+    } else if (!m_snapshots) {
+        // desktops which don't change are painted from cached snapshots
+        m_snapshots.reset(new DesktopSnapshots(
+            [this](EffectWindow *w) {
+                return std::none_of(m_desktopButtonsViews.constBegin(), m_desktopButtonsViews.constEnd(),
+                    [w](DesktopButtonsView *view) {
+                        return view->effectWindow == w;
+                    }
+                );
+            }
+        ));
+    }
     if (isUsingPresentWindows()) {
         m_proxy->reCreateGrids(); // revalidation on multiscreen, bug #351724
         for (int i = 1; i <= effects->numberOfDesktops(); i++) {
@@ -1224,6 +1283,7 @@ void DesktopGridEffect::finish()
     keyboardGrab = false;
     effects->stopMouseInterception(this);
     effects->setActiveFullScreenEffect(nullptr);
+    m_snapshots.reset();
     if (isUsingPresentWindows()) {
         while (!m_managers.isEmpty()) {
             m_managers.first().unmanageAll();
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace KWin
 {
 
+class DesktopSnapshots;
 class PresentWindowsEffectProxy;
 
 class DesktopButtonsView : public QQuickView
@@ -139,6 +140,7 @@ private:
     void desktopsAdded(int old);
     void desktopsRemoved(int old);
     QVector<int> desktopList(const EffectWindow *w) const;
+    bool paintSnapshot(int desktop, const QRegion &region, const ScreenPaintData &data);
 
     QList<ElectricBorder> borderActivate;
     int zoomDuration;
@@ -183,6 +185,7 @@ private:
     QPoint m_windowMoveStartPoint;
 
     QVector<DesktopButtonsView*> m_desktopButtonsViews;
+    QScopedPointer<DesktopSnapshots> m_snapshots;
 
     QAction *m_activateAction;
 
@@ -0,0 +1,165 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "desktopsnapshots.h"
+
+#include <kwinglutils.h>
+
+namespace KWin
+{
+
+DesktopSnapshots::DesktopSnapshots(std::function<bool(EffectWindow*)> filter, QObject *parent)
+    : QObject(parent)
+    , m_filter(filter)
+{
+    connect(effects, &EffectsHandler::windowAdded, this, &DesktopSnapshots::invalidateWindow);
+    connect(effects, &EffectsHandler::windowClosed, this, &DesktopSnapshots::invalidateWindow);
+    connect(effects, &EffectsHandler::windowDeleted, this, &DesktopSnapshots::invalidateWindow);
+    connect(effects, &EffectsHandler::windowMinimized, this, &DesktopSnapshots::invalidateWindow);
+    connect(effects, &EffectsHandler::windowUnminimized, this, &DesktopSnapshots::invalidateWindow);
+    connect(effects, &EffectsHandler::windowDamaged, this,
+        [this](EffectWindow *w) {
+            invalidateWindow(w);
+        }
+    );
+    connect(effects, &EffectsHandler::windowGeometryShapeChanged, this,
+        [this](EffectWindow *w) {
+            invalidateWindow(w);
+        }
+    );
+    connect(effects, &EffectsHandler::windowOpacityChanged, this,
+        [this](EffectWindow *w) {
+            invalidateWindow(w);
+        }
+    );
+    connect(effects, &EffectsHandler::desktopPresenceChanged, this,
+        [this](EffectWindow *w, int oldDesktop) {
+            if (oldDesktop == NET::OnAllDesktops) {
+                invalidateAll();
+            } else {
+                invalidate(oldDesktop);
+                invalidateWindow(w);
+            }
+        }
+    );
+    // restacking doesn't tell which desktops are affected
+    connect(effects, &EffectsHandler::stackingOrderChanged, this, &DesktopSnapshots::invalidateAll);
+    connect(effects, &EffectsHandler::numberDesktopsChanged, this, &DesktopSnapshots::clear);
+    connect(effects, &EffectsHandler::virtualScreenGeometryChanged, this, &DesktopSnapshots::clear);
+}
+
+DesktopSnapshots::~DesktopSnapshots()
+{
+    effects->makeOpenGLContextCurrent();
+    m_snapshots.clear();
+}
+
+GLTexture *DesktopSnapshots::snapshot(int desktop, int screen, const QSize &size)
+{
+    if (size.isEmpty()) {
+        return nullptr;
+    }
+    Snapshot &snapshot = m_snapshots[qMakePair(desktop, screen)];
+    if (!snapshot.texture || snapshot.texture->size() != size) {
+        snapshot.renderTarget.reset();
+        snapshot.texture.reset(new GLTexture(GL_RGBA8, size));
+        snapshot.texture->setFilter(GL_LINEAR);
+        snapshot.texture->setWrapMode(GL_CLAMP_TO_EDGE);
+        // the render target draws into the texture and has no storage of its own
+        snapshot.texture->setMemoryCategory(GLTexture::MemoryCategory::Effect);
+        snapshot.renderTarget.reset(new GLRenderTarget(*snapshot.texture));
+        snapshot.valid = false;
+    }
+    if (!snapshot.renderTarget->valid()) {
+        return nullptr;
+    }
+    if (!snapshot.valid) {
+        render(snapshot, desktop, screen);
+    }
+    return snapshot.texture.data();
+}
+
+void DesktopSnapshots::render(Snapshot &snapshot, int desktop, int screen)
+{
+    const QRect screenGeom = effects->clientArea(ScreenArea, screen, 0);
+    // the windows get scaled down to the size of the snapshot
+    QMatrix4x4 projection;
+    projection.ortho(screenGeom);
+
+    GLRenderTarget::pushRenderTarget(snapshot.renderTarget.data());
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(0.0, 0.0, 0.0, 1.0);
+
+    const EffectWindowList windows = effects->stackingOrder();
+    for (EffectWindow *w : windows) {
+        if (!w->isOnDesktop(desktop) || w->isMinimized() || w->isDeleted() || !w->isOnCurrentActivity()) {
+            continue;
+        }
+        if (!w->geometry().intersects(screenGeom) || !m_filter(w)) {
+            continue;
+        }
+        WindowPaintData d(w);
+        d.setProjectionMatrix(projection);
+        effects->drawWindow(w, PAINT_WINDOW_TRANSFORMED | PAINT_WINDOW_TRANSLUCENT, infiniteRegion(), d);
+    }
+
+    GLRenderTarget::popRenderTarget();
+    snapshot.valid = true;
+}
+
+bool DesktopSnapshots::isValid(int desktop, int screen) const
+{
+    const auto it = m_snapshots.constFind(qMakePair(desktop, screen));
+    return it != m_snapshots.constEnd() && it->valid;
+}
+
+void DesktopSnapshots::invalidate(int desktop)
+{
+    for (auto it = m_snapshots.begin(); it != m_snapshots.end(); ++it) {
+        if (it.key().first == desktop) {
+            it->valid = false;
+        }
+    }
+}
+
+void DesktopSnapshots::invalidateWindow(EffectWindow *w)
+{
+    if (w->isOnAllDesktops()) {
+        invalidateAll();
+        return;
+    }
+    const auto desktops = w->desktops();
+    for (uint desktop : desktops) {
+        invalidate(desktop);
+    }
+}
+
+void DesktopSnapshots::invalidateAll()
+{
+    for (auto it = m_snapshots.begin(); it != m_snapshots.end(); ++it) {
+        it->valid = false;
+    }
+}
+
+void DesktopSnapshots::clear()
+{
+    effects->makeOpenGLContextCurrent();
+    m_snapshots.clear();
+}
+
+}
@@ -0,0 +1,93 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+
+#ifndef KWIN_DESKTOPSNAPSHOTS_H
+#define KWIN_DESKTOPSNAPSHOTS_H
+
+#include <kwineffects.h>
+
+#include <QHash>
+#include <QPair>
+#include <QSharedPointer>
+
+#include <functional>
+
+namespace KWin
+{
+
+class GLRenderTarget;
+class GLTexture;
+
+/**
+ * Caches the content of each screen of a virtual desktop in a texture.
+ *
+ * A snapshot is rendered on first use and reused until a window on its desktop
+ * gets damaged, moved, restacked or changes its desktops. Effects showing many
+ * desktops at once can paint the snapshots of the desktops which don't change
+ * instead of painting all their windows each frame.
+ *
+ * Requires OpenGL compositing with render target support.
+ */
+class DesktopSnapshots : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @p filter decides whether a window on the desktop is part of the snapshot.
+     */
+    explicit DesktopSnapshots(std::function<bool(EffectWindow*)> filter, QObject *parent = nullptr);
+    ~DesktopSnapshots() override;
+
+    /**
+     * The snapshot of @p screen on @p desktop scaled to @p size. The snapshot gets
+     * rendered if it is outdated or has a different size. Returns @c nullptr if the
+     * snapshot can't be rendered.
+     */
+    GLTexture *snapshot(int desktop, int screen, const QSize &size);
+
+    /**
+     * Whether the snapshot of @p screen on @p desktop exists and is up to date.
+     */
+    bool isValid(int desktop, int screen) const;
+    /**
+     * Marks the snapshots of @p desktop as outdated.
+     */
+    void invalidate(int desktop);
+    /**
+     * Releases all snapshots.
+     */
+    void clear();
+
+private:
+    struct Snapshot {
+        QSharedPointer<GLTexture> texture;
+        QSharedPointer<GLRenderTarget> renderTarget;
+        bool valid = false;
+    };
+    void invalidateWindow(EffectWindow *w);
+    void invalidateAll();
+    void render(Snapshot &snapshot, int desktop, int screen);
+
+    std::function<bool(EffectWindow*)> m_filter;
+    // keyed by desktop and screen
+    QHash<QPair<int, int>, Snapshot> m_snapshots;
+};
+
+}
+
+#endif
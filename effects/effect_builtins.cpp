@@ -95,6 +95,7 @@ static const QVector<EffectData> &effectData()
         QUrl(),
         false,
         false,
+        false,
         nullptr,
         nullptr,
         nullptr
@@ -107,6 +108,7 @@ static const QVector<EffectData> &effectData()
         QUrl(),
         true,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<BlurEffect>,
         &BlurEffect::supported,
@@ -122,6 +124,7 @@ EFFECT_FALLBACK
         QUrl(),
         true,
         true,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<ColorPickerEffect>,
         &ColorPickerEffect::supported,
@@ -137,6 +140,7 @@ EFFECT_FALLBACK
         QUrl(),
         true,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<ContrastEffect>,
         &ContrastEffect::supported,
@@ -152,6 +156,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/cover_switch.mp4")),
         false,
         true,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<CoverSwitchEffect>,
         &CoverSwitchEffect::supported,
@@ -167,6 +172,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/desktop_cube.ogv")),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<CubeEffect>,
         &CubeEffect::supported,
@@ -182,6 +188,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/desktop_cube_animation.ogv")),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<CubeSlideEffect>,
         &CubeSlideEffect::supported,
@@ -197,6 +204,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/desktop_grid.mp4")),
         true,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<DesktopGridEffect>,
         nullptr,
@@ -212,6 +220,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/dim_inactive.mp4")),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<DimInactiveEffect>,
         nullptr,
@@ -227,6 +236,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<FallApartEffect>,
         &FallApartEffect::supported,
@@ -242,6 +252,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/flip_switch.mp4")),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<FlipSwitchEffect>,
         &FlipSwitchEffect::supported,
@@ -257,6 +268,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<GlideEffect>,
         &GlideEffect::supported,
@@ -272,6 +284,7 @@ EFFECT_FALLBACK
         QUrl(),
         true,
         true,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<HighlightWindowEffect>,
         nullptr,
@@ -287,6 +300,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<ICCEffect>,
         &ICCEffect::supported,
@@ -302,6 +316,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/invert.mp4")),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<InvertEffect>,
         &InvertEffect::supported,
@@ -317,6 +332,7 @@ EFFECT_FALLBACK
         QUrl(),
         true,
         true,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<KscreenEffect>,
         nullptr,
@@ -332,6 +348,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/looking_glass.ogv")),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<LookingGlassEffect>,
         &LookingGlassEffect::supported,
@@ -347,6 +364,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/magic_lamp.ogv")),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<MagicLampEffect>,
         &MagicLampEffect::supported,
@@ -362,6 +380,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/magnifier.ogv")),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<MagnifierEffect>,
         &MagnifierEffect::supported,
@@ -377,6 +396,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/mouse_click.mp4")),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<MouseClickEffect>,
         nullptr,
@@ -392,6 +412,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<MouseMarkEffect>,
         nullptr,
@@ -407,6 +428,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/present_windows.mp4")),
         true,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<PresentWindowsEffect>,
         nullptr,
@@ -422,6 +444,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<ResizeEffect>,
         nullptr,
@@ -437,6 +460,7 @@ EFFECT_FALLBACK
         QUrl(),
         true,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<ScreenEdgeEffect>,
         nullptr,
@@ -452,6 +476,7 @@ EFFECT_FALLBACK
         QUrl(),
         true,
         true,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<ScreenShotEffect>,
         &ScreenShotEffect::supported,
@@ -467,6 +492,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<SheetEffect>,
         &SheetEffect::supported,
@@ -482,6 +508,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<ShowFpsEffect>,
         nullptr,
@@ -497,6 +524,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<ShowPaintEffect>,
         nullptr,
@@ -512,6 +540,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/slide.ogv")),
         true,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<SlideEffect>,
         &SlideEffect::supported,
@@ -527,6 +556,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<SlideBackEffect>,
         nullptr,
@@ -542,6 +572,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/sliding_popups.mp4")),
         true,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<SlidingPopupsEffect>,
         &SlidingPopupsEffect::supported,
@@ -557,6 +588,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/snap_helper.mp4")),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<SnapHelperEffect>,
         nullptr,
@@ -572,6 +604,7 @@ EFFECT_FALLBACK
         QUrl(),
         true,
         true,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<StartupFeedbackEffect>,
         &StartupFeedbackEffect::supported,
@@ -587,6 +620,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<ThumbnailAsideEffect>,
         nullptr,
@@ -602,6 +636,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<TouchPointsEffect>,
         nullptr,
@@ -617,6 +652,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/track_mouse.mp4")),
         false,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<TrackMouseEffect>,
         nullptr,
@@ -632,6 +668,7 @@ EFFECT_FALLBACK
         QUrl(),
         false,
         true,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<WindowGeometry>,
         nullptr,
@@ -647,6 +684,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/wobbly_windows.ogv")),
         false,
         false,
+        false,
 #ifdef EFFECT_BUILTINS
         &createHelper<WobblyWindowsEffect>,
         &WobblyWindowsEffect::supported,
@@ -662,6 +700,7 @@ EFFECT_FALLBACK
         QUrl(QStringLiteral("https://files.kde.org/plasma/kwin/effect-videos/zoom.ogv")),
         true,
         false,
+        true,
 #ifdef EFFECT_BUILTINS
         &createHelper<ZoomEffect>,
         nullptr,
@@ -86,6 +86,11 @@ struct EffectData {
     QUrl video;
     bool enabled;
     bool internal;
+    /**
+     * The effect is only activated on explicit user request, e.g. through a shortcut,
+     * and doesn't need to be loaded before the compositor presents the first frame.
+     */
+    bool deferred;
     std::function<Effect*()> createFunction;
     std::function<bool()> supportedFunction;
     std::function<bool()> enabledFunction;
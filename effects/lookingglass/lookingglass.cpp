@@ -36,8 +36,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <kmessagebox.h>
 
-#include <cmath>
-
 namespace KWin
 {
 
@@ -45,9 +43,6 @@ LookingGlassEffect::LookingGlassEffect()
     : zoom(1.0f)
     , target_zoom(1.0f)
     , polling(false)
-    , m_texture(nullptr)
-    , m_fbo(nullptr)
-    , m_vbo(nullptr)
     , m_shader(nullptr)
     , m_enabled(false)
     , m_valid(false)
@@ -76,15 +71,13 @@ LookingGlassEffect::LookingGlassEffect()
 
 LookingGlassEffect::~LookingGlassEffect()
 {
-    delete m_texture;
-    delete m_fbo;
     delete m_shader;
-    delete m_vbo;
 }
 
 bool LookingGlassEffect::supported()
 {
-    return effects->compositingType() == OpenGL2Compositing && !GLPlatform::instance()->supports(LimitedNPOT);
+    return effects->compositingType() == OpenGL2Compositing && !GLPlatform::instance()->supports(LimitedNPOT)
+        && GLRenderTarget::blitSupported();
 }
 
 void LookingGlassEffect::reconfigure(ReconfigureFlags)
@@ -98,49 +91,31 @@ void LookingGlassEffect::reconfigure(ReconfigureFlags)
 
 bool LookingGlassEffect::loadData()
 {
-    const QSize screenSize = effects->virtualScreenSize();
-    int texw = screenSize.width();
-    int texh = screenSize.height();
-
-    // Create texture and render target
-    const int levels = std::log2(qMin(texw, texh)) + 1;
-    m_texture = new GLTexture(GL_RGBA8, texw, texh, levels);
-    m_texture->setFilter(GL_LINEAR_MIPMAP_LINEAR);
-    m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
-
-    m_fbo = new GLRenderTarget(*m_texture);
-    if (!m_fbo->valid()) {
-        return false;
-    }
-
+    delete m_shader;
     m_shader = ShaderManager::instance()->generateShaderFromResources(ShaderTrait::MapTexture, QString(), QStringLiteral("lookingglass.frag"));
-    if (m_shader->isValid()) {
-        ShaderBinder binder(m_shader);
-        m_shader->setUniform("u_textureSize", QVector2D(screenSize.width(), screenSize.height()));
-    } else {
+    if (!m_shader->isValid()) {
         qCCritical(KWINEFFECTS) << "The shader failed to load!";
         return false;
     }
-
-    m_vbo = new GLVertexBuffer(GLVertexBuffer::Static);
-    QVector<float> verts;
-    QVector<float> texcoords;
-    texcoords << screenSize.width() << 0.0;
-    verts << screenSize.width() << 0.0;
-    texcoords << 0.0 << 0.0;
-    verts << 0.0 << 0.0;
-    texcoords << 0.0 << screenSize.height();
-    verts << 0.0 << screenSize.height();
-    texcoords << 0.0 << screenSize.height();
-    verts << 0.0 << screenSize.height();
-    texcoords << screenSize.width() << screenSize.height();
-    verts << screenSize.width() << screenSize.height();
-    texcoords << screenSize.width() << 0.0;
-    verts << screenSize.width() << 0.0;
-    m_vbo->setData(6, 2, verts.constData(), texcoords.constData());
     return true;
 }
 
+QRect LookingGlassEffect::lensArea() const
+{
+    const QPoint cursor = cursorPos();
+    return QRect(cursor.x() - radius, cursor.y() - radius, 2 * radius, 2 * radius);
+}
+
+void LookingGlassEffect::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (m_enabled) {
+        effects->reserveScreenCapture(this);
+    } else {
+        effects->unreserveScreenCapture(this);
+    }
+}
+
 void LookingGlassEffect::toggle()
 {
     if (target_zoom == 1.0f) {
@@ -149,7 +124,7 @@ void LookingGlassEffect::toggle()
             polling = true;
             effects->startMousePolling();
         }
-        m_enabled = true;
+        setEnabled(true);
     } else {
         target_zoom = 1.0f;
         if (polling) {
@@ -157,7 +132,7 @@ void LookingGlassEffect::toggle()
             effects->stopMousePolling();
         }
         if (zoom == target_zoom) {
-            m_enabled = false;
+            setEnabled(false);
         }
     }
     effects->addRepaint(cursorPos().x() - radius, cursorPos().y() - radius, 2 * radius, 2 * radius);
@@ -166,7 +141,7 @@ void LookingGlassEffect::toggle()
 void LookingGlassEffect::zoomIn()
 {
     target_zoom = qMin(7.0, target_zoom + 0.5);
-    m_enabled = true;
+    setEnabled(true);
     if (!polling) {
         polling = true;
         effects->startMousePolling();
@@ -184,7 +159,7 @@ void LookingGlassEffect::zoomOut()
             effects->stopMousePolling();
         }
         if (zoom == target_zoom) {
-            m_enabled = false;
+            setEnabled(false);
         }
     }
     effects->addRepaint(cursorPos().x() - radius, cursorPos().y() - radius, 2 * radius, 2 * radius);
@@ -202,18 +177,17 @@ void LookingGlassEffect::prePaintScreen(ScreenPrePaintData& data, int time)
         radius = qBound((double)initialradius, initialradius * zoom, 3.5 * initialradius);
 
         if (zoom <= 1.0f) {
-            m_enabled = false;
+            setEnabled(false);
         }
 
         effects->addRepaint(cursorPos().x() - radius, cursorPos().y() - radius, 2 * radius, 2 * radius);
     }
+    effects->prePaintScreen(data, time);
+
     if (m_valid && m_enabled) {
-        data.mask |= PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS;
-        // Start rendering to texture
-        GLRenderTarget::pushRenderTarget(m_fbo);
+        // the lens is drawn from the captured screen, make sure it's up to date below the lens
+        data.paint |= lensArea();
     }
-
-    effects->prePaintScreen(data, time);
 }
 
 void LookingGlassEffect::slotMouseChanged(const QPoint& pos, const QPoint& old, Qt::MouseButtons,
@@ -229,23 +203,43 @@ void LookingGlassEffect::paintScreen(int mask, QRegion region, ScreenPaintData &
 {
     // Call the next effect.
     effects->paintScreen(mask, region, data);
-    if (m_valid && m_enabled) {
-        // Disable render texture
-        GLRenderTarget* target = GLRenderTarget::popRenderTarget();
-        Q_ASSERT(target == m_fbo);
-        Q_UNUSED(target);
-        m_texture->bind();
-        m_texture->generateMipmaps();
-
-        // Use the shader
-        ShaderBinder binder(m_shader);
-        m_shader->setUniform("u_zoom", (float)zoom);
-        m_shader->setUniform("u_radius", (float)radius);
-        m_shader->setUniform("u_cursor", QVector2D(cursorPos().x(), cursorPos().y()));
-        m_shader->setUniform(GLShader::ModelViewProjectionMatrix, data.projectionMatrix());
-        m_vbo->render(GL_TRIANGLES);
-        m_texture->unbind();
+    if (!m_valid || !m_enabled) {
+        return;
+    }
+    GLTexture *capture = effects->screenCaptureTexture();
+    if (!capture) {
+        return;
+    }
+    // Only the lens distorts the screen, everything outside of it is already painted.
+    // Texture coordinates are relative to the output the capture belongs to.
+    const QRect geometry = GLRenderTarget::virtualScreenGeometry();
+    const QRect area = lensArea();
+    const float verts[] = {
+        float(area.x() + area.width()), float(area.y()),
+        float(area.x()), float(area.y()),
+        float(area.x()), float(area.y() + area.height()),
+        float(area.x()), float(area.y() + area.height()),
+        float(area.x() + area.width()), float(area.y() + area.height()),
+        float(area.x() + area.width()), float(area.y())
+    };
+    float texcoords[12];
+    for (int i = 0; i < 12; i += 2) {
+        texcoords[i] = verts[i] - geometry.x();
+        texcoords[i + 1] = verts[i + 1] - geometry.y();
     }
+    GLVertexBuffer *vbo = GLVertexBuffer::streamingBuffer();
+    vbo->reset();
+    vbo->setData(6, 2, verts, texcoords);
+
+    capture->bind();
+    ShaderBinder binder(m_shader);
+    m_shader->setUniform("u_textureSize", QVector2D(geometry.width(), geometry.height()));
+    m_shader->setUniform("u_zoom", (float)zoom);
+    m_shader->setUniform("u_radius", (float)radius);
+    m_shader->setUniform("u_cursor", QVector2D(cursorPos().x() - geometry.x(), cursorPos().y() - geometry.y()));
+    m_shader->setUniform(GLShader::ModelViewProjectionMatrix, data.projectionMatrix());
+    vbo->render(GL_TRIANGLES);
+    capture->unbind();
 }
 
 bool LookingGlassEffect::isActive() const
@@ -27,10 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace KWin
 {
 
-class GLRenderTarget;
 class GLShader;
-class GLTexture;
-class GLVertexBuffer;
 
 /**
  * Enhanced magnifier
@@ -65,14 +62,13 @@ public Q_SLOTS:
 
 private:
     bool loadData();
+    QRect lensArea() const;
+    void setEnabled(bool enabled);
     double zoom;
     double target_zoom;
     bool polling; // Mouse polling
     int radius;
     int initialradius;
-    GLTexture *m_texture;
-    GLRenderTarget *m_fbo;
-    GLVertexBuffer *m_vbo;
     GLShader *m_shader;
     bool m_enabled;
     bool m_valid;
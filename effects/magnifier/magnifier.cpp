@@ -44,8 +44,6 @@ MagnifierEffect::MagnifierEffect()
     : zoom(1)
     , target_zoom(1)
     , polling(false)
-    , m_texture(nullptr)
-    , m_fbo(nullptr)
 #ifdef KWIN_HAVE_XRENDER_COMPOSITING
     , m_pixmap(XCB_PIXMAP_NONE)
 #endif
@@ -74,8 +72,6 @@ MagnifierEffect::MagnifierEffect()
 
 MagnifierEffect::~MagnifierEffect()
 {
-    delete m_fbo;
-    delete m_texture;
     destroyPixmap();
     // Save the zoom value.
     MagnifierConfig::setInitialZoom(target_zoom);
@@ -124,11 +120,8 @@ void MagnifierEffect::prePaintScreen(ScreenPrePaintData& data, int time)
         else {
             zoom = qMax(zoom * qMin(1 - diff, 0.8), target_zoom);
             if (zoom == 1.0) {
-                // zoom ended - delete FBO and texture
-                delete m_fbo;
-                delete m_texture;
-                m_fbo = nullptr;
-                m_texture = nullptr;
+                // zoom ended - release the screen capture
+                effects->unreserveScreenCapture(this);
                 destroyPixmap();
             }
         }
@@ -149,21 +142,47 @@ void MagnifierEffect::paintScreen(int mask, QRegion region, ScreenPaintData& dat
         QRect srcArea(cursor.x() - (double)area.width() / (zoom*2),
                       cursor.y() - (double)area.height() / (zoom*2),
                       (double)area.width() / zoom, (double)area.height() / zoom);
+        m_lastArea = area.adjusted(-FRAME_WIDTH, -FRAME_WIDTH, FRAME_WIDTH, FRAME_WIDTH);
         if (effects->isOpenGLCompositing()) {
-            m_fbo->blitFromFramebuffer(srcArea);
-            // paint magnifier
-            m_texture->bind();
-            auto s = ShaderManager::instance()->pushShader(ShaderTrait::MapTexture);
-            QMatrix4x4 mvp;
-            const QSize size = effects->virtualScreenSize();
-            mvp.ortho(0, size.width(), size.height(), 0, 0, 65535);
-            mvp.translate(area.x(), area.y());
-            s->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
-            m_texture->render(infiniteRegion(), area);
-            ShaderManager::instance()->popShader();
-            m_texture->unbind();
-            QVector<float> verts;
             GLVertexBuffer *vbo = GLVertexBuffer::streamingBuffer();
+            // paint magnifier, the source area is taken from the shared capture of the rendered screen
+            if (GLTexture *capture = effects->screenCaptureTexture()) {
+                const QRect geometry = GLRenderTarget::virtualScreenGeometry();
+                const qreal scale = GLRenderTarget::virtualScreenScale();
+                const qreal width = capture->width();
+                const qreal height = capture->height();
+                // the capture is stored bottom-up
+                const float left = (srcArea.x() - geometry.x()) * scale / width;
+                const float right = (srcArea.x() + srcArea.width() - geometry.x()) * scale / width;
+                const float top = 1.0 - (srcArea.y() - geometry.y()) * scale / height;
+                const float bottom = 1.0 - (srcArea.y() + srcArea.height() - geometry.y()) * scale / height;
+                const QRectF areaF = area;
+                const float verts[] = {
+                    float(areaF.left()), float(areaF.top()),
+                    float(areaF.left()), float(areaF.top() + areaF.height()),
+                    float(areaF.left() + areaF.width()), float(areaF.top() + areaF.height()),
+                    float(areaF.left() + areaF.width()), float(areaF.top() + areaF.height()),
+                    float(areaF.left() + areaF.width()), float(areaF.top()),
+                    float(areaF.left()), float(areaF.top())
+                };
+                const float texcoords[] = {
+                    left, top,
+                    left, bottom,
+                    right, bottom,
+                    right, bottom,
+                    right, top,
+                    left, top
+                };
+                vbo->reset();
+                vbo->setData(6, 2, verts, texcoords);
+
+                capture->bind();
+                ShaderBinder binder(ShaderTrait::MapTexture);
+                binder.shader()->setUniform(GLShader::ModelViewProjectionMatrix, data.projectionMatrix());
+                vbo->render(GL_TRIANGLES);
+                capture->unbind();
+            }
+            QVector<float> verts;
             vbo->reset();
             vbo->setColor(QColor(0, 0, 0));
             const QRectF areaF = area;
@@ -268,11 +287,8 @@ void MagnifierEffect::zoomIn()
         polling = true;
         effects->startMousePolling();
     }
-    if (effects->isOpenGLCompositing() && !m_texture) {
-        effects->makeOpenGLContextCurrent();
-        m_texture = new GLTexture(GL_RGBA8, magnifier_size.width(), magnifier_size.height());
-        m_texture->setYInverted(false);
-        m_fbo = new GLRenderTarget(*m_texture);
+    if (effects->isOpenGLCompositing()) {
+        effects->reserveScreenCapture(this);
     }
     effects->addRepaint(magnifierArea().adjusted(-FRAME_WIDTH, -FRAME_WIDTH, FRAME_WIDTH, FRAME_WIDTH));
 }
@@ -287,11 +303,7 @@ void MagnifierEffect::zoomOut()
             effects->stopMousePolling();
         }
         if (zoom == target_zoom) {
-            effects->makeOpenGLContextCurrent();
-            delete m_fbo;
-            delete m_texture;
-            m_fbo = nullptr;
-            m_texture = nullptr;
+            effects->unreserveScreenCapture(this);
             destroyPixmap();
         }
     }
@@ -308,11 +320,8 @@ void MagnifierEffect::toggle()
             polling = true;
             effects->startMousePolling();
         }
-        if (effects->isOpenGLCompositing() && !m_texture) {
-            effects->makeOpenGLContextCurrent();
-            m_texture = new GLTexture(GL_RGBA8, magnifier_size.width(), magnifier_size.height());
-            m_texture->setYInverted(false);
-            m_fbo = new GLRenderTarget(*m_texture);
+        if (effects->isOpenGLCompositing()) {
+            effects->reserveScreenCapture(this);
         }
     } else {
         target_zoom = 1;
@@ -327,10 +336,12 @@ void MagnifierEffect::toggle()
 void MagnifierEffect::slotMouseChanged(const QPoint& pos, const QPoint& old,
                                    Qt::MouseButtons, Qt::MouseButtons, Qt::KeyboardModifiers, Qt::KeyboardModifiers)
 {
-    if (pos != old && zoom != 1)
-        // need full repaint as we might lose some change events on fast mouse movements
-        // see Bug 187658
-        effects->addRepaintFull();
+    if (pos != old && zoom != 1) {
+        // repaint the area painted last instead of the area at the old position, as
+        // we might lose some change events on fast mouse movements, see Bug 187658
+        effects->addRepaint(m_lastArea);
+        effects->addRepaint(magnifierArea(pos).adjusted(-FRAME_WIDTH, -FRAME_WIDTH, FRAME_WIDTH, FRAME_WIDTH));
+    }
 }
 
 bool MagnifierEffect::isActive() const
@@ -27,8 +27,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace KWin
 {
 
-class GLRenderTarget;
-class GLTexture;
 class XRenderPicture;
 
 class MagnifierEffect
@@ -68,8 +66,7 @@ private:
     double target_zoom;
     bool polling; // Mouse polling
     QSize magnifier_size;
-    GLTexture *m_texture;
-    GLRenderTarget *m_fbo;
+    QRect m_lastArea;
 #ifdef KWIN_HAVE_XRENDER_COMPOSITING
     xcb_pixmap_t m_pixmap;
     QSize m_pixmapSize;
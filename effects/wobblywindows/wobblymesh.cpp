@@ -0,0 +1,444 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+
+#include "wobblymesh.h"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+namespace KWin
+{
+
+namespace WobblyKernels
+{
+
+static_assert(WobblyMesh::Width == 4 && WobblyMesh::Height == 4,
+              "The wobbly kernels assume a 4x4 grid");
+
+// Number of springs attached to each point: 2 at the corners, 3 on the
+// borders and 4 for the inner points.
+alignas(16) static const float s_springCount[WobblyMesh::Count] = {
+    2.0f, 3.0f, 3.0f, 2.0f,
+    3.0f, 4.0f, 4.0f, 3.0f,
+    3.0f, 4.0f, 4.0f, 3.0f,
+    2.0f, 3.0f, 3.0f, 2.0f
+};
+
+// The stiffness is shared between the springs of a point.
+alignas(16) static const float s_springWeight[WobblyMesh::Count] = {
+    1.0f / 2.0f, 1.0f / 3.0f, 1.0f / 3.0f, 1.0f / 2.0f,
+    1.0f / 3.0f, 1.0f / 4.0f, 1.0f / 4.0f, 1.0f / 3.0f,
+    1.0f / 3.0f, 1.0f / 4.0f, 1.0f / 4.0f, 1.0f / 3.0f,
+    1.0f / 2.0f, 1.0f / 3.0f, 1.0f / 3.0f, 1.0f / 2.0f
+};
+
+// The rest length of the horizontal springs pulls the points of the left
+// column to the left and the points of the right column to the right. For
+// points with springs on both sides the two contributions cancel out.
+alignas(16) static const float s_xLengthSign[WobblyMesh::Count] = {
+    -1.0f, 0.0f, 0.0f, 1.0f,
+    -1.0f, 0.0f, 0.0f, 1.0f,
+    -1.0f, 0.0f, 0.0f, 1.0f,
+    -1.0f, 0.0f, 0.0f, 1.0f
+};
+
+// Same as above for the vertical springs.
+alignas(16) static const float s_yLengthSign[WobblyMesh::Count] = {
+    -1.0f, -1.0f, -1.0f, -1.0f,
+     0.0f,  0.0f,  0.0f,  0.0f,
+     0.0f,  0.0f,  0.0f,  0.0f,
+     1.0f,  1.0f,  1.0f,  1.0f
+};
+
+// Number of points in the 8-neighbourhood of each point. The smoothing
+// weighs a point as much as all of its neighbours together.
+alignas(16) static const float s_ringCount[WobblyMesh::Count] = {
+    3.0f, 5.0f, 5.0f, 3.0f,
+    5.0f, 8.0f, 8.0f, 5.0f,
+    5.0f, 8.0f, 8.0f, 5.0f,
+    3.0f, 5.0f, 5.0f, 3.0f
+};
+
+alignas(16) static const float s_ringWeight[WobblyMesh::Count] = {
+    1.0f / 6.0f,  1.0f / 10.0f, 1.0f / 10.0f, 1.0f / 6.0f,
+    1.0f / 10.0f, 1.0f / 16.0f, 1.0f / 16.0f, 1.0f / 10.0f,
+    1.0f / 10.0f, 1.0f / 16.0f, 1.0f / 16.0f, 1.0f / 10.0f,
+    1.0f / 6.0f,  1.0f / 10.0f, 1.0f / 10.0f, 1.0f / 6.0f
+};
+
+static inline void bernstein(float t, float *coefficients)
+{
+    const float s = 1.0f - t;
+    coefficients[0] = s * s * s;
+    coefficients[1] = 3.0f * s * s * t;
+    coefficients[2] = 3.0f * s * t * t;
+    coefficients[3] = t * t * t;
+}
+
+static inline float clampMagnitude(float value, float min, float max)
+{
+    const float magnitude = std::fabs(value);
+    if (magnitude < min) {
+        return 0.0f;
+    }
+    if (magnitude > max) {
+        return value > 0.0f ? max : -max;
+    }
+    return value;
+}
+
+// Sum of the left and right neighbour of each point in a row.
+static inline void horizontalNeighbours(const float *row, float *sum)
+{
+    sum[0] = row[1];
+    sum[1] = row[0] + row[2];
+    sum[2] = row[1] + row[3];
+    sum[3] = row[2];
+}
+
+static void springAccelerationScalar(const float *position, const float *origin,
+                                     const float *lengthSign, float length,
+                                     const bool *constraint, float stiffness,
+                                     float *acceleration)
+{
+    for (int j = 0; j < WobblyMesh::Height; ++j) {
+        const float *row = position + j * WobblyMesh::Width;
+        float sum[WobblyMesh::Width];
+        horizontalNeighbours(row, sum);
+        for (int i = 0; i < WobblyMesh::Width; ++i) {
+            if (j > 0) {
+                sum[i] += row[i - WobblyMesh::Width];
+            }
+            if (j < WobblyMesh::Height - 1) {
+                sum[i] += row[i + WobblyMesh::Width];
+            }
+        }
+        for (int i = 0; i < WobblyMesh::Width; ++i) {
+            const int index = j * WobblyMesh::Width + i;
+            if (constraint[index]) {
+                acceleration[index] = (origin[index] - row[i]) * stiffness;
+            } else {
+                const float stretch = sum[i] - s_springCount[index] * row[i] + lengthSign[index] * length;
+                acceleration[index] = stretch * stiffness * s_springWeight[index];
+            }
+        }
+    }
+}
+
+static void ringMeanScalar(const float *values, float *mean)
+{
+    // Sum of each point with its left and right neighbour.
+    float triples[WobblyMesh::Count];
+    for (int j = 0; j < WobblyMesh::Height; ++j) {
+        const int offset = j * WobblyMesh::Width;
+        horizontalNeighbours(values + offset, triples + offset);
+        for (int i = 0; i < WobblyMesh::Width; ++i) {
+            triples[offset + i] += values[offset + i];
+        }
+    }
+
+    for (int j = 0; j < WobblyMesh::Height; ++j) {
+        const int offset = j * WobblyMesh::Width;
+        float sum[WobblyMesh::Width];
+        horizontalNeighbours(values + offset, sum);
+        for (int i = 0; i < WobblyMesh::Width; ++i) {
+            const int index = offset + i;
+            if (j > 0) {
+                sum[i] += triples[index - WobblyMesh::Width];
+            }
+            if (j < WobblyMesh::Height - 1) {
+                sum[i] += triples[index + WobblyMesh::Width];
+            }
+            mean[index] = (sum[i] + s_ringCount[index] * values[index]) * s_ringWeight[index];
+        }
+    }
+}
+
+void integrateScalar(WobblyMesh &mesh, const WobblyParameters &parameters,
+                     float xLength, float yLength, float time,
+                     float *accelerationSum, float *velocitySum)
+{
+    WobblyMesh::Points acceleration;
+    WobblyMesh::Points mean;
+
+    springAccelerationScalar(mesh.position.x, mesh.origin.x, s_xLengthSign, xLength,
+                             mesh.constraint, parameters.stiffness, acceleration.x);
+    springAccelerationScalar(mesh.position.y, mesh.origin.y, s_yLengthSign, yLength,
+                             mesh.constraint, parameters.stiffness, acceleration.y);
+
+    ringMeanScalar(acceleration.x, mean.x);
+    ringMeanScalar(acceleration.y, mean.y);
+
+    float accSum = 0.0f;
+    for (int i = 0; i < WobblyMesh::Count; ++i) {
+        const float ax = clampMagnitude(mean.x[i], parameters.minAcceleration, parameters.maxAcceleration);
+        const float ay = clampMagnitude(mean.y[i], parameters.minAcceleration, parameters.maxAcceleration);
+        mesh.velocity.x[i] = ax * time + mesh.velocity.x[i] * parameters.drag;
+        mesh.velocity.y[i] = ay * time + mesh.velocity.y[i] * parameters.drag;
+        accSum += std::fabs(ax) + std::fabs(ay);
+    }
+
+    ringMeanScalar(mesh.velocity.x, mean.x);
+    ringMeanScalar(mesh.velocity.y, mean.y);
+
+    const float step = time * parameters.moveFactor;
+    float velSum = 0.0f;
+    for (int i = 0; i < WobblyMesh::Count; ++i) {
+        const float vx = clampMagnitude(mean.x[i], parameters.minVelocity, parameters.maxVelocity);
+        const float vy = clampMagnitude(mean.y[i], parameters.minVelocity, parameters.maxVelocity);
+        mesh.velocity.x[i] = vx;
+        mesh.velocity.y[i] = vy;
+        mesh.position.x[i] += vx * step;
+        mesh.position.y[i] += vy * step;
+        velSum += std::fabs(vx) + std::fabs(vy);
+    }
+
+    *accelerationSum = accSum;
+    *velocitySum = velSum;
+}
+
+void evaluateBezierScalar(const WobblyMesh::Points &points, float tx, float ty, float *x, float *y)
+{
+    float px[4];
+    float py[4];
+    bernstein(tx, px);
+    bernstein(ty, py);
+
+    // The surface is separable, first collapse the rows, then the columns.
+    float columnX[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float columnY[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            columnX[i] += py[j] * points.x[j * 4 + i];
+            columnY[i] += py[j] * points.y[j * 4 + i];
+        }
+    }
+
+    *x = px[0] * columnX[0] + px[1] * columnX[1] + px[2] * columnX[2] + px[3] * columnX[3];
+    *y = px[0] * columnY[0] + px[1] * columnY[1] + px[2] * columnY[2] + px[3] * columnY[3];
+}
+
+#if defined(__SSE2__)
+
+// Lane i holds row[i - 1], lane 0 is zero.
+static inline __m128 leftNeighbours(__m128 row)
+{
+    return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(row), 4));
+}
+
+// Lane i holds row[i + 1], lane 3 is zero.
+static inline __m128 rightNeighbours(__m128 row)
+{
+    return _mm_castsi128_ps(_mm_srli_si128(_mm_castps_si128(row), 4));
+}
+
+static inline float horizontalSum(__m128 v)
+{
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    sums = _mm_add_ss(sums, shuffled);
+    return _mm_cvtss_f32(sums);
+}
+
+static inline __m128 absolute(__m128 v)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+static inline __m128 clampMagnitude(__m128 value, __m128 min, __m128 max)
+{
+    const __m128 clamped = _mm_max_ps(_mm_min_ps(value, max), _mm_xor_ps(max, _mm_set1_ps(-0.0f)));
+    return _mm_and_ps(_mm_cmpge_ps(absolute(value), min), clamped);
+}
+
+static void springAccelerationSSE2(const float *position, const float *origin,
+                                   const float *lengthSign, float length,
+                                   const __m128 *constraint, float stiffness,
+                                   float *acceleration)
+{
+    const __m128 rows[4] = {
+        _mm_load_ps(position),
+        _mm_load_ps(position + 4),
+        _mm_load_ps(position + 8),
+        _mm_load_ps(position + 12)
+    };
+    const __m128 k = _mm_set1_ps(stiffness);
+    const __m128 l = _mm_set1_ps(length);
+
+    for (int j = 0; j < 4; ++j) {
+        __m128 sum = _mm_add_ps(leftNeighbours(rows[j]), rightNeighbours(rows[j]));
+        if (j > 0) {
+            sum = _mm_add_ps(sum, rows[j - 1]);
+        }
+        if (j < 3) {
+            sum = _mm_add_ps(sum, rows[j + 1]);
+        }
+
+        const __m128 count = _mm_load_ps(s_springCount + j * 4);
+        __m128 stretch = _mm_sub_ps(sum, _mm_mul_ps(count, rows[j]));
+        stretch = _mm_add_ps(stretch, _mm_mul_ps(_mm_load_ps(lengthSign + j * 4), l));
+        const __m128 unconstrained = _mm_mul_ps(_mm_mul_ps(stretch, k), _mm_load_ps(s_springWeight + j * 4));
+
+        const __m128 constrained = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(origin + j * 4), rows[j]), k);
+
+        _mm_store_ps(acceleration + j * 4, _mm_or_ps(_mm_and_ps(constraint[j], constrained),
+                                                     _mm_andnot_ps(constraint[j], unconstrained)));
+    }
+}
+
+static void ringMeanSSE2(const float *values, float *mean)
+{
+    const __m128 rows[4] = {
+        _mm_load_ps(values),
+        _mm_load_ps(values + 4),
+        _mm_load_ps(values + 8),
+        _mm_load_ps(values + 12)
+    };
+
+    // Sum of each point with its left and right neighbour.
+    __m128 triples[4];
+    for (int j = 0; j < 4; ++j) {
+        triples[j] = _mm_add_ps(rows[j], _mm_add_ps(leftNeighbours(rows[j]), rightNeighbours(rows[j])));
+    }
+
+    for (int j = 0; j < 4; ++j) {
+        __m128 sum = _mm_add_ps(leftNeighbours(rows[j]), rightNeighbours(rows[j]));
+        if (j > 0) {
+            sum = _mm_add_ps(sum, triples[j - 1]);
+        }
+        if (j < 3) {
+            sum = _mm_add_ps(sum, triples[j + 1]);
+        }
+        const __m128 count = _mm_load_ps(s_ringCount + j * 4);
+        sum = _mm_add_ps(sum, _mm_mul_ps(count, rows[j]));
+        _mm_store_ps(mean + j * 4, _mm_mul_ps(sum, _mm_load_ps(s_ringWeight + j * 4)));
+    }
+}
+
+static void integrateSSE2(WobblyMesh &mesh, const WobblyParameters &parameters,
+                          float xLength, float yLength, float time,
+                          float *accelerationSum, float *velocitySum)
+{
+    alignas(16) uint32_t constraintBits[WobblyMesh::Count];
+    for (int i = 0; i < WobblyMesh::Count; ++i) {
+        constraintBits[i] = mesh.constraint[i] ? 0xffffffff : 0;
+    }
+    __m128 constraint[4];
+    for (int j = 0; j < 4; ++j) {
+        constraint[j] = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i *>(constraintBits + j * 4)));
+    }
+
+    WobblyMesh::Points acceleration;
+    WobblyMesh::Points mean;
+
+    springAccelerationSSE2(mesh.position.x, mesh.origin.x, s_xLengthSign, xLength,
+                           constraint, parameters.stiffness, acceleration.x);
+    springAccelerationSSE2(mesh.position.y, mesh.origin.y, s_yLengthSign, yLength,
+                           constraint, parameters.stiffness, acceleration.y);
+
+    ringMeanSSE2(acceleration.x, mean.x);
+    ringMeanSSE2(acceleration.y, mean.y);
+
+    const __m128 t = _mm_set1_ps(time);
+    const __m128 drag = _mm_set1_ps(parameters.drag);
+    const __m128 minAcceleration = _mm_set1_ps(parameters.minAcceleration);
+    const __m128 maxAcceleration = _mm_set1_ps(parameters.maxAcceleration);
+
+    __m128 accSum = _mm_setzero_ps();
+    for (int i = 0; i < WobblyMesh::Count; i += 4) {
+        const __m128 ax = clampMagnitude(_mm_load_ps(mean.x + i), minAcceleration, maxAcceleration);
+        const __m128 ay = clampMagnitude(_mm_load_ps(mean.y + i), minAcceleration, maxAcceleration);
+        const __m128 vx = _mm_add_ps(_mm_mul_ps(ax, t), _mm_mul_ps(_mm_load_ps(mesh.velocity.x + i), drag));
+        const __m128 vy = _mm_add_ps(_mm_mul_ps(ay, t), _mm_mul_ps(_mm_load_ps(mesh.velocity.y + i), drag));
+        _mm_store_ps(mesh.velocity.x + i, vx);
+        _mm_store_ps(mesh.velocity.y + i, vy);
+        accSum = _mm_add_ps(accSum, _mm_add_ps(absolute(ax), absolute(ay)));
+    }
+
+    ringMeanSSE2(mesh.velocity.x, mean.x);
+    ringMeanSSE2(mesh.velocity.y, mean.y);
+
+    const __m128 step = _mm_set1_ps(time * parameters.moveFactor);
+    const __m128 minVelocity = _mm_set1_ps(parameters.minVelocity);
+    const __m128 maxVelocity = _mm_set1_ps(parameters.maxVelocity);
+
+    __m128 velSum = _mm_setzero_ps();
+    for (int i = 0; i < WobblyMesh::Count; i += 4) {
+        const __m128 vx = clampMagnitude(_mm_load_ps(mean.x + i), minVelocity, maxVelocity);
+        const __m128 vy = clampMagnitude(_mm_load_ps(mean.y + i), minVelocity, maxVelocity);
+        _mm_store_ps(mesh.velocity.x + i, vx);
+        _mm_store_ps(mesh.velocity.y + i, vy);
+        _mm_store_ps(mesh.position.x + i, _mm_add_ps(_mm_load_ps(mesh.position.x + i), _mm_mul_ps(vx, step)));
+        _mm_store_ps(mesh.position.y + i, _mm_add_ps(_mm_load_ps(mesh.position.y + i), _mm_mul_ps(vy, step)));
+        velSum = _mm_add_ps(velSum, _mm_add_ps(absolute(vx), absolute(vy)));
+    }
+
+    *accelerationSum = horizontalSum(accSum);
+    *velocitySum = horizontalSum(velSum);
+}
+
+static void evaluateBezierSSE2(const WobblyMesh::Points &points, float tx, float ty, float *x, float *y)
+{
+    float px[4];
+    float py[4];
+    bernstein(tx, px);
+    bernstein(ty, py);
+
+    __m128 columnX = _mm_setzero_ps();
+    __m128 columnY = _mm_setzero_ps();
+    for (int j = 0; j < 4; ++j) {
+        const __m128 weight = _mm_set1_ps(py[j]);
+        columnX = _mm_add_ps(columnX, _mm_mul_ps(weight, _mm_load_ps(points.x + j * 4)));
+        columnY = _mm_add_ps(columnY, _mm_mul_ps(weight, _mm_load_ps(points.y + j * 4)));
+    }
+
+    const __m128 weights = _mm_loadu_ps(px);
+    *x = horizontalSum(_mm_mul_ps(weights, columnX));
+    *y = horizontalSum(_mm_mul_ps(weights, columnY));
+}
+
+#endif
+
+void integrate(WobblyMesh &mesh, const WobblyParameters &parameters,
+               float xLength, float yLength, float time,
+               float *accelerationSum, float *velocitySum)
+{
+#if defined(__SSE2__)
+    integrateSSE2(mesh, parameters, xLength, yLength, time, accelerationSum, velocitySum);
+#else
+    integrateScalar(mesh, parameters, xLength, yLength, time, accelerationSum, velocitySum);
+#endif
+}
+
+void evaluateBezier(const WobblyMesh::Points &points, float tx, float ty, float *x, float *y)
+{
+#if defined(__SSE2__)
+    evaluateBezierSSE2(points, tx, ty, x, y);
+#else
+    evaluateBezierScalar(points, tx, ty, x, y);
+#endif
+}
+
+} // namespace WobblyKernels
+
+} // namespace KWin
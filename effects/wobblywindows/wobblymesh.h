@@ -0,0 +1,106 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+
+#ifndef KWIN_WOBBLYMESH_H
+#define KWIN_WOBBLYMESH_H
+
+namespace KWin
+{
+
+/**
+ * The spring mesh of a wobbly window.
+ *
+ * The 4x4 control points are stored as separate, 16 byte aligned arrays of
+ * x and y coordinates, row by row. This way every row of the grid fits into
+ * a single SSE register and the kernels below can work on whole rows.
+ */
+struct WobblyMesh
+{
+    enum {
+        Width = 4,
+        Height = 4,
+        Count = Width * Height
+    };
+
+    struct Points {
+        alignas(16) float x[Count];
+        alignas(16) float y[Count];
+    };
+
+    Points origin;
+    Points position;
+    Points velocity;
+
+    // if true, the physics system moves this point based only on it "normal" destination
+    // given by the window position, ignoring neighbour points.
+    bool constraint[Count];
+};
+
+struct WobblyParameters
+{
+    float stiffness;
+    float drag;
+    float moveFactor;
+    float minVelocity;
+    float maxVelocity;
+    float minAcceleration;
+    float maxAcceleration;
+};
+
+namespace WobblyKernels
+{
+
+/**
+ * Advances the mesh by @p time milliseconds. @p xLength and @p yLength are the
+ * rest lengths of the horizontal and vertical springs.
+ *
+ * The sums of the absolute accelerations and velocities of all points are
+ * returned in @p accelerationSum and @p velocitySum, they are used to decide
+ * when the window stopped wobbling.
+ *
+ * Uses SSE2 when available, otherwise the same as integrateScalar().
+ */
+void integrate(WobblyMesh &mesh, const WobblyParameters &parameters,
+               float xLength, float yLength, float time,
+               float *accelerationSum, float *velocitySum);
+
+/**
+ * Portable implementation of integrate().
+ */
+void integrateScalar(WobblyMesh &mesh, const WobblyParameters &parameters,
+                     float xLength, float yLength, float time,
+                     float *accelerationSum, float *velocitySum);
+
+/**
+ * Evaluates the bicubic Bezier surface spanned by @p points at the parametric
+ * coordinates @p tx and @p ty and stores the result in @p x and @p y.
+ *
+ * Uses SSE2 when available, otherwise the same as evaluateBezierScalar().
+ */
+void evaluateBezier(const WobblyMesh::Points &points, float tx, float ty, float *x, float *y);
+
+/**
+ * Portable implementation of evaluateBezier().
+ */
+void evaluateBezierScalar(const WobblyMesh::Points &points, float tx, float ty, float *x, float *y);
+
+} // namespace WobblyKernels
+
+} // namespace KWin
+
+#endif
@@ -406,7 +406,12 @@ bool Client::sameAppWindowRoleMatch(const Client* c1, const Client* c2, bool act
 
 Xcb::TransientFor Client::fetchTransient() const
 {
-    return Xcb::TransientFor(window());
+    return fetchTransient(window());
+}
+
+Xcb::TransientFor Client::fetchTransient(xcb_window_t window)
+{
+    return Xcb::TransientFor(window);
 }
 
 void Client::readTransientProperty(Xcb::TransientFor &transientFor)
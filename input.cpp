@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "touch_input.h"
 #include "touch_hide_cursor_spy.h"
 #include "client.h"
+#include "composite.h"
 #include "effects.h"
 #include "gestures.h"
 #include "globalshortcuts.h"
@@ -1871,9 +1872,14 @@ void InputRedirection::setupLibInput()
         waylandServer()->updateKeyState(m_keyboard->xkb()->leds());
         connect(m_keyboard, &KeyboardInputRedirection::ledsChanged, waylandServer(), &WaylandServer::updateKeyState);
         connect(m_keyboard, &KeyboardInputRedirection::ledsChanged, conn, &LibInput::Connection::updateLEDs);
+        // merge relative pointer motion until the next frame, e.g. for high rate gaming mice
+        conn->setPointerMotionCoalescing(qEnvironmentVariableIntValue("KWIN_LIBINPUT_COALESCE_MOTION") == 1);
         connect(conn, &LibInput::Connection::eventsRead, this,
             [this] {
                 m_libInput->processEvents();
+                if (m_libInput->hasPendingPointerMotion()) {
+                    schedulePointerMotionFlush();
+                }
             }, Qt::QueuedConnection
         );
         conn->setup();
@@ -1968,6 +1974,23 @@ void InputRedirection::setupLibInput()
     setupTouchpadShortcuts();
 }
 
+void InputRedirection::schedulePointerMotionFlush()
+{
+    Compositor *compositor = Compositor::self();
+    if (!compositor || !compositor->isActive()) {
+        m_libInput->flushPointerMotion();
+        return;
+    }
+    if (!m_pointerMotionFlushConnection) {
+        m_pointerMotionFlushConnection = connect(compositor, &Compositor::aboutToComposite, this,
+            [this] {
+                m_libInput->flushPointerMotion();
+            }
+        );
+    }
+    compositor->scheduleRepaint();
+}
+
 void InputRedirection::setupTouchpadShortcuts()
 {
     if (!m_libInput) {
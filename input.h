@@ -278,6 +278,7 @@ private:
     void setupLibInput();
     void setupTouchpadShortcuts();
     void setupLibInputWithScreens();
+    void schedulePointerMotionFlush();
     void setupWorkspace();
     void reconfigure();
     void setupInputFilters();
@@ -289,6 +290,7 @@ private:
     GlobalShortcutsManager *m_shortcuts;
 
     LibInput::Connection *m_libInput = nullptr;
+    QMetaObject::Connection m_pointerMotionFlushConnection;
 
     WindowSelectorFilter *m_windowSelector = nullptr;
 
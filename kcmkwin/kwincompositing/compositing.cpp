@@ -88,6 +88,8 @@ void Compositing::reset()
             return 3;
         } else if (glSwapStrategyValue == "c") {
             return 4;
+        } else if (glSwapStrategyValue == "b") {
+            return 5;
         }
         return 0;
     };
@@ -285,6 +287,8 @@ void Compositing::save()
                 return QStringLiteral("p");
             case 4:
                 return QStringLiteral("c");
+            case 5:
+                return QStringLiteral("b");
             case 1:
             default:
                 return QStringLiteral("a");
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "context.h"
 #include "device.h"
 #include "events.h"
+#include "eventqueue.h"
 #ifndef KWIN_BUILD_TESTING
 #include "../screens.h"
 #endif
@@ -161,6 +162,7 @@ Connection::Connection(Context *input, QObject *parent)
     , m_input(input)
     , m_notifier(nullptr)
     , m_mutex(QMutex::Recursive)
+    , m_eventQueue(new EventQueue)
     , m_leds()
 {
     Q_ASSERT(m_input);
@@ -229,26 +231,79 @@ void Connection::deactivate()
 
 void Connection::handleEvent()
 {
-    QMutexLocker locker(&m_mutex);
-    const bool wasEmpty = m_eventQueue.isEmpty();
+    // only called from the libinput thread, which is the only producer of the event queue
+    bool notify = false;
     do {
+        void *storage = m_eventQueue->reserve();
+        if (!storage) {
+            // leave the remaining events in libinput's queue, processEvents() calls us again
+            m_eventQueueOverflow.storeRelease(1);
+            notify = true;
+            break;
+        }
         m_input->dispatch();
-        Event *event = m_input->event();
+        Event *event = m_input->event(storage);
         if (!event) {
             break;
         }
-        m_eventQueue << event;
+        m_eventQueue->commit(event);
+        notify = true;
     } while (true);
-    if (wasEmpty && !m_eventQueue.isEmpty()) {
+    // only notify if processEvents() did not get notified yet, it resets the flag before draining
+    if (notify && m_eventsReadPending.testAndSetOrdered(0, 1)) {
         emit eventsRead();
     }
 }
 
+void Connection::setPointerMotionCoalescing(bool coalesce)
+{
+    m_pointerMotionCoalescing = coalesce;
+    if (!coalesce) {
+        flushPointerMotion();
+    }
+}
+
+void Connection::addPointerMotion(PointerEvent *event)
+{
+    if (m_pendingMotion.device && m_pendingMotion.device != event->device()) {
+        flushPointerMotion();
+    }
+    m_pendingMotion.delta += event->delta();
+    m_pendingMotion.deltaNonAccelerated += event->deltaUnaccelerated();
+    m_pendingMotion.time = event->time();
+    m_pendingMotion.timeMicroseconds = event->timeMicroseconds();
+    m_pendingMotion.device = event->device();
+}
+
+void Connection::flushPointerMotion()
+{
+    if (!m_pendingMotion.device) {
+        return;
+    }
+    const PendingMotion motion = m_pendingMotion;
+    m_pendingMotion = PendingMotion();
+    emit pointerMotion(motion.delta, motion.deltaNonAccelerated, motion.time, motion.timeMicroseconds, motion.device);
+}
+
 void Connection::processEvents()
 {
+    // a nested event loop in one of the connected slots must not process the Event
+    // which is currently handled again, the outer call drains the queue anyway
+    if (m_processingEvents) {
+        return;
+    }
+    m_processingEvents = true;
     QMutexLocker locker(&m_mutex);
-    while (!m_eventQueue.isEmpty()) {
-        QScopedPointer<Event> event(m_eventQueue.takeFirst());
+    m_eventsReadPending.fetchAndStoreOrdered(0);
+    while (Event *event = m_eventQueue->head()) {
+        // consecutive relative motion is merged into one motion with the sum of the deltas
+        if (event->type() == LIBINPUT_EVENT_POINTER_MOTION) {
+            addPointerMotion(static_cast<PointerEvent*>(event));
+            m_eventQueue->pop();
+            continue;
+        }
+        // keep the order of the events
+        flushPointerMotion();
         switch (event->type()) {
             case LIBINPUT_EVENT_DEVICE_ADDED: {
                 auto device = new Device(event->nativeDevice());
@@ -337,12 +392,12 @@ void Connection::processEvents()
                 break;
             }
             case LIBINPUT_EVENT_KEYBOARD_KEY: {
-                KeyEvent *ke = static_cast<KeyEvent*>(event.data());
+                KeyEvent *ke = static_cast<KeyEvent*>(event);
                 emit keyChanged(ke->key(), ke->state(), ke->time(), ke->device());
                 break;
             }
             case LIBINPUT_EVENT_POINTER_AXIS: {
-                PointerEvent *pe = static_cast<PointerEvent*>(event.data());
+                PointerEvent *pe = static_cast<PointerEvent*>(event);
                 const auto axes = pe->axis();
                 for (const InputRedirection::PointerAxis &axis : axes) {
                     emit pointerAxisChanged(axis, pe->axisValue(axis), pe->discreteAxisValue(axis),
@@ -351,53 +406,31 @@ void Connection::processEvents()
                 break;
             }
             case LIBINPUT_EVENT_POINTER_BUTTON: {
-                PointerEvent *pe = static_cast<PointerEvent*>(event.data());
+                PointerEvent *pe = static_cast<PointerEvent*>(event);
                 emit pointerButtonChanged(pe->button(), pe->buttonState(), pe->time(), pe->device());
                 break;
             }
-            case LIBINPUT_EVENT_POINTER_MOTION: {
-                PointerEvent *pe = static_cast<PointerEvent*>(event.data());
-                auto delta = pe->delta();
-                auto deltaNonAccel = pe->deltaUnaccelerated();
-                quint32 latestTime = pe->time();
-                quint64 latestTimeUsec = pe->timeMicroseconds();
-                auto it = m_eventQueue.begin();
-                while (it != m_eventQueue.end()) {
-                    if ((*it)->type() == LIBINPUT_EVENT_POINTER_MOTION) {
-                        QScopedPointer<PointerEvent> p(static_cast<PointerEvent*>(*it));
-                        delta += p->delta();
-                        deltaNonAccel += p->deltaUnaccelerated();
-                        latestTime = p->time();
-                        latestTimeUsec = p->timeMicroseconds();
-                        it = m_eventQueue.erase(it);
-                    } else {
-                        break;
-                    }
-                }
-                emit pointerMotion(delta, deltaNonAccel, latestTime, latestTimeUsec, pe->device());
-                break;
-            }
             case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE: {
-                PointerEvent *pe = static_cast<PointerEvent*>(event.data());
+                PointerEvent *pe = static_cast<PointerEvent*>(event);
                 emit pointerMotionAbsolute(pe->absolutePos(), pe->absolutePos(m_size), pe->time(), pe->device());
                 break;
             }
             case LIBINPUT_EVENT_TOUCH_DOWN: {
 #ifndef KWIN_BUILD_TESTING
-                TouchEvent *te = static_cast<TouchEvent*>(event.data());
+                TouchEvent *te = static_cast<TouchEvent*>(event);
                 const auto &geo = screens()->geometry(te->device()->screenId());
                 emit touchDown(te->id(), geo.topLeft() + te->absolutePos(geo.size()), te->time(), te->device());
                 break;
 #endif
             }
             case LIBINPUT_EVENT_TOUCH_UP: {
-                TouchEvent *te = static_cast<TouchEvent*>(event.data());
+                TouchEvent *te = static_cast<TouchEvent*>(event);
                 emit touchUp(te->id(), te->time(), te->device());
                 break;
             }
             case LIBINPUT_EVENT_TOUCH_MOTION: {
 #ifndef KWIN_BUILD_TESTING
-                TouchEvent *te = static_cast<TouchEvent*>(event.data());
+                TouchEvent *te = static_cast<TouchEvent*>(event);
                 const auto &geo = screens()->geometry(te->device()->screenId());
                 emit touchMotion(te->id(), geo.topLeft() + te->absolutePos(geo.size()), te->time(), te->device());
                 break;
@@ -412,17 +445,17 @@ void Connection::processEvents()
                 break;
             }
             case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN: {
-                PinchGestureEvent *pe = static_cast<PinchGestureEvent*>(event.data());
+                PinchGestureEvent *pe = static_cast<PinchGestureEvent*>(event);
                 emit pinchGestureBegin(pe->fingerCount(), pe->time(), pe->device());
                 break;
             }
             case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE: {
-                PinchGestureEvent *pe = static_cast<PinchGestureEvent*>(event.data());
+                PinchGestureEvent *pe = static_cast<PinchGestureEvent*>(event);
                 emit pinchGestureUpdate(pe->scale(), pe->angleDelta(), pe->delta(), pe->time(), pe->device());
                 break;
             }
             case LIBINPUT_EVENT_GESTURE_PINCH_END: {
-                PinchGestureEvent *pe = static_cast<PinchGestureEvent*>(event.data());
+                PinchGestureEvent *pe = static_cast<PinchGestureEvent*>(event);
                 if (pe->isCancelled()) {
                     emit pinchGestureCancelled(pe->time(), pe->device());
                 } else {
@@ -431,17 +464,17 @@ void Connection::processEvents()
                 break;
             }
             case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN: {
-                SwipeGestureEvent *se = static_cast<SwipeGestureEvent*>(event.data());
+                SwipeGestureEvent *se = static_cast<SwipeGestureEvent*>(event);
                 emit swipeGestureBegin(se->fingerCount(), se->time(), se->device());
                 break;
             }
             case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE: {
-                SwipeGestureEvent *se = static_cast<SwipeGestureEvent*>(event.data());
+                SwipeGestureEvent *se = static_cast<SwipeGestureEvent*>(event);
                 emit swipeGestureUpdate(se->delta(), se->time(), se->device());
                 break;
             }
             case LIBINPUT_EVENT_GESTURE_SWIPE_END: {
-                SwipeGestureEvent *se = static_cast<SwipeGestureEvent*>(event.data());
+                SwipeGestureEvent *se = static_cast<SwipeGestureEvent*>(event);
                 if (se->isCancelled()) {
                     emit swipeGestureCancelled(se->time(), se->device());
                 } else {
@@ -450,7 +483,7 @@ void Connection::processEvents()
                 break;
             }
             case LIBINPUT_EVENT_SWITCH_TOGGLE: {
-                SwitchEvent *se = static_cast<SwitchEvent*>(event.data());
+                SwitchEvent *se = static_cast<SwitchEvent*>(event);
                 switch (se->state()) {
                 case SwitchEvent::State::Off:
                     emit switchToggledOff(se->time(), se->timeMicroseconds(), se->device());
@@ -467,6 +500,14 @@ void Connection::processEvents()
                 // nothing
                 break;
         }
+        m_eventQueue->pop();
+    }
+    if (!m_pointerMotionCoalescing) {
+        flushPointerMotion();
+    }
+    if (m_eventQueueOverflow.testAndSetOrdered(1, 0)) {
+        // the queue is drained, read the events which did not fit into it
+        QMetaObject::invokeMethod(this, [this] { handleEvent(); }, Qt::QueuedConnection);
     }
     if (wasSuspended) {
         if (m_keyboardBeforeSuspend && !m_keyboard) {
@@ -486,6 +527,7 @@ void Connection::processEvents()
         }
         wasSuspended = false;
     }
+    m_processingEvents = false;
 }
 
 void Connection::setScreenSize(const QSize &size)
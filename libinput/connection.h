@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../keyboard_input.h"
 #include <kwinglobals.h>
 
+#include <QAtomicInteger>
 #include <QObject>
 #include <QPointer>
 #include <QSize>
@@ -31,6 +32,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QVector>
 #include <QStringList>
 
+#include <memory>
+
 class QSocketNotifier;
 class QThread;
 
@@ -40,6 +43,8 @@ namespace LibInput
 {
 
 class Event;
+class EventQueue;
+class PointerEvent;
 class Device;
 class Context;
 
@@ -85,6 +90,27 @@ public:
 
     void processEvents();
 
+    /**
+     * Whether relative pointer motion is held back until flushPointerMotion() gets called,
+     * e.g. once per compositor frame. All motion of a device in between is merged into one
+     * pointerMotion signal, the accelerated and unaccelerated deltas are summed up and the
+     * timestamps of the latest event are used. Any other event flushes the pending motion
+     * first, so the order of the events is kept.
+     *
+     * If disabled, which is the default, only the motion events read in one go are merged.
+     */
+    void setPointerMotionCoalescing(bool coalesce);
+    bool isPointerMotionCoalescing() const {
+        return m_pointerMotionCoalescing;
+    }
+    bool hasPendingPointerMotion() const {
+        return m_pendingMotion.device != nullptr;
+    }
+    /**
+     * Emits the pointerMotion signal for the held back relative motion, if any.
+     */
+    void flushPointerMotion();
+
     void toggleTouchpads();
     void enableTouchpads();
     void disableTouchpads();
@@ -140,6 +166,7 @@ private Q_SLOTS:
 private:
     Connection(Context *input, QObject *parent = nullptr);
     void handleEvent();
+    void addPointerMotion(PointerEvent *event);
     void applyDeviceConfig(Device *device);
     void applyScreenToDevice(Device *device);
     Context *m_input;
@@ -156,7 +183,18 @@ private:
     bool m_touchBeforeSuspend = false;
     bool m_tabletModeSwitchBeforeSuspend = false;
     QMutex m_mutex;
-    QVector<Event*> m_eventQueue;
+    std::unique_ptr<EventQueue> m_eventQueue;
+    QAtomicInteger<int> m_eventsReadPending;
+    QAtomicInteger<int> m_eventQueueOverflow;
+    bool m_processingEvents = false;
+    bool m_pointerMotionCoalescing = false;
+    struct PendingMotion {
+        QSizeF delta;
+        QSizeF deltaNonAccelerated;
+        quint32 time = 0;
+        quint64 timeMicroseconds = 0;
+        Device *device = nullptr;
+    } m_pendingMotion;
     bool wasSuspended = false;
     QVector<Device*> m_devices;
     KSharedConfigPtr m_config;
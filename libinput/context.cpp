@@ -163,6 +163,11 @@ Event *Context::event()
     return Event::create(libinput_get_event(m_libinput));
 }
 
+Event *Context::event(void *storage)
+{
+    return Event::create(libinput_get_event(m_libinput), storage);
+}
+
 void Context::suspend()
 {
     if (m_suspended) {
@@ -62,6 +62,12 @@ public:
      * The caller takes ownership of the returned pointer.
      */
     Event *event();
+    /**
+     * Gets the next event and creates it in place at @p storage, if there is
+     * no new event @c null is returned.
+     * @see Event::create(libinput_event *, void *)
+     */
+    Event *event(void *storage);
 
     static int openRestrictedCallback(const char *path, int flags, void *user_data);
     static void closeRestrictedCallBack(int fd, void *user_data);
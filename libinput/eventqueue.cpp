@@ -0,0 +1,93 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "eventqueue.h"
+
+#include <QtGlobal>
+
+namespace KWin
+{
+namespace LibInput
+{
+
+static quint32 roundUpToPowerOfTwo(quint32 value)
+{
+    quint32 result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+EventQueue::EventQueue(quint32 capacity)
+    : m_mask(roundUpToPowerOfTwo(qMax(capacity, 2u)) - 1)
+    , m_head(0)
+    , m_tail(0)
+{
+    m_slots.reset(new EventStorage[m_mask + 1]);
+    m_events.reset(new Event*[m_mask + 1]);
+}
+
+EventQueue::~EventQueue()
+{
+    while (!isEmpty()) {
+        pop();
+    }
+}
+
+void *EventQueue::reserve()
+{
+    // the indices wrap around, their difference is the number of used slots
+    const quint32 tail = m_tail.load();
+    if (tail - m_head.loadAcquire() > m_mask) {
+        return nullptr;
+    }
+    return &m_slots[tail & m_mask];
+}
+
+void EventQueue::commit(Event *event)
+{
+    const quint32 tail = m_tail.load();
+    m_events[tail & m_mask] = event;
+    m_tail.storeRelease(tail + 1);
+}
+
+Event *EventQueue::head() const
+{
+    const quint32 head = m_head.load();
+    if (head == m_tail.loadAcquire()) {
+        return nullptr;
+    }
+    return m_events[head & m_mask];
+}
+
+void EventQueue::pop()
+{
+    const quint32 head = m_head.load();
+    Q_ASSERT(head != m_tail.loadAcquire());
+    m_events[head & m_mask]->~Event();
+    // the slot may be reused by the producer from now on
+    m_head.storeRelease(head + 1);
+}
+
+bool EventQueue::isEmpty() const
+{
+    return m_head.load() == m_tail.loadAcquire();
+}
+
+}
+}
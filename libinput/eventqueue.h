@@ -0,0 +1,90 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#ifndef KWIN_LIBINPUT_EVENTQUEUE_H
+#define KWIN_LIBINPUT_EVENTQUEUE_H
+
+#include "events.h"
+
+#include <QAtomicInteger>
+
+#include <memory>
+
+namespace KWin
+{
+namespace LibInput
+{
+
+/**
+ * Fixed size ring buffer passing Events from the libinput thread to the main thread.
+ *
+ * The queue supports exactly one producer and one consumer thread and does not lock.
+ * The Events are created in place in the slots of the ring, so no memory gets
+ * allocated while events are read.
+ *
+ * The producer asks for a free slot with reserve(), creates the Event in it and
+ * publishes it with commit(). The consumer accesses the oldest Event with head()
+ * and destroys it with pop().
+ */
+class EventQueue
+{
+public:
+    /**
+     * @param capacity The number of slots, rounded up to the next power of two
+     */
+    explicit EventQueue(quint32 capacity = 1024);
+    ~EventQueue();
+
+    quint32 capacity() const {
+        return m_mask + 1;
+    }
+
+    /**
+     * Producer: storage for the next Event or @c null if the queue is full.
+     * The slot only becomes visible to the consumer through commit().
+     */
+    void *reserve();
+    /**
+     * Producer: publishes @p event, which got created in the slot returned by reserve().
+     */
+    void commit(Event *event);
+
+    /**
+     * Consumer: the oldest Event or @c null if the queue is empty.
+     */
+    Event *head() const;
+    /**
+     * Consumer: destroys the oldest Event and releases its slot.
+     */
+    void pop();
+
+    bool isEmpty() const;
+
+private:
+    std::unique_ptr<EventStorage[]> m_slots;
+    std::unique_ptr<Event*[]> m_events;
+    quint32 m_mask;
+    // written by the consumer only
+    QAtomicInteger<quint32> m_head;
+    // written by the producer only
+    QAtomicInteger<quint32> m_tail;
+};
+
+}
+}
+
+#endif
@@ -22,12 +22,29 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QSize>
 
+#include <new>
+
 namespace KWin
 {
 namespace LibInput
 {
 
 Event *Event::create(libinput_event *event)
+{
+    return create(event, nullptr);
+}
+
+template <typename T, typename... Args>
+Event *Event::construct(void *storage, Args... args)
+{
+    static_assert(sizeof(T) <= sizeof(EventStorage), "EventStorage too small");
+    if (storage) {
+        return new (storage) T(args...);
+    }
+    return new T(args...);
+}
+
+Event *Event::create(libinput_event *event, void *storage)
 {
     if (!event) {
         return nullptr;
@@ -37,30 +54,30 @@ Event *Event::create(libinput_event *event)
     // TODO: add device notify events
     switch (t) {
     case LIBINPUT_EVENT_KEYBOARD_KEY:
-        return new KeyEvent(event);
+        return construct<KeyEvent>(storage, event);
     case LIBINPUT_EVENT_POINTER_AXIS:
     case LIBINPUT_EVENT_POINTER_BUTTON:
     case LIBINPUT_EVENT_POINTER_MOTION:
     case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
-        return new PointerEvent(event, t);
+        return construct<PointerEvent>(storage, event, t);
     case LIBINPUT_EVENT_TOUCH_DOWN:
     case LIBINPUT_EVENT_TOUCH_UP:
     case LIBINPUT_EVENT_TOUCH_MOTION:
     case LIBINPUT_EVENT_TOUCH_CANCEL:
     case LIBINPUT_EVENT_TOUCH_FRAME:
-        return new TouchEvent(event, t);
+        return construct<TouchEvent>(storage, event, t);
     case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
     case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
     case LIBINPUT_EVENT_GESTURE_SWIPE_END:
-        return new SwipeGestureEvent(event, t);
+        return construct<SwipeGestureEvent>(storage, event, t);
     case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
     case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
     case LIBINPUT_EVENT_GESTURE_PINCH_END:
-        return new PinchGestureEvent(event, t);
+        return construct<PinchGestureEvent>(storage, event, t);
     case LIBINPUT_EVENT_SWITCH_TOGGLE:
-        return new SwitchEvent(event, t);
+        return construct<SwitchEvent>(storage, event, t);
     default:
-        return new Event(event, t);
+        return construct<Event>(storage, event, t);
     }
 }
 
@@ -24,6 +24,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <libinput.h>
 
+#include <type_traits>
+
 namespace KWin
 {
 namespace LibInput
@@ -48,11 +50,20 @@ public:
     }
 
     static Event *create(libinput_event *event);
+    /**
+     * Creates the Event for @p event in place at @p storage, which must point to an
+     * EventStorage. The caller has to invoke the destructor instead of deleting it.
+     * If @p storage is @c null the Event is allocated on the heap.
+     */
+    static Event *create(libinput_event *event, void *storage);
 
 protected:
     Event(libinput_event *event, libinput_event_type type);
 
 private:
+    template <typename T, typename... Args>
+    static Event *construct(void *storage, Args... args);
+
     libinput_event *m_event;
     libinput_event_type m_type;
     mutable Device *m_device;
@@ -191,6 +202,12 @@ private:
     libinput_event_switch *m_switchEvent;
 };
 
+/**
+ * Storage suitable to hold any of the Event types.
+ */
+typedef std::aligned_union<0, Event, KeyEvent, PointerEvent, TouchEvent,
+                           PinchGestureEvent, SwipeGestureEvent, SwitchEvent>::type EventStorage;
+
 inline
 libinput_event_type Event::type() const
 {
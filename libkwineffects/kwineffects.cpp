@@ -222,6 +222,9 @@ public:
     QMatrix4x4 pMatrix;
     QMatrix4x4 mvMatrix;
     QMatrix4x4 screenProjectionMatrix;
+    QRectF deformationRect;
+    QVector<QPointF> deformationControlPoints;
+    qreal deformationProgress = 0.0;
 };
 
 WindowPaintData::WindowPaintData(EffectWindow *w)
@@ -264,6 +267,9 @@ WindowPaintData::WindowPaintData(const WindowPaintData &other)
     setProjectionMatrix(other.projectionMatrix());
     setModelViewMatrix(other.modelViewMatrix());
     d->screenProjectionMatrix = other.d->screenProjectionMatrix;
+    d->deformationRect = other.d->deformationRect;
+    d->deformationControlPoints = other.d->deformationControlPoints;
+    d->deformationProgress = other.d->deformationProgress;
 }
 
 WindowPaintData::~WindowPaintData()
@@ -321,6 +327,76 @@ void WindowPaintData::setCrossFadeProgress(qreal factor)
     d->crossFadeProgress = qBound(qreal(0.0), factor, qreal(1.0));
 }
 
+void WindowPaintData::setDeformation(const QRectF &rect, const QVector<QPointF> &controlPoints, qreal progress)
+{
+    if (controlPoints.count() != 16 || rect.isEmpty()) {
+        resetDeformation();
+        return;
+    }
+    d->deformationRect = rect;
+    d->deformationControlPoints = controlPoints;
+    d->deformationProgress = qBound(qreal(0.0), progress, qreal(1.0));
+}
+
+void WindowPaintData::resetDeformation()
+{
+    d->deformationRect = QRectF();
+    d->deformationControlPoints.clear();
+    d->deformationProgress = 0.0;
+}
+
+bool WindowPaintData::isDeformed() const
+{
+    return !d->deformationControlPoints.isEmpty() && d->deformationProgress != 0.0;
+}
+
+QRectF WindowPaintData::deformationRect() const
+{
+    return d->deformationRect;
+}
+
+QVector<QPointF> WindowPaintData::deformationControlPoints() const
+{
+    return d->deformationControlPoints;
+}
+
+qreal WindowPaintData::deformationProgress() const
+{
+    return d->deformationProgress;
+}
+
+QPointF WindowPaintData::mapDeformed(const QPointF &point) const
+{
+    if (!isDeformed()) {
+        return point;
+    }
+
+    const qreal tx = (point.x() - d->deformationRect.x()) / d->deformationRect.width();
+    const qreal ty = (point.y() - d->deformationRect.y()) / d->deformationRect.height();
+
+    const qreal px[4] = {
+        (1 - tx) * (1 - tx) * (1 - tx),
+        3 * (1 - tx) * (1 - tx) * tx,
+        3 * (1 - tx) * tx * tx,
+        tx * tx * tx
+    };
+    const qreal py[4] = {
+        (1 - ty) * (1 - ty) * (1 - ty),
+        3 * (1 - ty) * (1 - ty) * ty,
+        3 * (1 - ty) * ty * ty,
+        ty * ty * ty
+    };
+
+    QPointF deformed;
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            deformed += px[i] * py[j] * d->deformationControlPoints.at(j * 4 + i);
+        }
+    }
+
+    return point + (deformed - point) * d->deformationProgress;
+}
+
 qreal WindowPaintData::multiplyOpacity(qreal factor)
 {
     d->opacity *= factor;
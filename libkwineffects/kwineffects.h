@@ -85,6 +85,7 @@ class EffectFramePrivate;
 class Effect;
 class WindowQuad;
 class GLShader;
+class GLTexture;
 class XRenderPicture;
 class WindowQuadList;
 class WindowPrePaintData;
@@ -187,7 +188,7 @@ X-KDE-Library=kwin4_effect_cooleffect
 
 #define KWIN_EFFECT_API_MAKE_VERSION( major, minor ) (( major ) << 8 | ( minor ))
 #define KWIN_EFFECT_API_VERSION_MAJOR 0
-#define KWIN_EFFECT_API_VERSION_MINOR 228
+#define KWIN_EFFECT_API_VERSION_MINOR 230
 #define KWIN_EFFECT_API_VERSION KWIN_EFFECT_API_MAKE_VERSION( \
         KWIN_EFFECT_API_VERSION_MAJOR, KWIN_EFFECT_API_VERSION_MINOR )
 
@@ -1138,6 +1139,48 @@ public:
      * @return QPainter* The Scene's QPainter or @c null.
      */
     virtual QPainter *scenePainter() = 0;
+
+    /**
+     * @brief Requests that the composited screen gets captured into a texture.
+     *
+     * As long as at least one Effect holds a reservation the compositor keeps one texture per
+     * output. Each frame the areas repainted on that output are copied into it, right after the
+     * Scene painted the screen and before any Effect paints on top of it in its paintScreen.
+     * Effects which need the content of the screen, e.g. to magnify it, should sample
+     * screenCaptureTexture() instead of rendering or blitting the screen themselves.
+     *
+     * The capture is only available with OpenGL compositing and if the hardware supports
+     * framebuffer blits. When an Effect is destroyed its reservation is released automatically.
+     *
+     * @param effect The Effect requesting the screen capture
+     * @see unreserveScreenCapture
+     * @see screenCaptureTexture
+     * @since 5.18
+     */
+    virtual void reserveScreenCapture(Effect *effect) = 0;
+    /**
+     * @brief Releases a reservation made with reserveScreenCapture.
+     *
+     * Once no Effect holds a reservation any more the capture textures are destroyed.
+     *
+     * @param effect The Effect which no longer needs the screen capture
+     * @since 5.18
+     */
+    virtual void unreserveScreenCapture(Effect *effect) = 0;
+    /**
+     * @brief The captured screen content of the output currently being painted.
+     *
+     * The texture covers GLRenderTarget::virtualScreenGeometry() scaled by
+     * GLRenderTarget::virtualScreenScale(). Its content is stored bottom-up, like the
+     * framebuffer it got copied from. Only valid after the Effect called
+     * EffectsHandler::paintScreen in its paintScreen.
+     *
+     * @returns The capture texture or @c null if the capture is not available for this frame
+     * @see reserveScreenCapture
+     * @since 5.18
+     */
+    virtual GLTexture *screenCaptureTexture() const = 0;
+
     virtual void reconfigure() = 0;
 
     virtual QByteArray readRootProperty(long atom, long type, int format) const = 0;
@@ -2862,6 +2905,58 @@ public:
      */
     qreal crossFadeProgress() const;
 
+    /**
+     * @brief Deforms the window by a bicubic Bezier surface.
+     *
+     * The surface maps the rectangle @p rect onto the patch spanned by the 4x4
+     * @p controlPoints, which are given row by row. Both are in window coordinates.
+     * The @p progress blends between the undeformed (@c 0.0) and the fully deformed
+     * (@c 1.0) window.
+     *
+     * The vertices are displaced on the GPU, the effect only has to subdivide the
+     * window quads, e.g. with WindowQuadList::makeRegularGrid(), and does not need
+     * to move them itself. This is only supported by the OpenGL compositor.
+     *
+     * @param rect The area of the window covered by the surface
+     * @param controlPoints The 16 control points of the surface
+     * @param progress The deformation factor between @c 0.0 and @c 1.0
+     * @see resetDeformation
+     * @since 5.18
+     */
+    void setDeformation(const QRectF &rect, const QVector<QPointF> &controlPoints, qreal progress = 1.0);
+    /**
+     * Removes the deformation set with setDeformation().
+     * @since 5.18
+     */
+    void resetDeformation();
+    /**
+     * @returns @c true if a deformation has been set with setDeformation()
+     * @since 5.18
+     */
+    bool isDeformed() const;
+    /**
+     * @see setDeformation
+     * @since 5.18
+     */
+    QRectF deformationRect() const;
+    /**
+     * @see setDeformation
+     * @since 5.18
+     */
+    QVector<QPointF> deformationControlPoints() const;
+    /**
+     * @see setDeformation
+     * @since 5.18
+     */
+    qreal deformationProgress() const;
+    /**
+     * Maps the @p point, in window coordinates, through the deformation. This
+     * is what the vertex shader does for each vertex and can be used to compute
+     * the area covered by the deformed window.
+     * @since 5.18
+     */
+    QPointF mapDeformed(const QPointF &point) const;
+
     /**
      * Sets the projection matrix that will be used when painting the window.
      *
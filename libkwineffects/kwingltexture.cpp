@@ -50,6 +50,8 @@ bool GLTexturePrivate::s_supportsTextureSwizzle = false;
 bool GLTexturePrivate::s_supportsTextureFormatRG = false;
 uint GLTexturePrivate::s_textureObjectCounter = 0;
 uint GLTexturePrivate::s_fbo = 0;
+qint64 GLTexturePrivate::s_memoryUsage[int(GLTexture::MemoryCategory::Effect) + 1] = {};
+qint64 GLTexturePrivate::s_memoryBudget = 0;
 
 
 GLTexture::GLTexture()
@@ -178,6 +180,7 @@ GLTexture::GLTexture(const QImage& image, GLenum target)
 
     unbind();
     setFilter(GL_LINEAR);
+    d->updateMemoryUsage();
 }
 
 GLTexture::GLTexture(const QPixmap& pixmap, GLenum target)
@@ -232,6 +235,7 @@ GLTexture::GLTexture(GLenum internalFormat, int width, int height, int levels)
     }
 
     unbind();
+    d->updateMemoryUsage();
 }
 
 GLTexture::GLTexture(GLenum internalFormat, const QSize &size, int levels)
@@ -265,12 +269,15 @@ GLTexturePrivate::GLTexturePrivate()
  , m_unnormalizeActive(0)
  , m_normalizeActive(0)
  , m_vbo(nullptr)
+ , m_memoryUsage(0)
+ , m_memoryCategory(GLTexture::MemoryCategory::Other)
 {
     ++s_textureObjectCounter;
 }
 
 GLTexturePrivate::~GLTexturePrivate()
 {
+    s_memoryUsage[int(m_memoryCategory)] -= m_memoryUsage;
     delete m_vbo;
     if (m_texture != 0) {
         glDeleteTextures(1, &m_texture);
@@ -282,6 +289,41 @@ GLTexturePrivate::~GLTexturePrivate()
     }
 }
 
+static int bytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat) {
+    case GL_R8:
+        return 1;
+    case GL_RG8:
+    case GL_RGB4:
+    case GL_RGB5:
+    case GL_RGBA4:
+    case GL_R16F:
+        return 2;
+    case GL_RGBA16F:
+        return 8;
+    case GL_RGBA32F:
+        return 16;
+    default:
+        // GL_RGB8 is padded to four bytes by the drivers as well
+        return 4;
+    }
+}
+
+void GLTexturePrivate::updateMemoryUsage()
+{
+    qint64 usage = 0;
+    if (m_texture != 0 && m_size.isValid()) {
+        usage = qint64(m_size.width()) * m_size.height() * bytesPerPixel(m_internalFormat);
+        if (m_mipLevels > 1) {
+            // the mipmap chain adds a third
+            usage += usage / 3;
+        }
+    }
+    s_memoryUsage[int(m_memoryCategory)] += usage - m_memoryUsage;
+    m_memoryUsage = usage;
+}
+
 void GLTexturePrivate::initStatic()
 {
     if (!GLPlatform::instance()->isGLES()) {
@@ -381,6 +423,58 @@ void GLTexture::update(const QImage &image, const QPoint &offset, const QRect &s
     }
 }
 
+void GLTexture::setMemoryCategory(MemoryCategory category)
+{
+    Q_D(GLTexture);
+    if (d->m_memoryCategory == category) {
+        return;
+    }
+    d->s_memoryUsage[int(d->m_memoryCategory)] -= d->m_memoryUsage;
+    d->s_memoryUsage[int(category)] += d->m_memoryUsage;
+    d->m_memoryCategory = category;
+}
+
+GLTexture::MemoryCategory GLTexture::memoryCategory() const
+{
+    Q_D(const GLTexture);
+    return d->m_memoryCategory;
+}
+
+qint64 GLTexture::memoryUsage() const
+{
+    Q_D(const GLTexture);
+    return d->m_memoryUsage;
+}
+
+qint64 GLTexture::memoryUsage(MemoryCategory category)
+{
+    return GLTexturePrivate::s_memoryUsage[int(category)];
+}
+
+qint64 GLTexture::totalMemoryUsage()
+{
+    qint64 total = 0;
+    for (qint64 usage : GLTexturePrivate::s_memoryUsage) {
+        total += usage;
+    }
+    return total;
+}
+
+qint64 GLTexture::memoryBudget()
+{
+    return GLTexturePrivate::s_memoryBudget;
+}
+
+void GLTexture::setMemoryBudget(qint64 bytes)
+{
+    GLTexturePrivate::s_memoryBudget = qMax<qint64>(bytes, 0);
+}
+
+bool GLTexture::isOverMemoryBudget()
+{
+    return GLTexturePrivate::s_memoryBudget > 0 && totalMemoryUsage() > GLTexturePrivate::s_memoryBudget;
+}
+
 void GLTexture::discard()
 {
     d_ptr = new GLTexturePrivate();
@@ -52,6 +52,20 @@ enum TextureCoordinateType {
 class KWINGLUTILS_EXPORT GLTexture
 {
 public:
+    /**
+     * What a texture is used for, memory usage is accounted per category.
+     * @since 5.18
+     */
+    enum class MemoryCategory {
+        Other,
+        WindowPixmap,
+        PreviousWindowPixmap,
+        Decoration,
+        Shadow,
+        Cache,
+        Effect
+    };
+
     GLTexture();
     GLTexture(const GLTexture& tex);
     explicit GLTexture(const QImage& image, GLenum target = GL_TEXTURE_2D);
@@ -137,6 +151,47 @@ public:
      */
     static bool supportsFormatRG();
 
+    /**
+     * Sets the category this texture's memory is accounted for. Textures start in
+     * MemoryCategory::Other. All copies of the texture share the category.
+     * @since 5.18
+     */
+    void setMemoryCategory(MemoryCategory category);
+    /**
+     * @since 5.18
+     */
+    MemoryCategory memoryCategory() const;
+    /**
+     * Estimated size of the texture's storage in bytes, including all mipmap levels.
+     * @since 5.18
+     */
+    qint64 memoryUsage() const;
+    /**
+     * Estimated size in bytes of all textures in @p category.
+     * @since 5.18
+     */
+    static qint64 memoryUsage(MemoryCategory category);
+    /**
+     * Estimated size in bytes of all textures.
+     * @since 5.18
+     */
+    static qint64 totalMemoryUsage();
+    /**
+     * The number of bytes the compositor tries to stay below by dropping caches,
+     * @c 0 if there is no budget.
+     * @since 5.18
+     */
+    static qint64 memoryBudget();
+    /**
+     * @since 5.18
+     */
+    static void setMemoryBudget(qint64 bytes);
+    /**
+     * Whether a budget is set and totalMemoryUsage() exceeds it.
+     * @since 5.18
+     */
+    static bool isOverMemoryBudget();
+
 protected:
     QExplicitlySharedDataPointer<GLTexturePrivate> d_ptr;
     GLTexture(GLTexturePrivate& dd);
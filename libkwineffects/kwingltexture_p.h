@@ -48,6 +48,10 @@ public:
     virtual void onDamage();
 
     void updateMatrix();
+    /**
+     * Recalculates m_memoryUsage from the size and format, call whenever the storage changes.
+     */
+    void updateMemoryUsage();
 
     GLuint m_texture;
     GLenum m_target;
@@ -69,6 +73,8 @@ public:
     int m_normalizeActive; // 0 - no, otherwise refcount
     GLVertexBuffer* m_vbo;
     QSize m_cachedSize;
+    qint64 m_memoryUsage;
+    GLTexture::MemoryCategory m_memoryCategory;
 
     static void initStatic();
 
@@ -80,6 +86,8 @@ public:
     static bool s_supportsTextureFormatRG;
     static GLuint s_fbo;
     static uint s_textureObjectCounter;
+    static qint64 s_memoryUsage[int(GLTexture::MemoryCategory::Effect) + 1];
+    static qint64 s_memoryBudget;
 private:
     friend void KWin::cleanupGL();
     static void cleanup();
@@ -89,6 +89,7 @@ void cleanupGL()
     GLTexturePrivate::cleanup();
     GLRenderTarget::cleanup();
     GLVertexBuffer::cleanup();
+    GLProfiler::cleanup();
     GLPlatform::cleanup();
 
     glExtensions.clear();
@@ -143,6 +144,42 @@ bool checkGLError(const char* txt)
     return hasError;
 }
 
+QMatrix4x4 yuvToRgbMatrix(YuvCoefficients coefficients, YuvRange range)
+{
+    float kr, kb;
+    switch (coefficients) {
+    case YuvCoefficients::BT709:
+        kr = 0.2126f;
+        kb = 0.0722f;
+        break;
+    case YuvCoefficients::BT601:
+    default:
+        kr = 0.299f;
+        kb = 0.114f;
+        break;
+    }
+    const float kg = 1.0f - kr - kb;
+
+    // expands the sampled values to Y in [0, 1] and Cb, Cr in [-0.5, 0.5]
+    QMatrix4x4 expand;
+    if (range == YuvRange::Limited) {
+        expand = QMatrix4x4(255.0f / 219.0f, 0.0f,            0.0f,            -16.0f / 219.0f,
+                            0.0f,            255.0f / 224.0f, 0.0f,            -128.0f / 224.0f,
+                            0.0f,            0.0f,            255.0f / 224.0f, -128.0f / 224.0f,
+                            0.0f,            0.0f,            0.0f,            1.0f);
+    } else {
+        expand = QMatrix4x4(1.0f, 0.0f, 0.0f, 0.0f,
+                            0.0f, 1.0f, 0.0f, -128.0f / 255.0f,
+                            0.0f, 0.0f, 1.0f, -128.0f / 255.0f,
+                            0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    const QMatrix4x4 toRgb(1.0f, 0.0f,                             2.0f * (1.0f - kr),               0.0f,
+                           1.0f, -2.0f * kb * (1.0f - kb) / kg, -2.0f * kr * (1.0f - kr) / kg, 0.0f,
+                           1.0f, 2.0f * (1.0f - kb),               0.0f,                             0.0f,
+                           0.0f, 0.0f,                             0.0f,                             1.0f);
+    return toRgb * expand;
+}
+
 //****************************************
 // GLShader
 //****************************************
@@ -339,12 +376,17 @@ void GLShader::resolveLocations()
     mMatrixLocation[ModelViewProjectionMatrix]  = uniformLocation("modelViewProjectionMatrix");
     mMatrixLocation[WindowTransformation]       = uniformLocation("windowTransformation");
     mMatrixLocation[ScreenTransformation]       = uniformLocation("screenTransformation");
+    mMatrixLocation[DeformationX]               = uniformLocation("deformationX");
+    mMatrixLocation[DeformationY]               = uniformLocation("deformationY");
+    mMatrixLocation[YuvToRgbMatrix]             = uniformLocation("yuvToRgb");
 
     mVec2Location[Offset] = uniformLocation("offset");
 
     mVec4Location[ModulationConstant] = uniformLocation("modulation");
+    mVec4Location[DeformationRect]    = uniformLocation("deformationRect");
 
-    mFloatLocation[Saturation]    = uniformLocation("saturation");
+    mFloatLocation[Saturation]          = uniformLocation("saturation");
+    mFloatLocation[DeformationProgress] = uniformLocation("deformationProgress");
 
     mColorLocation[Color] = uniformLocation("geometryColor");
 
@@ -820,11 +862,33 @@ QByteArray ShaderManager::generateVertexSource(ShaderTraits traits) const
 
     stream << "uniform mat4 modelViewProjectionMatrix;\n\n";
 
+    if (traits & ShaderTrait::Deform) {
+        // The control points of the bicubic Bezier surface, x and y coordinates
+        // separately with one row of control points per matrix row
+        stream << "uniform mat4 deformationX;\n";
+        stream << "uniform mat4 deformationY;\n";
+        stream << "uniform vec4 deformationRect;\n";
+        stream << "uniform float deformationProgress;\n\n";
+
+        stream << "vec4 bernstein(float t)\n{\n";
+        stream << "    float s = 1.0 - t;\n";
+        stream << "    return vec4(s * s * s, 3.0 * s * s * t, 3.0 * s * t * t, t * t * t);\n";
+        stream << "}\n\n";
+    }
+
     stream << "void main()\n{\n";
     if (traits & ShaderTrait::MapTexture)
         stream << "    texcoord0 = texcoord.st;\n";
 
-    stream << "    gl_Position = modelViewProjectionMatrix * position;\n";
+    if (traits & ShaderTrait::Deform) {
+        stream << "    vec2 t = (position.xy - deformationRect.xy) / deformationRect.zw;\n";
+        stream << "    vec4 bx = bernstein(t.x);\n";
+        stream << "    vec4 by = bernstein(t.y);\n";
+        stream << "    vec2 deformed = vec2(dot(by, deformationX * bx), dot(by, deformationY * bx));\n";
+        stream << "    gl_Position = modelViewProjectionMatrix * vec4(mix(position.xy, deformed, deformationProgress), position.zw);\n";
+    } else {
+        stream << "    gl_Position = modelViewProjectionMatrix * position;\n";
+    }
     stream << "}\n";
 
     stream.flush();
@@ -864,9 +928,18 @@ QByteArray ShaderManager::generateFragmentSource(ShaderTraits traits) const
         output        = glsl_es_300 ? QByteArrayLiteral("fragColor")  : QByteArrayLiteral("gl_FragColor");
     }
 
+    const ShaderTraits yuvTraits = traits & (ShaderTrait::YuvTwoPlanes | ShaderTrait::YuvThreePlanes | ShaderTrait::YuvPackedChroma);
+
     if (traits & ShaderTrait::MapTexture) {
         stream << "uniform sampler2D sampler;\n";
 
+        if (yuvTraits) {
+            stream << "uniform sampler2D sampler1;\n";
+            if (yuvTraits & ShaderTrait::YuvThreePlanes)
+                stream << "uniform sampler2D sampler2;\n";
+            stream << "uniform mat4 yuvToRgb;\n";
+        }
+
         if (traits & ShaderTrait::Modulate)
             stream << "uniform vec4 modulation;\n";
         if (traits & ShaderTrait::AdjustSaturation)
@@ -882,8 +955,22 @@ QByteArray ShaderManager::generateFragmentSource(ShaderTraits traits) const
 
     stream << "\nvoid main(void)\n{\n";
     if (traits & ShaderTrait::MapTexture) {
-        if (traits & (ShaderTrait::Modulate | ShaderTrait::AdjustSaturation)) {
-            stream << "    vec4 texel = " << textureLookup << "(sampler, texcoord0);\n";
+        if (yuvTraits || traits & (ShaderTrait::Modulate | ShaderTrait::AdjustSaturation)) {
+            if (yuvTraits) {
+                stream << "    vec3 yuv;\n";
+                stream << "    yuv.x = " << textureLookup << "(sampler, texcoord0).r;\n";
+                if (yuvTraits & ShaderTrait::YuvTwoPlanes) {
+                    stream << "    yuv.yz = " << textureLookup << "(sampler1, texcoord0).rg;\n";
+                } else if (yuvTraits & ShaderTrait::YuvThreePlanes) {
+                    stream << "    yuv.y = " << textureLookup << "(sampler1, texcoord0).r;\n";
+                    stream << "    yuv.z = " << textureLookup << "(sampler2, texcoord0).r;\n";
+                } else {
+                    stream << "    yuv.yz = " << textureLookup << "(sampler1, texcoord0).ga;\n";
+                }
+                stream << "    vec4 texel = vec4((yuvToRgb * vec4(yuv, 1.0)).rgb, 1.0);\n";
+            } else {
+                stream << "    vec4 texel = " << textureLookup << "(sampler, texcoord0);\n";
+            }
 
             if (traits & ShaderTrait::Modulate)
                 stream << "    texel *= modulation;\n";
@@ -928,6 +1015,18 @@ GLShader *ShaderManager::generateCustomShader(ShaderTraits traits, const QByteAr
     shader->bindFragDataLocation("fragColor", 0);
 
     shader->link();
+
+    if (shader->isValid() && traits & (ShaderTrait::YuvTwoPlanes | ShaderTrait::YuvThreePlanes | ShaderTrait::YuvPackedChroma)) {
+        // the chroma planes are always bound to the texture units 1 and 2
+        shader->bind();
+        shader->setUniform("sampler1", 1);
+        shader->setUniform("sampler2", 2);
+        if (GLShader *bound = getBoundShader()) {
+            bound->bind();
+        } else {
+            shader->unbind();
+        }
+    }
     return shader;
 }
 
@@ -1046,6 +1145,7 @@ GLShader *ShaderManager::loadShaderFromCode(const QByteArray &vertexSource, cons
 bool GLRenderTarget::sSupported = false;
 bool GLRenderTarget::s_blitSupported = false;
 QStack<GLRenderTarget*> GLRenderTarget::s_renderTargets = QStack<GLRenderTarget*>();
+GLRenderTarget *GLRenderTarget::s_screenRenderTarget = nullptr;
 QSize GLRenderTarget::s_virtualScreenSize;
 QRect GLRenderTarget::s_virtualScreenGeometry;
 qreal GLRenderTarget::s_virtualScreenScale = 1.0;
@@ -1070,6 +1170,7 @@ void GLRenderTarget::initStatic()
 void GLRenderTarget::cleanup()
 {
     Q_ASSERT(s_renderTargets.isEmpty());
+    s_screenRenderTarget = nullptr;
     sSupported = false;
     s_blitSupported = false;
 }
@@ -1079,6 +1180,22 @@ bool GLRenderTarget::isRenderTargetBound()
     return !s_renderTargets.isEmpty();
 }
 
+void GLRenderTarget::setScreenRenderTarget(GLRenderTarget *target)
+{
+    Q_ASSERT(s_renderTargets.isEmpty());
+    s_screenRenderTarget = target;
+    if (target) {
+        target->enable();
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+}
+
+GLRenderTarget *GLRenderTarget::screenRenderTarget()
+{
+    return s_screenRenderTarget;
+}
+
 bool GLRenderTarget::blitSupported()
 {
     return s_blitSupported;
@@ -1111,6 +1228,9 @@ GLRenderTarget* GLRenderTarget::popRenderTarget()
         s_renderTargets.top()->enable();
     } else {
         ret->disable();
+        if (s_screenRenderTarget) {
+            s_screenRenderTarget->enable();
+        }
         glViewport (s_virtualScreenViewport[0], s_virtualScreenViewport[1], s_virtualScreenViewport[2], s_virtualScreenViewport[3]);
     }
 
@@ -1174,7 +1294,12 @@ bool GLRenderTarget::disable()
         return false;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // the screen render target stands in for the default framebuffer
+    if (s_screenRenderTarget && s_screenRenderTarget != this && s_screenRenderTarget->valid()) {
+        glBindFramebuffer(GL_FRAMEBUFFER, s_screenRenderTarget->mFramebuffer);
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
     mTexture.setDirty();
 
     return true;
@@ -1220,6 +1345,10 @@ void GLRenderTarget::initFBO()
         qCCritical(LIBKWINGLUTILS) << "Error status when entering GLRenderTarget::initFBO: " << formatGLError(err);
 #endif
 
+    // render targets can be created while painting, so restore whatever is bound
+    GLint previousFramebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
     glGenFramebuffers(1, &mFramebuffer);
 
 #if DEBUG_GLRENDERTARGET
@@ -1245,7 +1374,7 @@ void GLRenderTarget::initFBO()
 #if DEBUG_GLRENDERTARGET
     if ((err = glGetError()) != GL_NO_ERROR) {
         qCCritical(LIBKWINGLUTILS) << "glFramebufferTexture2D failed: " << formatGLError(err);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
         glDeleteFramebuffers(1, &mFramebuffer);
         return;
     }
@@ -1253,7 +1382,7 @@ void GLRenderTarget::initFBO()
 
     const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
 
     if (status != GL_FRAMEBUFFER_COMPLETE) {
         // We have an incomplete framebuffer, consider it invalid
@@ -1280,7 +1409,7 @@ void GLRenderTarget::blitFromFramebuffer(const QRect &source, const QRect &desti
 
     GLRenderTarget::pushRenderTarget(this);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffer);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, s_screenRenderTarget ? s_screenRenderTarget->mFramebuffer : 0);
     const QRect s = source.isNull() ? s_virtualScreenGeometry : source;
     const QRect d = destination.isNull() ? QRect(0, 0, mTexture.width(), mTexture.height()) : destination;
 
@@ -2314,4 +2443,198 @@ GLVertexBuffer *GLVertexBuffer::streamingBuffer()
     return GLVertexBufferPrivate::streamingBuffer;
 }
 
+/***  GLProfiler  ***/
+bool GLProfiler::s_enabled = false;
+
+namespace
+{
+
+struct ProfilerQuery
+{
+    QString name;
+    int depth;
+    GLuint begin;
+    GLuint end;
+};
+
+struct ProfilerFrame
+{
+    QVector<ProfilerQuery> queries;
+    // issued last, its result is available once the GPU finished the frame
+    GLuint lastQuery;
+};
+
+}
+
+// frames are dropped rather than waiting for the GPU if it falls further behind
+static const std::size_t s_maxPendingFrames = 4;
+
+static bool s_profilingFrame = false;
+static QVector<ProfilerQuery> s_currentQueries;
+static QStack<int> s_openQueries;
+static GLuint s_lastQuery = 0;
+static std::deque<ProfilerFrame> s_pendingFrames;
+static QVector<GLuint> s_freeQueries;
+static GLProfiler::Frame s_lastFrame;
+static quint64 s_frameSequence = 0;
+
+static GLuint acquireTimestampQuery()
+{
+    GLuint query;
+    if (s_freeQueries.isEmpty()) {
+        glGenQueries(1, &query);
+    } else {
+        query = s_freeQueries.takeLast();
+    }
+    glQueryCounter(query, GL_TIMESTAMP);
+    s_lastQuery = query;
+    return query;
+}
+
+static void readBackFrames()
+{
+    while (!s_pendingFrames.empty()) {
+        const ProfilerFrame &frame = s_pendingFrames.front();
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLProfiler::Frame result;
+        result.sequence = ++s_frameSequence;
+        result.passes.reserve(frame.queries.count());
+        // the passes which are still open while walking the frame
+        QStack<int> parents;
+        for (const ProfilerQuery &query : frame.queries) {
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+            s_freeQueries << query.begin << query.end;
+
+            GLProfiler::Pass pass;
+            pass.name = query.name;
+            pass.depth = query.depth;
+            pass.time = end > begin ? end - begin : 0;
+            pass.selfTime = pass.time;
+            while (parents.count() > query.depth) {
+                parents.pop();
+            }
+            if (parents.isEmpty()) {
+                result.time += pass.time;
+            } else {
+                GLProfiler::Pass &parent = result.passes[parents.top()];
+                parent.selfTime = qMax<qint64>(0, parent.selfTime - pass.time);
+            }
+            parents.push(result.passes.count());
+            result.passes << pass;
+        }
+        s_lastFrame = result;
+        s_pendingFrames.pop_front();
+    }
+}
+
+bool GLProfiler::isSupported()
+{
+    if (GLPlatform::instance()->isGLES()) {
+        return false;
+    }
+    return hasGLVersion(3, 3) || hasGLExtension(QByteArrayLiteral("GL_ARB_timer_query"));
+}
+
+void GLProfiler::setEnabled(bool enabled)
+{
+    // there would never be a frame to report
+    s_enabled = enabled && isSupported();
+}
+
+void GLProfiler::beginFrame()
+{
+    // left over if the previous frame got aborted
+    for (const ProfilerQuery &query : qAsConst(s_currentQueries)) {
+        s_freeQueries << query.begin;
+        if (query.end) {
+            s_freeQueries << query.end;
+        }
+    }
+    s_currentQueries.clear();
+    s_openQueries.clear();
+    s_profilingFrame = s_enabled && s_pendingFrames.size() < s_maxPendingFrames && isSupported();
+}
+
+void GLProfiler::endFrame()
+{
+    if (s_profilingFrame) {
+        while (!s_openQueries.isEmpty()) {
+            end();
+        }
+        if (!s_currentQueries.isEmpty()) {
+            ProfilerFrame frame;
+            frame.queries.swap(s_currentQueries);
+            frame.lastQuery = s_lastQuery;
+            s_pendingFrames.push_back(frame);
+        }
+        s_profilingFrame = false;
+    }
+    if (s_pendingFrames.empty() && s_freeQueries.isEmpty()) {
+        return;
+    }
+    readBackFrames();
+    if (!s_enabled && s_pendingFrames.empty() && !s_freeQueries.isEmpty()) {
+        glDeleteQueries(s_freeQueries.count(), s_freeQueries.constData());
+        s_freeQueries.clear();
+    }
+}
+
+void GLProfiler::begin(const QString &name)
+{
+    if (!s_profilingFrame) {
+        return;
+    }
+    ProfilerQuery query;
+    query.name = name;
+    query.depth = s_openQueries.count();
+    query.begin = acquireTimestampQuery();
+    query.end = 0;
+    s_openQueries.push(s_currentQueries.count());
+    s_currentQueries << query;
+}
+
+void GLProfiler::end()
+{
+    if (!s_profilingFrame || s_openQueries.isEmpty()) {
+        return;
+    }
+    s_currentQueries[s_openQueries.pop()].end = acquireTimestampQuery();
+}
+
+GLProfiler::Frame GLProfiler::lastFrame()
+{
+    return s_lastFrame;
+}
+
+void GLProfiler::cleanup()
+{
+    for (const ProfilerFrame &frame : s_pendingFrames) {
+        for (const ProfilerQuery &query : frame.queries) {
+            s_freeQueries << query.begin << query.end;
+        }
+    }
+    for (const ProfilerQuery &query : qAsConst(s_currentQueries)) {
+        s_freeQueries << query.begin;
+        if (query.end) {
+            s_freeQueries << query.end;
+        }
+    }
+    if (!s_freeQueries.isEmpty()) {
+        glDeleteQueries(s_freeQueries.count(), s_freeQueries.constData());
+        s_freeQueries.clear();
+    }
+    s_pendingFrames.clear();
+    s_currentQueries.clear();
+    s_openQueries.clear();
+    s_profilingFrame = false;
+    s_lastFrame = GLProfiler::Frame();
+}
+
 } // namespace
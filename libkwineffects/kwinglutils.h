@@ -30,6 +30,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // Qt
 #include <QSize>
 #include <QStack>
+#include <QString>
+#include <QVector>
 
 /** @addtogroup kwineffects */
 /** @{ */
@@ -119,6 +121,9 @@ public:
         ModelViewProjectionMatrix,
         WindowTransformation,
         ScreenTransformation,
+        DeformationX,
+        DeformationY,
+        YuvToRgbMatrix, ///< @since 5.18
         MatrixCount
     };
 
@@ -129,11 +134,13 @@ public:
 
     enum Vec4Uniform {
         ModulationConstant,
+        DeformationRect,
         Vec4UniformCount
     };
 
     enum FloatUniform {
         Saturation,
+        DeformationProgress,
         FloatUniformCount
     };
 
@@ -186,10 +193,51 @@ enum class ShaderTrait {
     UniformColor     = (1 << 1),
     Modulate         = (1 << 2),
     AdjustSaturation = (1 << 3),
+    Deform           = (1 << 4), ///< @since 5.18, displaces the vertices by a Bezier surface, see WindowPaintData::setDeformation()
+    /**
+     * @since 5.18, samples luma from the red channel of the texture and Cb/Cr from the red and green
+     * channels of the texture bound to unit 1 (NV12, P010). Requires MapTexture.
+     */
+    YuvTwoPlanes     = (1 << 5),
+    /**
+     * @since 5.18, samples luma, Cb and Cr from the red channels of the textures bound to
+     * the units 0, 1 and 2 (YUV420, YUV444). Requires MapTexture.
+     */
+    YuvThreePlanes   = (1 << 6),
+    /**
+     * @since 5.18, samples luma from the red channel of the texture and Cb/Cr from the green and alpha
+     * channels of the texture bound to unit 1 (YUYV). Requires MapTexture.
+     */
+    YuvPackedChroma  = (1 << 7),
 };
 
 Q_DECLARE_FLAGS(ShaderTraits, ShaderTrait)
 
+/**
+ * The matrix coefficients of a YUV encoded image.
+ * @since 5.18
+ */
+enum class YuvCoefficients {
+    BT601,
+    BT709
+};
+
+/**
+ * The quantization range of a YUV encoded image.
+ * @since 5.18
+ */
+enum class YuvRange {
+    Limited, ///< luma in [16, 235], chroma in [16, 240]
+    Full
+};
+
+/**
+ * The matrix converting the (Y, Cb, Cr, 1) vector sampled by a shader with one of the
+ * Yuv ShaderTraits to RGB, set it as GLShader::YuvToRgbMatrix.
+ * @since 5.18
+ */
+QMatrix4x4 KWINGLUTILS_EXPORT yuvToRgbMatrix(YuvCoefficients coefficients, YuvRange range);
+
 
 /**
  * @short Manager for Shaders.
@@ -478,6 +526,22 @@ public:
     static void pushRenderTarget(GLRenderTarget *target);
     static GLRenderTarget *popRenderTarget();
     static bool isRenderTargetBound();
+    /**
+     * Makes @p target the framebuffer the screen gets rendered into, instead of the default
+     * framebuffer of the window system. Passing @c nullptr switches back to the default framebuffer.
+     *
+     * The target is bound when the last render target gets popped and blitFromFramebuffer reads
+     * from it. It is not part of the render target stack, so isRenderTargetBound is not affected.
+     * Used by the compositor to render into its own back buffer.
+     * @since 5.18
+     */
+    static void setScreenRenderTarget(GLRenderTarget *target);
+    /**
+     * @returns the framebuffer the screen gets rendered into, @c nullptr for the default framebuffer
+     * @see setScreenRenderTarget
+     * @since 5.18
+     */
+    static GLRenderTarget *screenRenderTarget();
     /**
      * Whether the GL_EXT_framebuffer_blit extension is supported.
      * This functionality is not available in OpenGL ES 2.0.
@@ -555,6 +619,7 @@ private:
     static bool sSupported;
     static bool s_blitSupported;
     static QStack<GLRenderTarget*> s_renderTargets;
+    static GLRenderTarget *s_screenRenderTarget;
     static QSize s_virtualScreenSize;
     static QRect s_virtualScreenGeometry;
     static qreal s_virtualScreenScale;
@@ -816,6 +881,103 @@ private:
     static qreal s_virtualScreenScale;
 };
 
+/**
+ * @short Measures the GPU time of the passes of a frame.
+ *
+ * While enabled, each pass between begin() and end() is bracketed by timestamp
+ * queries. Passes can be nested, e.g. an effect painting a window inside the pass
+ * of the screen. The results are read back a few frames later, once the GPU has
+ * finished the frame, so profiling doesn't stall the pipeline.
+ *
+ * Requires OpenGL 3.3 or GL_ARB_timer_query, not supported on OpenGL ES.
+ *
+ * @see GLProfilerScope
+ * @since 5.18
+ */
+class KWINGLUTILS_EXPORT GLProfiler
+{
+public:
+    struct Pass {
+        QString name;
+        // nesting level, 0 for the outermost passes
+        int depth = 0;
+        // in nanoseconds, including the nested passes
+        qint64 time = 0;
+        // in nanoseconds, excluding the nested passes
+        qint64 selfTime = 0;
+    };
+    struct Frame {
+        // counts the profiled frames
+        quint64 sequence = 0;
+        // in nanoseconds, the sum of all outermost passes
+        qint64 time = 0;
+        // in the order the passes began
+        QVector<Pass> passes;
+    };
+
+    static bool isSupported();
+    static bool isEnabled() {
+        return s_enabled;
+    }
+    /**
+     * Enabling the profiler has no effect if it is not supported.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * Starts collecting the passes of a new frame. Called by the Scene.
+     */
+    static void beginFrame();
+    /**
+     * Ends the frame started with beginFrame() and reads back the results of
+     * earlier frames the GPU has finished. Called by the Scene with the context current.
+     */
+    static void endFrame();
+    static void begin(const QString &name);
+    static void end();
+
+    /**
+     * The breakdown of the most recent frame the GPU has finished.
+     */
+    static Frame lastFrame();
+
+    /**
+     * @internal
+     */
+    static void cleanup();
+
+private:
+    static bool s_enabled;
+};
+
+/**
+ * @short Profiles the lifetime of the scope as a pass of GLProfiler.
+ *
+ * Does nothing if the profiler is not enabled.
+ *
+ * @since 5.18
+ */
+class KWINGLUTILS_EXPORT GLProfilerScope
+{
+public:
+    explicit GLProfilerScope(const QString &name)
+        : m_active(GLProfiler::isEnabled())
+    {
+        if (m_active) {
+            GLProfiler::begin(name);
+        }
+    }
+    ~GLProfilerScope() {
+        if (m_active) {
+            GLProfiler::end();
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(GLProfilerScope)
+    bool m_active;
+};
+
 } // namespace
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(KWin::ShaderTraits)
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <config-kwin.h>
 // kwin
 #include "platform.h"
+#include "replay_trace.h"
 #include "effects.h"
 #include "tabletmodemanager.h"
 #include "wayland_server.h"
@@ -191,6 +192,10 @@ void ApplicationWayland::finalizeStartup()
     }
     startSession();
     createWorkspace();
+    const QString replayTrace = qEnvironmentVariable("KWIN_REPLAY_RECORD");
+    if (!replayTrace.isEmpty()) {
+        new ReplayRecorder(replayTrace, this);
+    }
     notifyKSplash();
 }
 
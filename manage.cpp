@@ -28,6 +28,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef KWIN_BUILD_ACTIVITIES
 #include "activities.h"
 #endif
+#include "atoms.h"
 #include "composite.h"
 #include "cursor.h"
 #include "rules.h"
@@ -42,17 +43,54 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace KWin
 {
 
+ClientManageRequests::ClientManageRequests(xcb_window_t window)
+    : ClientManageRequests(window, Xcb::WindowAttributes(window), Xcb::WindowGeometry(window))
+{
+}
+
+ClientManageRequests::ClientManageRequests(xcb_window_t window, const Xcb::WindowAttributes &attributes, const Xcb::WindowGeometry &geometry)
+    : m_window(window)
+    , m_attributes(attributes)
+    , m_geometry(geometry)
+    , m_wmClientLeader(Client::fetchWmClientLeader(window))
+    , m_skipCloseAnimation(Client::fetchSkipCloseAnimation(window))
+    , m_gtkFrameExtents(Client::fetchGtkFrameExtents(window))
+    , m_showOnScreenEdge(Client::fetchShowOnScreenEdge(window))
+    , m_colorScheme(Client::fetchColorScheme(window))
+    , m_firstInTabBox(Client::fetchFirstInTabBox(window))
+    , m_transient(Client::fetchTransient(window))
+    , m_activities(Client::fetchActivities(window))
+    , m_applicationMenuServiceName(Client::fetchApplicationMenuServiceName(window))
+    , m_applicationMenuObjectPath(Client::fetchApplicationMenuObjectPath(window))
+    , m_motif(atoms->motif_wm_hints)
+    , m_wmName(Client::fetchWmName(window))
+    , m_syncCounter(Client::fetchSyncCounter(window))
+{
+    m_geometryHints.init(window);
+    m_motif.init(window);
+    if (Xcb::Extensions::self()->isShapeAvailable()) {
+        m_shapeExtents = Xcb::ShapeExtents(window);
+    }
+}
+
+bool Client::manage(xcb_window_t w, bool isMapped)
+{
+    ClientManageRequests requests(w);
+    return manage(requests, isMapped);
+}
+
 /**
  * Manages the clients. This means handling the very first maprequest:
  * reparenting, initial geometry, initial state, placement, etc.
  * Returns false if KWin is not going to manage this window.
  */
-bool Client::manage(xcb_window_t w, bool isMapped)
+bool Client::manage(ClientManageRequests &requests, bool isMapped)
 {
     StackingUpdatesBlocker stacking_blocker(workspace());
 
-    Xcb::WindowAttributes attr(w);
-    Xcb::WindowGeometry windowGeometry(w);
+    const xcb_window_t w = requests.window();
+    Xcb::WindowAttributes &attr = requests.m_attributes;
+    Xcb::WindowGeometry &windowGeometry = requests.m_geometry;
     if (attr.isNull() || windowGeometry.isNull()) {
         return false;
     }
@@ -95,21 +133,23 @@ bool Client::manage(xcb_window_t w, bool isMapped)
         NET::WM2InitialMappingState |
         NET::WM2IconPixmap |
         NET::WM2OpaqueRegion |
-        NET::WM2DesktopFileName;
-
-    auto wmClientLeaderCookie = fetchWmClientLeader();
-    auto skipCloseAnimationCookie = fetchSkipCloseAnimation();
-    auto gtkFrameExtentsCookie = fetchGtkFrameExtents();
-    auto showOnScreenEdgeCookie = fetchShowOnScreenEdge();
-    auto colorSchemeCookie = fetchColorScheme();
-    auto firstInTabBoxCookie = fetchFirstInTabBox();
-    auto transientCookie = fetchTransient();
-    auto activitiesCookie = fetchActivities();
-    auto applicationMenuServiceNameCookie = fetchApplicationMenuServiceName();
-    auto applicationMenuObjectPathCookie = fetchApplicationMenuObjectPath();
-
-    m_geometryHints.init(window());
-    m_motif.init(window());
+        NET::WM2DesktopFileName |
+        NET::WM2ClientMachine;
+
+    auto &wmClientLeaderCookie = requests.m_wmClientLeader;
+    auto &skipCloseAnimationCookie = requests.m_skipCloseAnimation;
+    auto &gtkFrameExtentsCookie = requests.m_gtkFrameExtents;
+    auto &showOnScreenEdgeCookie = requests.m_showOnScreenEdge;
+    auto &colorSchemeCookie = requests.m_colorScheme;
+    auto &firstInTabBoxCookie = requests.m_firstInTabBox;
+    auto &transientCookie = requests.m_transient;
+    auto &activitiesCookie = requests.m_activities;
+    auto &applicationMenuServiceNameCookie = requests.m_applicationMenuServiceName;
+    auto &applicationMenuObjectPathCookie = requests.m_applicationMenuObjectPath;
+
+    m_geometryHints = requests.m_geometryHints;
+    m_motif = requests.m_motif;
+    // the only round trip which can't be pipelined with other windows
     info = new WinInfo(this, m_client, rootWindow(), properties, properties2);
 
     if (isDesktop() && bit_depth == 32) {
@@ -124,12 +164,12 @@ bool Client::manage(xcb_window_t w, bool isMapped)
 
     getResourceClass();
     readWmClientLeader(wmClientLeaderCookie);
-    getWmClientMachine();
-    getSyncCounter();
+    readWmClientMachine(QByteArray(info->clientMachine()));
+    readSyncCounter(requests.m_syncCounter);
     // First only read the caption text, so that setupWindowRules() can use it for matching,
     // and only then really set the caption using setCaption(), which checks for duplicates etc.
     // and also relies on rules already existing
-    cap_normal = readName();
+    cap_normal = readName(requests.m_wmName);
     setupWindowRules(false);
     setCaption(cap_normal, true);
 
@@ -137,7 +177,7 @@ bool Client::manage(xcb_window_t w, bool isMapped)
 
     if (Xcb::Extensions::self()->isShapeAvailable())
         xcb_shape_select_input(connection(), window(), true);
-    detectShape(window());
+    detectShape(requests.m_shapeExtents);
     readGtkFrameExtents(gtkFrameExtentsCookie);
     detectNoBorder();
     fetchIconicName();
@@ -916,7 +916,7 @@ void Options::reloadCompositingSettings(bool force)
     const QString s = config.readEntry("GLPreferBufferSwap", QString(Options::defaultGlPreferBufferSwap()));
     if (!s.isEmpty())
         c = s.at(0).toLatin1();
-    if (c != 'a' && c != 'c' && c != 'p' && c != 'e')
+    if (c != 'a' && c != 'c' && c != 'p' && c != 'e' && c != 'b')
         c = 0;
     setGlPreferBufferSwap(c);
 
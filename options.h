@@ -568,7 +568,12 @@ public:
         return m_glPlatformInterface;
     }
 
-    enum GlSwapStrategy { NoSwapEncourage = 0, CopyFrontBuffer = 'c', PaintFullScreen = 'p', ExtendDamage = 'e', AutoSwapStrategy = 'a' };
+    /**
+     * How to update the screen if the platform doesn't report the age of the back buffer.
+     * OffscreenBuffer renders into a compositor owned buffer which keeps its content
+     * between frames and copies the repainted parts into the window's back buffer.
+     */
+    enum GlSwapStrategy { NoSwapEncourage = 0, CopyFrontBuffer = 'c', PaintFullScreen = 'p', ExtendDamage = 'e', OffscreenBuffer = 'b', AutoSwapStrategy = 'a' };
     GlSwapStrategy glPreferBufferSwap() const {
         return m_glPreferBufferSwap;
     }
@@ -80,6 +80,10 @@ void AbstractEglBackend::unbindWaylandDisplay()
 
 void AbstractEglBackend::cleanup()
 {
+    for (const BufferImage &bufferImage : qAsConst(m_bufferImages)) {
+        eglDestroyImageKHR(m_display, bufferImage.image);
+    }
+    m_bufferImages.clear();
     cleanupGL();
     doneCurrent();
     eglDestroyContext(m_display, m_context);
@@ -308,6 +312,51 @@ bool AbstractEglBackend::createContext()
     return true;
 }
 
+AbstractEglBackend::BufferImage AbstractEglBackend::bufferImage(KWayland::Server::BufferInterface *buffer)
+{
+    auto it = m_bufferImages.constFind(buffer);
+    if (it != m_bufferImages.constEnd()) {
+        return *it;
+    }
+    if (!eglQueryWaylandBufferWL || !buffer->resource()) {
+        return BufferImage();
+    }
+
+    EGLint format, yInverted;
+    eglQueryWaylandBufferWL(m_display, buffer->resource(), EGL_TEXTURE_FORMAT, &format);
+    if (format != EGL_TEXTURE_RGB && format != EGL_TEXTURE_RGBA) {
+        qCDebug(KWIN_OPENGL) << "Unsupported texture format: " << format;
+        return BufferImage();
+    }
+    if (!eglQueryWaylandBufferWL(m_display, buffer->resource(), EGL_WAYLAND_Y_INVERTED_WL, &yInverted)) {
+        // if EGL_WAYLAND_Y_INVERTED_WL is not supported wl_buffer should be treated as if value were EGL_TRUE
+        yInverted = EGL_TRUE;
+    }
+
+    const EGLint attribs[] = {
+        EGL_WAYLAND_PLANE_WL, 0,
+        EGL_NONE
+    };
+    BufferImage bufferImage;
+    bufferImage.image = eglCreateImageKHR(m_display, EGL_NO_CONTEXT, EGL_WAYLAND_BUFFER_WL,
+                                          (EGLClientBuffer)buffer->resource(), attribs);
+    if (bufferImage.image == EGL_NO_IMAGE_KHR) {
+        return bufferImage;
+    }
+    bufferImage.yInverted = yInverted;
+
+    m_bufferImages.insert(buffer, bufferImage);
+    connect(buffer, &KWayland::Server::BufferInterface::aboutToBeDestroyed, this,
+        [this] (KWayland::Server::BufferInterface *destroyed) {
+            const BufferImage bufferImage = m_bufferImages.take(destroyed);
+            if (bufferImage.image != EGL_NO_IMAGE_KHR) {
+                eglDestroyImageKHR(m_display, bufferImage.image);
+            }
+        }
+    );
+    return bufferImage;
+}
+
 void AbstractEglBackend::setEglDisplay(const EGLDisplay &display) {
     m_display = display;
     kwinApp()->platform()->setSceneEglDisplay(display);
@@ -383,8 +432,9 @@ void AbstractEglTexture::updateTexture(WindowPixmap *pixmap)
     auto s = pixmap->surface();
     if (EglDmabufBuffer *dmabuf = static_cast<EglDmabufBuffer *>(buffer->linuxDmabufBuffer())) {
         q->bind();
-        glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, (GLeglImageOES) dmabuf->images()[0]);   //TODO
+        glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, (GLeglImageOES) dmabuf->images()[0]);
         q->unbind();
+        updateDmabufPlanes(dmabuf);
         if (m_image != EGL_NO_IMAGE_KHR) {
             eglDestroyImageKHR(m_backend->eglDisplay(), m_image);
         }
@@ -401,16 +451,16 @@ void AbstractEglTexture::updateTexture(WindowPixmap *pixmap)
         }
         return;
     }
+    if (!m_planes.isEmpty()) {
+        // the client switched from a YUV dmabuf to another kind of buffer
+        glDeleteTextures(m_planes.count(), m_planes.constData());
+        m_planes.clear();
+        m_planeTraits = ShaderTraits();
+    }
     if (!buffer->shmBuffer()) {
         q->bind();
-        EGLImageKHR image = attach(buffer);
+        attach(buffer);
         q->unbind();
-        if (image != EGL_NO_IMAGE_KHR) {
-            if (m_image != EGL_NO_IMAGE_KHR) {
-                eglDestroyImageKHR(m_backend->eglDisplay(), m_image);
-            }
-            m_image = image;
-        }
         if (s) {
             s->resetTrackedDamage();
         }
@@ -522,10 +572,11 @@ bool AbstractEglTexture::loadEglTexture(const QPointer< KWayland::Server::Buffer
     q->setWrapMode(GL_CLAMP_TO_EDGE);
     q->setFilter(GL_LINEAR);
     q->bind();
-    m_image = attach(buffer);
+    // the backend keeps the image as long as the wl_buffer exists
+    const EGLImageKHR image = attach(buffer);
     q->unbind();
 
-    if (EGL_NO_IMAGE_KHR == m_image) {
+    if (EGL_NO_IMAGE_KHR == image) {
         qCDebug(KWIN_OPENGL) << "failed to create egl image";
         q->discard();
         return false;
@@ -551,6 +602,7 @@ bool AbstractEglTexture::loadDmabufTexture(const QPointer< KWayland::Server::Buf
     q->bind();
     glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, (GLeglImageOES) dmabuf->images()[0]);
     q->unbind();
+    updateDmabufPlanes(dmabuf);
 
     m_size = dmabuf->size();
     q->setYInverted(!(dmabuf->flags() & KWayland::Server::LinuxDmabufUnstableV1Interface::YInverted));
@@ -558,32 +610,63 @@ bool AbstractEglTexture::loadDmabufTexture(const QPointer< KWayland::Server::Buf
     return true;
 }
 
-EGLImageKHR AbstractEglTexture::attach(const QPointer< KWayland::Server::BufferInterface > &buffer)
+void AbstractEglTexture::updateDmabufPlanes(EglDmabufBuffer *dmabuf)
 {
-    EGLint format, yInverted;
-    eglQueryWaylandBufferWL(m_backend->eglDisplay(), buffer->resource(), EGL_TEXTURE_FORMAT, &format);
-    if (format != EGL_TEXTURE_RGB && format != EGL_TEXTURE_RGBA) {
-        qCDebug(KWIN_OPENGL) << "Unsupported texture format: " << format;
-        return EGL_NO_IMAGE_KHR;
-    }
-    if (!eglQueryWaylandBufferWL(m_backend->eglDisplay(), buffer->resource(), EGL_WAYLAND_Y_INVERTED_WL, &yInverted)) {
-        // if EGL_WAYLAND_Y_INVERTED_WL is not supported wl_buffer should be treated as if value were EGL_TRUE
-        yInverted = EGL_TRUE;
+    // the texture itself holds the first image, every further plane gets its own texture
+    const QVector<EGLImage> images = dmabuf->images();
+    const int planeCount = images.count() - 1;
+    while (m_planes.count() > planeCount) {
+        const GLuint plane = m_planes.takeLast();
+        glDeleteTextures(1, &plane);
+    }
+    while (m_planes.count() < planeCount) {
+        GLuint plane;
+        glGenTextures(1, &plane);
+        glBindTexture(GL_TEXTURE_2D, plane);
+        // chroma planes are subsampled, so they always need to be interpolated
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        m_planes << plane;
+    }
+    for (int i = 0; i < planeCount; i++) {
+        glBindTexture(GL_TEXTURE_2D, m_planes[i]);
+        glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, (GLeglImageOES) images[i + 1]);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    switch (dmabuf->textureType()) {
+    case EGL_TEXTURE_Y_UV_WL:
+        m_planeTraits = ShaderTrait::YuvTwoPlanes;
+        break;
+    case EGL_TEXTURE_Y_U_V_WL:
+        m_planeTraits = ShaderTrait::YuvThreePlanes;
+        break;
+    case EGL_TEXTURE_Y_XUXV_WL:
+        m_planeTraits = ShaderTrait::YuvPackedChroma;
+        break;
+    default:
+        m_planeTraits = ShaderTraits();
+        return;
     }
+    // linux-dmabuf doesn't tell the colorimetry, assume what video decoders produce
+    // by default: limited range with BT.709 for HD content and BT.601 otherwise
+    const YuvCoefficients coefficients = dmabuf->size().height() >= 720 ? YuvCoefficients::BT709
+                                                                         : YuvCoefficients::BT601;
+    m_yuvToRgb = yuvToRgbMatrix(coefficients, YuvRange::Limited);
+}
 
-    const EGLint attribs[] = {
-        EGL_WAYLAND_PLANE_WL, 0,
-        EGL_NONE
-    };
-    EGLImageKHR image = eglCreateImageKHR(m_backend->eglDisplay(), EGL_NO_CONTEXT, EGL_WAYLAND_BUFFER_WL,
-                                      (EGLClientBuffer)buffer->resource(), attribs);
-    if (image != EGL_NO_IMAGE_KHR) {
-        glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, (GLeglImageOES)image);
+EGLImageKHR AbstractEglTexture::attach(const QPointer< KWayland::Server::BufferInterface > &buffer)
+{
+    const AbstractEglBackend::BufferImage bufferImage = m_backend->bufferImage(buffer.data());
+    if (bufferImage.image != EGL_NO_IMAGE_KHR) {
+        glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, (GLeglImageOES)bufferImage.image);
         m_size = buffer->size();
         updateMatrix();
-        q->setYInverted(yInverted);
+        q->setYInverted(bufferImage.yInverted);
     }
-    return image;
+    return bufferImage.image;
 }
 
 bool AbstractEglTexture::updateFromFBO(const QSharedPointer<QOpenGLFramebufferObject> &fbo)
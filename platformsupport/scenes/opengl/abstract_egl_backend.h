@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "backend.h"
 #include "texture.h"
 
+#include <QHash>
 #include <QObject>
 #include <epoxy/egl.h>
 #include <fixx11h.h>
@@ -40,6 +41,7 @@ namespace KWin
 {
 
 class EglDmabuf;
+class EglDmabufBuffer;
 
 class KWIN_EXPORT AbstractEglBackend : public QObject, public OpenGLBackend
 {
@@ -62,6 +64,18 @@ public:
         return m_config;
     }
 
+    struct BufferImage {
+        EGLImageKHR image = EGL_NO_IMAGE_KHR;
+        bool yInverted = true;
+    };
+    /**
+     * The EGLImage of a wl_buffer created through EGL_WL_bind_wayland_display.
+     *
+     * The image is created on first use and kept until the buffer gets destroyed, so
+     * clients cycling through a fixed set of buffers don't cause a new image per frame.
+     */
+    BufferImage bufferImage(KWayland::Server::BufferInterface *buffer);
+
 protected:
     AbstractEglBackend();
     void setEglDisplay(const EGLDisplay &display);
@@ -88,6 +102,7 @@ private:
     EGLConfig m_config = nullptr;
     QList<QByteArray> m_clientExtensions;
     EglDmabuf *m_dmaBuf = nullptr;
+    QHash<KWayland::Server::BufferInterface*, BufferImage> m_bufferImages;
 };
 
 class KWIN_EXPORT AbstractEglTexture : public SceneOpenGLTexturePrivate
@@ -114,6 +129,7 @@ private:
     bool loadShmTexture(const QPointer<KWayland::Server::BufferInterface> &buffer);
     bool loadEglTexture(const QPointer<KWayland::Server::BufferInterface> &buffer);
     bool loadDmabufTexture(const QPointer< KWayland::Server::BufferInterface > &buffer);
+    void updateDmabufPlanes(EglDmabufBuffer *dmabuf);
     EGLImageKHR attach(const QPointer<KWayland::Server::BufferInterface> &buffer);
     bool updateFromFBO(const QSharedPointer<QOpenGLFramebufferObject> &fbo);
     SceneOpenGLTexture *q;
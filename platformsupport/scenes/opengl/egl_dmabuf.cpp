@@ -73,6 +73,11 @@ eglQueryDmaBufModifiersEXT_func eglQueryDmaBufModifiersEXT = nullptr;
 #define EGL_DMA_BUF_PLANE3_MODIFIER_HI_EXT        0x344A
 #endif // EGL_EXT_image_dma_buf_import_modifiers
 
+#ifndef DRM_FORMAT_P010
+// 2x2 subsampled Cr:Cb plane, 10 bits per channel in the upper bits of 16 bit words
+#define DRM_FORMAT_P010 fourcc_code('P', '0', '1', '0')
+#endif
+
 struct YuvPlane
 {
     int widthDivisor;
@@ -90,7 +95,7 @@ struct YuvFormat
     struct YuvPlane planes[3];
 };
 
-YuvFormat yuvFormats[] = {
+const YuvFormat yuvFormats[] = {
     {
         DRM_FORMAT_YUYV,
         1, 2,
@@ -125,6 +130,23 @@ YuvFormat yuvFormats[] = {
             }
         }
     },
+    {
+        DRM_FORMAT_P010,
+        2, 2,
+        EGL_TEXTURE_Y_UV_WL,
+        {
+            {
+                1, 1,
+                DRM_FORMAT_R16,
+                0
+            },
+            {
+                2, 2,
+                DRM_FORMAT_GR1616,
+                1
+            }
+        }
+    },
     {
         DRM_FORMAT_YUV420,
         3, 3,
@@ -171,6 +193,16 @@ YuvFormat yuvFormats[] = {
     }
 };
 
+static const YuvFormat *findYuvFormat(uint32_t format)
+{
+    for (const YuvFormat &yuvFormat : yuvFormats) {
+        if (yuvFormat.format == format) {
+            return &yuvFormat;
+        }
+    }
+    return nullptr;
+}
+
 EglDmabufBuffer::EglDmabufBuffer(EGLImage image,
                                  const QVector<Plane> &planes,
                                  uint32_t format,
@@ -303,16 +335,17 @@ KWayland::Server::LinuxDmabufUnstableV1Buffer* EglDmabuf::importBuffer(const QVe
 {
     Q_ASSERT(planes.count() > 0);
 
-    // Try first to import as a single image
+    // YUV buffers get one image per plane, the scene converts them to RGB while sampling.
+    // Some drivers import them as a single image as well, but those can only be bound
+    // as external textures.
+    if (findYuvFormat(format)) {
+        return yuvImport(planes, format, size, flags);
+    }
+
     if (auto *img = createImage(planes, format, size)) {
         return new EglDmabufBuffer(img, planes, format, size, flags, this);
     }
 
-    // TODO: to enable this we must be able to store multiple textures per window pixmap
-    //       and when on window draw do yuv to rgb transformation per shader (see Weston)
-//    // not a single image, try yuv import
-//    return yuvImport(planes, format, size, flags);
-
     return nullptr;
 }
 
@@ -321,33 +354,28 @@ KWayland::Server::LinuxDmabufUnstableV1Buffer* EglDmabuf::yuvImport(const QVecto
                                                                     const QSize &size,
                                                                     Flags flags)
 {
-    YuvFormat yuvFormat;
-    for (YuvFormat f : yuvFormats) {
-        if (f.format == format) {
-            yuvFormat = f;
-            break;
-        }
-    }
-    if (yuvFormat.format == 0) {
+    const YuvFormat *yuvFormat = findYuvFormat(format);
+    if (!yuvFormat) {
         return nullptr;
     }
-    if (planes.count() != yuvFormat.inputPlanes) {
+    if (planes.count() != yuvFormat->inputPlanes) {
         return nullptr;
     }
 
     auto *buf = new EglDmabufBuffer(planes, format, size, flags, this);
+    buf->setTextureType(yuvFormat->textureType);
 
-    for (int i = 0; i < yuvFormat.outputPlanes; i++) {
-        int planeIndex = yuvFormat.planes[i].planeIndex;
+    for (int i = 0; i < yuvFormat->outputPlanes; i++) {
+        int planeIndex = yuvFormat->planes[i].planeIndex;
         Plane plane = {
             planes[planeIndex].fd,
             planes[planeIndex].offset,
             planes[planeIndex].stride,
             planes[planeIndex].modifier
         };
-        const auto planeFormat = yuvFormat.planes[i].format;
-        const auto planeSize = QSize(size.width() / yuvFormat.planes[i].widthDivisor,
-                                     size.height() / yuvFormat.planes[i].heightDivisor);
+        const auto planeFormat = yuvFormat->planes[i].format;
+        const auto planeSize = QSize(size.width() / yuvFormat->planes[i].widthDivisor,
+                                     size.height() / yuvFormat->planes[i].heightDivisor);
         auto *image = createImage(QVector<Plane>(1, plane),
                                   planeFormat,
                                   planeSize);
@@ -357,7 +385,6 @@ KWayland::Server::LinuxDmabufUnstableV1Buffer* EglDmabuf::yuvImport(const QVecto
         }
         buf->addImage(image);
     }
-    // TODO: add buf import properties
     return buf;
 }
 
@@ -387,7 +414,17 @@ EglDmabuf::EglDmabuf(AbstractEglBackend *backend)
     for (auto *buffer : prevBuffersSet) {
         auto *buf = static_cast<EglDmabufBuffer*>(buffer);
         buf->setInterfaceImplementation(this);
-        buf->addImage(createImage(buf->planes(), buf->format(), buf->size()));
+        if (const YuvFormat *yuvFormat = findYuvFormat(buf->format())) {
+            const auto planes = buf->planes();
+            for (int i = 0; i < yuvFormat->outputPlanes; i++) {
+                const YuvPlane &plane = yuvFormat->planes[i];
+                buf->addImage(createImage(QVector<Plane>(1, planes[plane.planeIndex]), plane.format,
+                                          QSize(buf->size().width() / plane.widthDivisor,
+                                                buf->size().height() / plane.heightDivisor)));
+            }
+        } else {
+            buf->addImage(createImage(buf->planes(), buf->format(), buf->size()));
+        }
     }
     setSupportedFormatsAndModifiers();
 }
@@ -432,10 +469,23 @@ const uint32_t s_multiPlaneFormats[] = {
 
 void filterFormatsWithMultiplePlanes(QVector<uint32_t> &formats)
 {
+    // YUV formats can be sampled plane by plane if the driver imports all formats of their planes
+    auto canImportPlanes = [&formats] (uint32_t format) {
+        const YuvFormat *yuvFormat = findYuvFormat(format);
+        if (!yuvFormat) {
+            return false;
+        }
+        for (int i = 0; i < yuvFormat->outputPlanes; i++) {
+            if (!formats.contains(yuvFormat->planes[i].format)) {
+                return false;
+            }
+        }
+        return true;
+    };
     QVector<uint32_t>::iterator it = formats.begin();
     while (it != formats.end()) {
         for (auto linuxFormat : s_multiPlaneFormats) {
-            if (*it == linuxFormat) {
+            if (*it == linuxFormat && !canImportPlanes(linuxFormat)) {
                 qDebug() << "Filter multi-plane format" << *it;
                 it = formats.erase(it);
                 it--;
@@ -62,8 +62,16 @@ public:
 
     QVector<EGLImage> images() const { return m_images; }
 
+    /**
+     * How the images have to be sampled: EGL_TEXTURE_RGBA for a single image, otherwise
+     * one of the EGL_TEXTURE_Y_* layouts with one image per plane.
+     */
+    int textureType() const { return m_textureType; }
+    void setTextureType(int textureType) { m_textureType = textureType; }
+
 private:
     QVector<EGLImage> m_images;
+    int m_textureType = EGL_TEXTURE_RGBA;
     EglDmabuf *m_interfaceImpl;
     ImportType m_importType;
 };
@@ -55,13 +55,50 @@ bool SceneOpenGLTexture::load(WindowPixmap *pixmap)
     d_ptr = d_func()->backend()->createBackendTexture(this); //new TexturePrivate();
 
     Q_D(SceneOpenGLTexture);
-    return d->loadTexture(pixmap);
+    d->m_memoryCategory = MemoryCategory::WindowPixmap;
+    const bool loaded = d->loadTexture(pixmap);
+    d->updateMemoryUsage();
+    return loaded;
 }
 
 void SceneOpenGLTexture::updateFromPixmap(WindowPixmap *pixmap)
 {
     Q_D(SceneOpenGLTexture);
     d->updateTexture(pixmap);
+    // shm buffers of a different size get a new storage
+    d->updateMemoryUsage();
+}
+
+ShaderTraits SceneOpenGLTexture::planeTraits() const
+{
+    Q_D(const SceneOpenGLTexture);
+    return d->m_planeTraits;
+}
+
+QMatrix4x4 SceneOpenGLTexture::yuvToRgbMatrix() const
+{
+    Q_D(const SceneOpenGLTexture);
+    return d->m_yuvToRgb;
+}
+
+void SceneOpenGLTexture::bindPlanes()
+{
+    Q_D(SceneOpenGLTexture);
+    for (int i = 0; i < d->m_planes.count(); i++) {
+        glActiveTexture(GL_TEXTURE1 + i);
+        glBindTexture(GL_TEXTURE_2D, d->m_planes[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void SceneOpenGLTexture::unbindPlanes()
+{
+    Q_D(SceneOpenGLTexture);
+    for (int i = 0; i < d->m_planes.count(); i++) {
+        glActiveTexture(GL_TEXTURE1 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
 }
 
 SceneOpenGLTexturePrivate::SceneOpenGLTexturePrivate()
@@ -70,6 +107,9 @@ SceneOpenGLTexturePrivate::SceneOpenGLTexturePrivate()
 
 SceneOpenGLTexturePrivate::~SceneOpenGLTexturePrivate()
 {
+    if (!m_planes.isEmpty()) {
+        glDeleteTextures(m_planes.count(), m_planes.constData());
+    }
 }
 
 void SceneOpenGLTexturePrivate::updateTexture(WindowPixmap *pixmap)
@@ -23,6 +23,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <kwingltexture.h>
 #include <kwingltexture_p.h>
 
+#include <QVector>
+
 namespace KWin
 {
 
@@ -40,6 +42,22 @@ public:
 
     void discard() override final;
 
+    /**
+     * The ShaderTraits needed to sample this texture in addition to MapTexture,
+     * e.g. to convert the planes of a YUV buffer to RGB. Empty for RGB textures.
+     */
+    ShaderTraits planeTraits() const;
+    /**
+     * The GLShader::YuvToRgbMatrix for textures with planeTraits().
+     */
+    QMatrix4x4 yuvToRgbMatrix() const;
+    /**
+     * Binds the chroma planes of a YUV texture to the texture units 1 and 2,
+     * the texture itself holds the luma plane.
+     */
+    void bindPlanes();
+    void unbindPlanes();
+
 private:
     SceneOpenGLTexture(SceneOpenGLTexturePrivate& dd);
 
@@ -60,6 +78,11 @@ public:
     virtual void updateTexture(WindowPixmap *pixmap);
     virtual OpenGLBackend *backend() = 0;
 
+    // chroma planes of YUV textures
+    QVector<GLuint> m_planes;
+    ShaderTraits m_planeTraits;
+    QMatrix4x4 m_yuvToRgb;
+
 protected:
     SceneOpenGLTexturePrivate();
 
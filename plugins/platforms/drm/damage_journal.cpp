@@ -0,0 +1,76 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "damage_journal.h"
+
+namespace KWin
+{
+
+DamageJournal::DamageJournal(int capacity)
+    : m_capacity(qMax(capacity, 1))
+{
+}
+
+void DamageJournal::setGeometry(const QRect &geometry)
+{
+    if (m_geometry == geometry) {
+        return;
+    }
+    m_geometry = geometry;
+    m_history.clear();
+}
+
+void DamageJournal::add(const QRegion &damage)
+{
+    if (m_history.count() >= m_capacity) {
+        m_history.removeLast();
+    }
+    m_history.prepend(damage.intersected(m_geometry));
+}
+
+QRegion DamageJournal::accumulate(int bufferAge) const
+{
+    // the buffer of age n is missing the damage of the last n - 1 frames. It only has
+    // valid content if it was rendered after the journal got cleared, i.e. if the journal
+    // has at least n frames; a cleared journal forces a full repaint
+    if (bufferAge <= 0 || bufferAge > m_history.count()) {
+        return m_geometry;
+    }
+    QRegion region;
+    for (int i = 0; i < bufferAge - 1; i++) {
+        region |= m_history.at(i);
+    }
+    return region;
+}
+
+QRegion DamageJournal::repaintRegion() const
+{
+    return accumulate(m_bufferAge);
+}
+
+void DamageJournal::clear()
+{
+    m_history.clear();
+}
+
+void DamageJournal::reset()
+{
+    clear();
+    m_bufferAge = 0;
+}
+
+}
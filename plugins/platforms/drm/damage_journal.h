@@ -0,0 +1,95 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#ifndef KWIN_DRM_DAMAGE_JOURNAL_H
+#define KWIN_DRM_DAMAGE_JOURNAL_H
+
+#include <QList>
+#include <QRect>
+#include <QRegion>
+
+namespace KWin
+{
+
+/**
+ * @brief The damage of the last frames presented on one output.
+ *
+ * Used to compute the region which has to be repainted in a back buffer of a given age.
+ * All damage is clipped to the geometry of the output. Changing the geometry, e.g. due
+ * to a mode or transform change, invalidates the history.
+ */
+class DamageJournal
+{
+public:
+    explicit DamageJournal(int capacity = 10);
+
+    QRect geometry() const {
+        return m_geometry;
+    }
+    /**
+     * Sets the geometry of the output, clears the history if it changed.
+     */
+    void setGeometry(const QRect &geometry);
+
+    int capacity() const {
+        return m_capacity;
+    }
+    int count() const {
+        return m_history.count();
+    }
+
+    /**
+     * Records the @p damage of the frame which just got presented.
+     */
+    void add(const QRegion &damage);
+    /**
+     * The region to repaint in a back buffer of @p bufferAge, i.e. the damage of the
+     * last @p bufferAge - 1 frames. An age of zero means the buffer contents are
+     * undefined, in that case and if the buffer is older than the recorded frames the
+     * complete geometry is returned.
+     */
+    QRegion accumulate(int bufferAge) const;
+    void clear();
+
+    /**
+     * The age of the back buffer which gets rendered next, as reported by EGL.
+     */
+    int bufferAge() const {
+        return m_bufferAge;
+    }
+    void setBufferAge(int bufferAge) {
+        m_bufferAge = bufferAge;
+    }
+    /**
+     * The region to repaint in the next back buffer, accumulate() for bufferAge().
+     */
+    QRegion repaintRegion() const;
+    /**
+     * Clears the history and the buffer age, e.g. because the surface got recreated.
+     */
+    void reset();
+
+private:
+    QRect m_geometry;
+    QList<QRegion> m_history;
+    int m_capacity;
+    int m_bufferAge = 0;
+};
+
+}
+
+#endif
@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "logging.h"
 #include "logind.h"
 #include "main.h"
+#include "presentation_time.h"
 #include "scene_qpainter_drm_backend.h"
 #include "screens_drm.h"
 #include "udev.h"
@@ -83,6 +84,13 @@ DrmBackend::DrmBackend(QObject *parent)
 #endif
     setSupportsGammaControl(true);
     supportsOutputChanges();
+    connect(this, &DrmBackend::outputRemoved, this,
+        [] (DrmOutput *output) {
+            if (waylandServer()) {
+                waylandServer()->presentationTime()->outputRemoved(output);
+            }
+        }
+    );
 }
 
 DrmBackend::~DrmBackend()
@@ -232,11 +240,16 @@ void DrmBackend::deactivate()
 void DrmBackend::pageFlipHandler(int fd, unsigned int frame, unsigned int sec, unsigned int usec, void *data)
 {
     Q_UNUSED(fd)
-    Q_UNUSED(frame)
-    Q_UNUSED(sec)
-    Q_UNUSED(usec)
     auto output = reinterpret_cast<DrmOutput*>(data);
 
+    if (waylandServer()) {
+        PresentationTime::Kinds flags = PresentationTime::Kind::Vsync | PresentationTime::Kind::HwCompletion;
+        if (output->m_backend->m_monotonicTimestamps) {
+            flags |= PresentationTime::Kind::HwClock;
+        }
+        const timespec timestamp = {time_t(sec), long(usec) * 1000};
+        waylandServer()->presentationTime()->presented(output, timestamp, frame, flags);
+    }
     output->pageFlipped();
     output->m_backend->m_pageFlipsPending--;
     if (output->m_backend->m_pageFlipsPending == 0) {
@@ -280,6 +293,9 @@ void DrmBackend::openDrm()
     );
     m_drmId = device->sysNum();
 
+    uint64_t monotonicTimestamps = 0;
+    m_monotonicTimestamps = drmGetCap(m_fd, DRM_CAP_TIMESTAMP_MONOTONIC, &monotonicTimestamps) == 0 && monotonicTimestamps;
+
     // trying to activate Atomic Mode Setting (this means also Universal Planes)
     if (!qEnvironmentVariableIsSet("KWIN_DRM_NO_AMS")) {
         if (drmSetClientCap(m_fd, DRM_CLIENT_CAP_ATOMIC, 1) == 0) {
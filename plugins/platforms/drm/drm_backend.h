@@ -180,6 +180,8 @@ private:
 
     bool m_deleteBufferAfterPageFlip;
     bool m_atomicModeSetting = false;
+    // page flip timestamps use CLOCK_MONOTONIC
+    bool m_monotonicTimestamps = false;
     bool m_cursorEnabled = false;
     QSize m_cursorSize;
     int m_pageFlipsPending = 0;
@@ -191,6 +191,8 @@ bool EglGbmBackend::resetOutput(Output &o, DrmOutput *drmOutput)
         o.eglSurface = eglSurface;
         o.gbmSurface = gbmSurface;
     }
+    // the new surface has no valid content
+    o.damageJournal.reset();
     return true;
 }
 
@@ -315,7 +317,9 @@ void EglGbmBackend::presentOnOutput(EglGbmBackend::Output &o)
     m_backend->present(o.buffer, o.output);
 
     if (supportsBufferAge()) {
-        eglQuerySurface(eglDisplay(), o.eglSurface, EGL_BUFFER_AGE_EXT, &o.bufferAge);
+        EGLint bufferAge = 0;
+        eglQuerySurface(eglDisplay(), o.eglSurface, EGL_BUFFER_AGE_EXT, &bufferAge);
+        o.damageJournal.setBufferAge(bufferAge);
     }
 
 }
@@ -339,20 +343,12 @@ QRegion EglGbmBackend::prepareRenderingFrame()
 
 QRegion EglGbmBackend::prepareRenderingForScreen(int screenId)
 {
-    const Output &o = m_outputs.at(screenId);
+    Output &o = m_outputs[screenId];
     makeContextCurrent(o);
     if (supportsBufferAge()) {
-        QRegion region;
-
-        // Note: An age of zero means the buffer contents are undefined
-        if (o.bufferAge > 0 && o.bufferAge <= o.damageHistory.count()) {
-            for (int i = 0; i < o.bufferAge - 1; i++)
-                region |= o.damageHistory[i];
-        } else {
-            region = o.output->geometry();
-        }
-
-        return region;
+        // a changed geometry or transform invalidates the damage history
+        o.damageJournal.setGeometry(o.output->geometry());
+        return o.damageJournal.repaintRegion();
     }
     return QRegion();
 }
@@ -366,7 +362,7 @@ void EglGbmBackend::endRenderingFrame(const QRegion &renderedRegion, const QRegi
 void EglGbmBackend::endRenderingFrameForScreen(int screenId, const QRegion &renderedRegion, const QRegion &damagedRegion)
 {
     Output &o = m_outputs[screenId];
-    if (damagedRegion.intersected(o.output->geometry()).isEmpty() && screenId == 0) {
+    if (damagedRegion.intersected(o.output->geometry()).isEmpty()) {
 
         // If the damaged region of a window is fully occluded, the only
         // rendering done, if any, will have been to repair a reused back
@@ -378,27 +374,14 @@ void EglGbmBackend::endRenderingFrameForScreen(int screenId, const QRegion &rend
         if (!renderedRegion.intersected(o.output->geometry()).isEmpty())
             glFlush();
 
-        for (auto &o: m_outputs) {
-            o.bufferAge = 1;
-        }
+        o.damageJournal.setBufferAge(1);
         return;
     }
     presentOnOutput(o);
 
     // Save the damaged region to history
-    // Note: damage history is only collected for the first screen. For any other screen full repaints
-    // are triggered. This is due to a limitation in Scene::paintGenericScreen which resets the Toplevel's
-    // repaint. So multiple calls to Scene::paintScreen as it's done in multi-output rendering only
-    // have correct damage information for the first screen. If we try to track damage nevertheless,
-    // it creates artifacts. So for the time being we work around the problem by only supporting buffer
-    // age on the first output. To properly support buffer age on all outputs the rendering needs to
-    // be refactored in general.
-    if (supportsBufferAge() && screenId == 0) {
-        if (o.damageHistory.count() > 10) {
-            o.damageHistory.removeLast();
-        }
-
-        o.damageHistory.prepend(damagedRegion.intersected(o.output->geometry()));
+    if (supportsBufferAge()) {
+        o.damageJournal.add(damagedRegion);
     }
 }
 
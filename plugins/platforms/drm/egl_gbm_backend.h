@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef KWIN_EGL_GBM_BACKEND_H
 #define KWIN_EGL_GBM_BACKEND_H
 #include "abstract_egl_backend.h"
+#include "damage_journal.h"
 #include "remoteaccess_manager.h"
 
 #include <memory>
@@ -66,11 +67,10 @@ private:
         DrmBuffer *buffer = nullptr;
         std::shared_ptr<GbmSurface> gbmSurface;
         EGLSurface eglSurface = EGL_NO_SURFACE;
-        int bufferAge = 0;
         /**
-         * @brief The damage history for the past 10 frames.
+         * @brief The buffer age and damage history of this output for the past 10 frames.
          */
-        QList<QRegion> damageHistory;
+        DamageJournal damageJournal;
     };
     bool resetOutput(Output &output, DrmOutput *drmOutput);
     bool makeContextCurrent(const Output &output);
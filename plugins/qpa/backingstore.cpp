@@ -26,6 +26,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <KWayland/Client/shm_pool.h>
 #include <KWayland/Client/surface.h>
 
+#include <cstring>
+
+using KWayland::Client::Buffer;
+
 namespace KWin
 {
 namespace QPA
@@ -63,6 +67,8 @@ void BackingStore::resize(const QSize &size, const QRegion &staticContents)
 {
     Q_UNUSED(staticContents)
     m_size = size * scale();
+    // the pool only hands out buffers of the new size
+    m_bufferDamage.clear();
     if (!m_buffer) {
         return;
     }
@@ -72,7 +78,6 @@ void BackingStore::resize(const QSize &size, const QRegion &staticContents)
 
 void BackingStore::flush(QWindow *window, const QRegion &region, const QPoint &offset)
 {
-    Q_UNUSED(region)
     Q_UNUSED(offset)
 
     auto w = static_cast<Window *>(window->handle());
@@ -81,20 +86,34 @@ void BackingStore::flush(QWindow *window, const QRegion &region, const QPoint &o
         return;
     }
     s->attachBuffer(m_buffer);
-    // TODO: proper damage region
-    s->damage(QRect(QPoint(0, 0), m_backBuffer.size() / scale()));
+    s->damage(region & QRect(QPoint(0, 0), m_backBuffer.size() / scale()));
     s->commit(KWayland::Client::Surface::CommitFlag::None);
     waylandServer()->internalClientConection()->flush();
     waylandServer()->dispatch();
 }
 
-void BackingStore::beginPaint(const QRegion&)
+void BackingStore::trackDamage(const QRegion &region)
+{
+    QRegion nativeRegion;
+    for (const QRect &rect : region) {
+        nativeRegion += QRect(rect.topLeft() * scale(), rect.size() * scale());
+    }
+    Buffer *current = m_buffer.toStrongRef().data();
+    for (auto it = m_bufferDamage.begin(); it != m_bufferDamage.end(); ++it) {
+        if (it.key() != current) {
+            it.value() += nativeRegion;
+        }
+    }
+}
+
+void BackingStore::beginPaint(const QRegion &region)
 {
     if (m_buffer) {
         auto b = m_buffer.toStrongRef();
         if (b->isReleased()) {
             // we can re-use this buffer
             b->setReleased(false);
+            trackDamage(region);
             return;
         } else {
             // buffer is still in use, get a new one
@@ -112,11 +131,30 @@ void BackingStore::beginPaint(const QRegion&)
     b->setUsed(true);
     m_backBuffer = QImage(b->address(), m_size.width(), m_size.height(), QImage::Format_ARGB32_Premultiplied);
     m_backBuffer.setDevicePixelRatio(scale());
-    if (oldBuffer) {
+    auto damage = m_bufferDamage.find(b.data());
+    if (oldBuffer && damage != m_bufferDamage.end()) {
+        // the buffer still holds an older frame, only bring the changed parts up to date
+        const uchar *src = oldBuffer->address();
+        uchar *dst = b->address();
+        const int stride = m_size.width() * 4;
+        for (const QRect &rect : damage.value() & QRect(QPoint(0, 0), m_size)) {
+            for (int y = rect.top(); y <= rect.bottom(); y++) {
+                const int offset = y * stride + rect.x() * 4;
+                memcpy(dst + offset, src + offset, rect.width() * 4);
+            }
+        }
+        damage.value() = QRegion();
+    } else if (oldBuffer) {
         b->copy(oldBuffer->address());
+        m_bufferDamage.insert(b.data(), QRegion());
     } else {
         m_backBuffer.fill(Qt::transparent);
+        m_bufferDamage.insert(b.data(), QRegion());
+    }
+    if (oldBuffer) {
+        m_bufferDamage.insert(oldBuffer.data(), QRegion());
     }
+    trackDamage(region);
 }
 
 int BackingStore::scale() const
@@ -22,6 +22,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <qpa/qplatformbackingstore.h>
 
+#include <QHash>
+#include <QRegion>
+
 namespace KWayland
 {
 namespace Client
@@ -49,8 +52,11 @@ public:
 
 private:
     int scale() const;
+    void trackDamage(const QRegion &region);
     KWayland::Client::ShmPool *m_shm;
     QWeakPointer<KWayland::Client::Buffer> m_buffer;
+    // for each buffer painted before: the area changed since it was the current buffer
+    QHash<KWayland::Client::Buffer*, QRegion> m_bufferDamage;
     QImage m_backBuffer;
     QSize m_size;
 };
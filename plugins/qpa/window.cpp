@@ -42,6 +42,7 @@ Window::Window(QWindow *window, KWayland::Client::Surface *surface, KWayland::Cl
     : QPlatformWindow(window)
     , m_surface(surface)
     , m_shellSurface(shellSurface)
+    , m_releasedFBOs(QSharedPointer<QVector<QOpenGLFramebufferObject*>>::create())
     , m_windowId(++s_windowId)
     , m_integration(integration)
     , m_scale(screens()->maxScale())
@@ -58,6 +59,7 @@ Window::~Window()
     unmap();
     delete m_shellSurface;
     delete m_surface;
+    qDeleteAll(*m_releasedFBOs);
 }
 
 WId Window::winId() const
@@ -137,10 +139,35 @@ void Window::createFBO()
         return;
     }
     const QSize nativeSize = r.size() * m_scale;
-    m_contentFBO.reset(new QOpenGLFramebufferObject(nativeSize.width(), nativeSize.height(), QOpenGLFramebufferObject::CombinedDepthStencil));
-    if (!m_contentFBO->isValid()) {
-        qCWarning(KWIN_QPA) << "Content FBO is not valid";
+    // reuse an FBO of a previous frame instead of allocating a new one each frame
+    QOpenGLFramebufferObject *fbo = nullptr;
+    for (auto it = m_releasedFBOs->begin(); it != m_releasedFBOs->end();) {
+        if ((*it)->size() != nativeSize) {
+            delete *it;
+            it = m_releasedFBOs->erase(it);
+        } else if (!fbo) {
+            fbo = *it;
+            it = m_releasedFBOs->erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!fbo) {
+        fbo = new QOpenGLFramebufferObject(nativeSize.width(), nativeSize.height(), QOpenGLFramebufferObject::CombinedDepthStencil);
+        if (!fbo->isValid()) {
+            qCWarning(KWIN_QPA) << "Content FBO is not valid";
+        }
     }
+    const QWeakPointer<QVector<QOpenGLFramebufferObject*>> releasedFBOs = m_releasedFBOs;
+    m_contentFBO = QSharedPointer<QOpenGLFramebufferObject>(fbo,
+        [releasedFBOs] (QOpenGLFramebufferObject *fbo) {
+            if (auto released = releasedFBOs.toStrongRef()) {
+                released->append(fbo);
+            } else {
+                delete fbo;
+            }
+        }
+    );
     m_resized = false;
 }
 
@@ -26,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <fixx11h.h>
 #include <qpa/qplatformwindow.h>
 
+#include <QVector>
+
 class QOpenGLFramebufferObject;
 
 
@@ -79,6 +81,8 @@ private:
     KWayland::Client::Surface *m_surface;
     KWayland::Client::ShellSurface *m_shellSurface;
     QSharedPointer<QOpenGLFramebufferObject> m_contentFBO;
+    // FBOs handed to the ShellClient return here once KWin doesn't use them anymore
+    QSharedPointer<QVector<QOpenGLFramebufferObject*>> m_releasedFBOs;
     bool m_resized = false;
     ShellClient *m_shellClient = nullptr;
     quint32 m_windowId;
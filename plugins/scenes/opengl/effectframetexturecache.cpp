@@ -0,0 +1,131 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "effectframetexturecache.h"
+
+#include <kwingltexture.h>
+
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPixmap>
+
+namespace KWin
+{
+
+static const int s_textAlignmentMask = Qt::AlignHorizontal_Mask;
+
+uint qHash(const EffectFrameTextureCache::Text &text, uint seed)
+{
+    return qHash(text.text, seed) ^ qHash(text.font, seed) ^ qHash(text.color, seed) ^
+           qHash(uint(text.alignment), seed);
+}
+
+EffectFrameTextureCache &EffectFrameTextureCache::instance()
+{
+    // in KiB, enough for a few dozen captions
+    static EffectFrameTextureCache s_instance(4096, 8192);
+    return s_instance;
+}
+
+EffectFrameTextureCache::EffectFrameTextureCache(int textCost, int pixmapCost)
+    : m_texts(textCost)
+    , m_pixmaps(pixmapCost)
+{
+}
+
+EffectFrameTextureCache::~EffectFrameTextureCache()
+{
+    // the textures have to be freed while the OpenGL context is current
+    Q_ASSERT(m_texts.isEmpty());
+    Q_ASSERT(m_pixmaps.isEmpty());
+}
+
+int EffectFrameTextureCache::cost(const QSize &size)
+{
+    return qMax(1, size.width() * size.height() * 4 / 1024);
+}
+
+QSharedPointer<GLTexture> EffectFrameTextureCache::createTexture(const QImage &image)
+{
+    QSharedPointer<GLTexture> texture = QSharedPointer<GLTexture>::create(image);
+    texture->setMemoryCategory(GLTexture::MemoryCategory::Cache);
+    return texture;
+}
+
+QImage EffectFrameTextureCache::renderText(const Text &text)
+{
+    const int flags = text.alignment & s_textAlignmentMask;
+    const QRect bounds = QFontMetrics(text.font).boundingRect(QRect(), flags, text.text);
+    QImage image(bounds.size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    p.setFont(text.font);
+    p.setPen(QColor::fromRgba(text.color));
+    p.drawText(QRect(QPoint(0, 0), bounds.size()), flags, text.text);
+    p.end();
+    return image;
+}
+
+QRect EffectFrameTextureCache::alignedRect(Qt::Alignment alignment, const QSize &size, const QRect &rect)
+{
+    QPoint pos = rect.topLeft();
+    if (alignment & Qt::AlignHCenter) {
+        pos.rx() += (rect.width() - size.width()) / 2;
+    } else if (alignment & Qt::AlignRight) {
+        pos.rx() += rect.width() - size.width();
+    }
+    if (alignment & Qt::AlignVCenter) {
+        pos.ry() += (rect.height() - size.height()) / 2;
+    } else if (alignment & Qt::AlignBottom) {
+        pos.ry() += rect.height() - size.height();
+    }
+    return QRect(pos, size);
+}
+
+QSharedPointer<GLTexture> EffectFrameTextureCache::textTexture(const Text &text)
+{
+    Text key = text;
+    key.alignment &= s_textAlignmentMask;
+    if (QSharedPointer<GLTexture> *cached = m_texts.object(key)) {
+        return *cached;
+    }
+    const QImage image = renderText(key);
+    if (image.isNull()) {
+        return QSharedPointer<GLTexture>();
+    }
+    QSharedPointer<GLTexture> texture = createTexture(image);
+    m_texts.insert(key, new QSharedPointer<GLTexture>(texture), cost(image.size()));
+    return texture;
+}
+
+QSharedPointer<GLTexture> EffectFrameTextureCache::pixmapTexture(const QPixmap &pixmap)
+{
+    if (QSharedPointer<GLTexture> *cached = m_pixmaps.object(pixmap.cacheKey())) {
+        return *cached;
+    }
+    QSharedPointer<GLTexture> texture = createTexture(pixmap.toImage());
+    m_pixmaps.insert(pixmap.cacheKey(), new QSharedPointer<GLTexture>(texture), cost(pixmap.size()));
+    return texture;
+}
+
+void EffectFrameTextureCache::clear()
+{
+    m_texts.clear();
+    m_pixmaps.clear();
+}
+
+}
@@ -0,0 +1,95 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#ifndef KWIN_SCENE_OPENGL_EFFECTFRAMETEXTURECACHE_H
+#define KWIN_SCENE_OPENGL_EFFECTFRAMETEXTURECACHE_H
+
+#include <QCache>
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QSharedPointer>
+
+class QPixmap;
+
+namespace KWin
+{
+class GLTexture;
+
+/**
+ * Shares the textures of EffectFrames with identical content.
+ *
+ * Effects like the resize overlay or Present Windows change the texts of their frames
+ * while the user interacts, usually flipping between a few strings, or show the same
+ * strings in many frames. Texts are rasterized at their bounding size, independent of
+ * the frame showing them, and positioned when the frame gets rendered. The textures of
+ * recently shown content are kept, so they don't need to be rasterized and uploaded
+ * again. Textures still used by a frame stay alive when they get evicted.
+ */
+class EffectFrameTextureCache
+{
+public:
+    struct Text {
+        QString text;
+        QFont font;
+        QRgb color = 0;
+        // the horizontal alignment of the lines of a multi-line text
+        Qt::Alignment alignment = Qt::AlignLeft;
+
+        bool operator==(const Text &other) const {
+            return text == other.text && font == other.font && color == other.color &&
+                   alignment == other.alignment;
+        }
+    };
+
+    virtual ~EffectFrameTextureCache();
+    EffectFrameTextureCache(const EffectFrameTextureCache&) = delete;
+    static EffectFrameTextureCache &instance();
+
+    QSharedPointer<GLTexture> textTexture(const Text &text);
+    QSharedPointer<GLTexture> pixmapTexture(const QPixmap &pixmap);
+    void clear();
+
+    /**
+     * Rasterizes @p text at its bounding size.
+     */
+    static QImage renderText(const Text &text);
+    /**
+     * The geometry of a texture of @p size placed in @p rect according to @p alignment.
+     */
+    static QRect alignedRect(Qt::Alignment alignment, const QSize &size, const QRect &rect);
+
+protected:
+    /**
+     * @p textCost and @p pixmapCost are the sizes of the caches in KiB.
+     */
+    EffectFrameTextureCache(int textCost, int pixmapCost);
+    virtual QSharedPointer<GLTexture> createTexture(const QImage &image);
+
+private:
+    static int cost(const QSize &size);
+
+    QCache<Text, QSharedPointer<GLTexture>> m_texts;
+    // keyed by QPixmap::cacheKey, the icons and frame pixmaps come from the caches of QIcon and Plasma::FrameSvg
+    QCache<qint64, QSharedPointer<GLTexture>> m_pixmaps;
+};
+
+uint qHash(const EffectFrameTextureCache::Text &text, uint seed = 0);
+
+}
+
+#endif
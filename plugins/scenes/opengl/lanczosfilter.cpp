@@ -119,6 +119,7 @@ void LanczosFilter::updateOffscreenSurfaces()
             delete m_offscreenTarget;
         }
         m_offscreenTex = new GLTexture(GL_RGBA8, w, h);
+        m_offscreenTex->setMemoryCategory(GLTexture::MemoryCategory::Cache);
         m_offscreenTex->setFilter(GL_LINEAR);
         m_offscreenTex->setWrapMode(GL_CLAMP_TO_EDGE);
         m_offscreenTarget = new GLRenderTarget(*m_offscreenTex);
@@ -341,6 +342,7 @@ void LanczosFilter::performPaint(EffectWindowImpl* w, int mask, QRegion region,
 
             // create cache texture
             GLTexture *cache = new GLTexture(GL_RGBA8, tw, th);
+            cache->setMemoryCategory(GLTexture::MemoryCategory::Cache);
 
             cache->setFilter(GL_LINEAR);
             cache->setWrapMode(GL_CLAMP_TO_EDGE);
@@ -388,24 +390,29 @@ void LanczosFilter::performPaint(EffectWindowImpl* w, int mask, QRegion region,
 void LanczosFilter::timerEvent(QTimerEvent *event)
 {
     if (event->timerId() == m_timer.timerId()) {
-        m_timer.stop();
-
-        delete m_offscreenTarget;
-        delete m_offscreenTex;
-        m_offscreenTarget = nullptr;
-        m_offscreenTex = nullptr;
-        foreach (Client *c, Workspace::self()->clientList()) {
-            discardCacheTexture(c->effectWindow());
-        }
-        foreach (Client *c, Workspace::self()->desktopList()) {
-            discardCacheTexture(c->effectWindow());
-        }
-        foreach (Unmanaged *u, Workspace::self()->unmanagedList()) {
-            discardCacheTexture(u->effectWindow());
-        }
-        foreach (Deleted *d, Workspace::self()->deletedList()) {
-            discardCacheTexture(d->effectWindow());
-        }
+        discardCaches();
+    }
+}
+
+void LanczosFilter::discardCaches()
+{
+    m_timer.stop();
+
+    delete m_offscreenTarget;
+    delete m_offscreenTex;
+    m_offscreenTarget = nullptr;
+    m_offscreenTex = nullptr;
+    foreach (Client *c, Workspace::self()->clientList()) {
+        discardCacheTexture(c->effectWindow());
+    }
+    foreach (Client *c, Workspace::self()->desktopList()) {
+        discardCacheTexture(c->effectWindow());
+    }
+    foreach (Unmanaged *u, Workspace::self()->unmanagedList()) {
+        discardCacheTexture(u->effectWindow());
+    }
+    foreach (Deleted *d, Workspace::self()->deletedList()) {
+        discardCacheTexture(d->effectWindow());
     }
 }
 
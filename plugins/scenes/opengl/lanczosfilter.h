@@ -46,6 +46,10 @@ public:
     explicit LanczosFilter(QObject* parent = nullptr);
     ~LanczosFilter() override;
     void performPaint(EffectWindowImpl* w, int mask, QRegion region, WindowPaintData& data);
+    /**
+     * Deletes the offscreen textures and the cached results of all windows.
+     */
+    void discardCaches();
 
 protected:
     void timerEvent(QTimerEvent*) override;
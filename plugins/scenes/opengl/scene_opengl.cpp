@@ -45,6 +45,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "screens.h"
 #include "cursor.h"
 #include "decorations/decoratedclient.h"
+#include "effectframetexturecache.h"
 #include <logging.h>
 
 #include <KWayland/Server/buffer_interface.h>
@@ -66,6 +67,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QVector4D>
 #include <QMatrix4x4>
 
+#include <KConfigGroup>
 #include <KLocalizedString>
 #include <KNotification>
 #include <KProcess>
@@ -343,6 +345,10 @@ SceneOpenGL::SceneOpenGL(OpenGLBackend *backend, QObject *parent)
     m_debug = qstrcmp(qgetenv("KWIN_GL_DEBUG"), "1") == 0;
     initDebugOutput();
 
+    // in MiB, 0 means no budget
+    const qint64 textureMemoryBudget = KConfigGroup(kwinApp()->config(), "Compositing").readEntry("TextureMemoryBudget", 0);
+    GLTexture::setMemoryBudget(textureMemoryBudget * 1024 * 1024);
+
     // set strict binding
     if (options->isGlStrictBindingFollowsDriver()) {
         options->setGlStrictBinding(!glPlatform->supports(LooseBinding));
@@ -374,6 +380,8 @@ SceneOpenGL::~SceneOpenGL()
         makeOpenGLContextCurrent();
     }
     SceneOpenGL::EffectFrame::cleanup();
+    m_backBuffer.reset();
+    m_backBufferTexture.reset();
 
     delete m_syncManager;
 
@@ -657,9 +665,15 @@ qint64 SceneOpenGL::paint(QRegion damage, ToplevelList toplevels)
     // by prepareRenderingFrame(). validRegion is the region that has been
     // repainted, and may be larger than updateRegion.
     QRegion updateRegion, validRegion;
+    GLProfiler::beginFrame();
     if (m_backend->perScreenRendering()) {
         // trigger start render timer
         m_backend->prepareRenderingFrame();
+        // painting the first screen resets the repaints of the windows, collect them
+        // up front so that every screen gets the damage it needs for buffer age
+        for (Scene::Window *w : qAsConst(stacking_order)) {
+            damage |= w->window()->repaints();
+        }
         for (int i = 0; i < screens()->count(); ++i) {
             const QRect &geo = screens()->geometry(i);
             QRegion update;
@@ -679,8 +693,10 @@ qint64 SceneOpenGL::paint(QRegion damage, ToplevelList toplevels)
 
             int mask = 0;
             updateProjectionMatrix();
+            GLProfiler::begin(QStringLiteral("screen:%1").arg(screens()->name(i)));
             paintScreen(&mask, damage.intersected(geo), repaint, &update, &valid, projectionMatrix(), geo);   // call generic implementation
             paintCursor();
+            GLProfiler::end();
 
             GLVertexBuffer::streamingBuffer()->endOfFrame();
 
@@ -701,12 +717,21 @@ qint64 SceneOpenGL::paint(QRegion damage, ToplevelList toplevels)
         GLRenderTarget::setVirtualScreenGeometry(screens()->geometry());
         GLVertexBuffer::setVirtualScreenScale(1);
         GLRenderTarget::setVirtualScreenScale(1);
+        const bool usesBackBuffer = prepareBackBuffer(&repaint);
 
         int mask = 0;
         updateProjectionMatrix();
+        GLProfiler::begin(QStringLiteral("screen"));
         paintScreen(&mask, damage, repaint, &updateRegion, &validRegion, projectionMatrix());   // call generic implementation
-
-        if (!GLPlatform::instance()->isGLES()) {
+        GLProfiler::end();
+
+        if (usesBackBuffer) {
+            // the retained buffer is complete, the window's back buffer only needs the parts
+            // which get posted
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            m_backend->copyPixels(validRegion);
+            GLRenderTarget::setScreenRenderTarget(nullptr);
+        } else if (!GLPlatform::instance()->isGLES()) {
             const QSize &screenSize = screens()->size();
             const QRegion displayRegion(0, 0, screenSize.width(), screenSize.height());
 
@@ -738,11 +763,72 @@ qint64 SceneOpenGL::paint(QRegion damage, ToplevelList toplevels)
         m_currentFence = nullptr;
     }
 
+    GLProfiler::endFrame();
+
     // do cleanup
     clearStackingOrder();
+
+    if (GLTexture::isOverMemoryBudget()) {
+        enforceTextureMemoryBudget();
+    }
     return m_backend->renderTime();
 }
 
+void SceneOpenGL::enforceTextureMemoryBudget()
+{
+    const qint64 before = GLTexture::totalMemoryUsage();
+    // window contents, decorations, shadows and effect textures can't be dropped. If they
+    // alone exceed the budget, evicting the rest would only have it recreated next frame
+    const qint64 evictable = GLTexture::memoryUsage(GLTexture::MemoryCategory::Cache) +
+                             GLTexture::memoryUsage(GLTexture::MemoryCategory::PreviousWindowPixmap);
+    const bool evict = before - evictable <= GLTexture::memoryBudget();
+    if (evict) {
+        evictTextureCaches();
+    }
+    // staying over budget must not flood the log
+    if (m_memoryBudgetLogTimer.isValid() && !m_memoryBudgetLogTimer.hasExpired(10000)) {
+        return;
+    }
+    m_memoryBudgetLogTimer.start();
+    if (evict) {
+        qCDebug(KWIN_OPENGL) << "Texture memory over budget, freed" << (before - GLTexture::totalMemoryUsage()) << "bytes";
+    } else {
+        qCDebug(KWIN_OPENGL) << "Texture memory over budget, only" << evictable << "of" << before << "bytes can be freed";
+    }
+}
+
+bool SceneOpenGL::prepareBackBuffer(QRegion *repaint)
+{
+    if (options->glPreferBufferSwap() != Options::OffscreenBuffer || m_backend->supportsBufferAge() ||
+            !GLRenderTarget::supported() || !GLRenderTarget::blitSupported()) {
+        m_backBuffer.reset();
+        m_backBufferTexture.reset();
+        return false;
+    }
+    const QSize &screenSize = screens()->size();
+    if (!m_backBuffer || m_backBufferTexture->size() != screenSize) {
+        m_backBuffer.reset();
+        m_backBufferTexture.reset(new GLTexture(GL_RGBA8, screenSize));
+        m_backBuffer.reset(new GLRenderTarget(*m_backBufferTexture));
+        if (!m_backBuffer->valid()) {
+            qCWarning(KWIN_OPENGL) << "Failed to create the back buffer, falling back to the window's back buffer";
+            m_backBuffer.reset();
+            m_backBufferTexture.reset();
+            return false;
+        }
+        // nothing retained yet
+        *repaint = QRegion(0, 0, screenSize.width(), screenSize.height());
+    }
+    GLRenderTarget::setScreenRenderTarget(m_backBuffer.data());
+    return true;
+}
+
+void SceneOpenGL::evictTextureCaches()
+{
+    EffectFrameTextureCache::instance().clear();
+    discardPreviousWindowPixmaps();
+}
+
 QMatrix4x4 SceneOpenGL::transformation(int mask, const ScreenPaintData &data) const
 {
     QMatrix4x4 matrix;
@@ -1003,6 +1089,17 @@ QMatrix4x4 SceneOpenGL2::createProjectionMatrix() const
     return projection * matrix;
 }
 
+void SceneOpenGL2::evictTextureCaches()
+{
+    if (m_lanczosFilter) {
+        m_lanczosFilter->discardCaches();
+        if (!GLTexture::isOverMemoryBudget()) {
+            return;
+        }
+    }
+    SceneOpenGL::evictTextureCaches();
+}
+
 void SceneOpenGL2::updateProjectionMatrix()
 {
     m_projectionMatrix = createProjectionMatrix();
@@ -1282,6 +1379,7 @@ void SceneOpenGL2Window::setupLeafNodes(LeafNode *nodes, const WindowQuadList *q
     }
 
     nodes[ContentLeaf].texture = s_frameTexture;
+    nodes[ContentLeaf].planeTraits = s_frameTexture->planeTraits();
     nodes[ContentLeaf].hasAlpha = !isOpaque();
     // TODO: ARGB crsoofading is atm. a hack, playing on opacities for two dumb SrcOver operations
     // Should be a shader
@@ -1296,6 +1394,7 @@ void SceneOpenGL2Window::setupLeafNodes(LeafNode *nodes, const WindowQuadList *q
     if (data.crossFadeProgress() != 1.0) {
         OpenGLWindowPixmap *previous = previousWindowPixmap<OpenGLWindowPixmap>();
         nodes[PreviousContentLeaf].texture = previous ? previous->texture() : nullptr;
+        nodes[PreviousContentLeaf].planeTraits = previous ? previous->texture()->planeTraits() : ShaderTraits();
         nodes[PreviousContentLeaf].hasAlpha = !isOpaque();
         nodes[PreviousContentLeaf].opacity = data.opacity() * (1.0 - data.crossFadeProgress());
         nodes[PreviousContentLeaf].coordinateType = NormalizedCoordinates;
@@ -1326,7 +1425,8 @@ QMatrix4x4 SceneOpenGL2Window::modelViewProjectionMatrix(int mask, const WindowP
     return scene->projectionMatrix() * mvMatrix;
 }
 
-void SceneOpenGL2Window::renderSubSurface(GLShader *shader, const QMatrix4x4 &mvp, const QMatrix4x4 &windowMatrix, OpenGLWindowPixmap *pixmap, const QRegion &region, bool hardwareClipping)
+void SceneOpenGL2Window::renderSubSurface(GLShader *shader, ShaderTraits traits, const QMatrix4x4 &mvp, const QMatrix4x4 &windowMatrix, OpenGLWindowPixmap *pixmap,
+                                          const QRegion &region, bool hardwareClipping, const WindowPaintData &data)
 {
     QMatrix4x4 newWindowMatrix = windowMatrix;
     newWindowMatrix.translate(pixmap->subSurface()->position().x(), pixmap->subSurface()->position().y());
@@ -1339,11 +1439,22 @@ void SceneOpenGL2Window::renderSubSurface(GLShader *shader, const QMatrix4x4 &mv
     if (!pixmap->texture()->isNull()) {
         setBlendEnabled(pixmap->buffer() && pixmap->buffer()->hasAlphaChannel());
         // render this texture
-        shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp * newWindowMatrix);
         auto texture = pixmap->texture();
+        // video players usually show their YUV buffers on a sub-surface
+        const bool planes = traits && texture->planeTraits();
+        if (planes) {
+            GLShader *planeShader = pushPlaneShader(traits, texture, mvp * newWindowMatrix, data);
+            planeShader->setUniform(GLShader::ModulationConstant, modulate(data.opacity(), data.brightness()));
+        } else {
+            shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp * newWindowMatrix);
+        }
         texture->bind();
         texture->render(region, QRect(0, 0, texture->width() / scale, texture->height() / scale), hardwareClipping);
         texture->unbind();
+        if (planes) {
+            texture->unbindPlanes();
+            ShaderManager::instance()->popShader();
+        }
     }
 
     const auto &children = pixmap->children();
@@ -1351,12 +1462,45 @@ void SceneOpenGL2Window::renderSubSurface(GLShader *shader, const QMatrix4x4 &mv
         if (pixmap->subSurface().isNull() || pixmap->subSurface()->surface().isNull() || !pixmap->subSurface()->surface()->isMapped()) {
             continue;
         }
-        renderSubSurface(shader, mvp, newWindowMatrix, static_cast<OpenGLWindowPixmap*>(pixmap), region, hardwareClipping);
+        renderSubSurface(shader, traits, mvp, newWindowMatrix, static_cast<OpenGLWindowPixmap*>(pixmap), region, hardwareClipping, data);
     }
 }
 
+void SceneOpenGL2Window::setDeformationUniforms(GLShader *shader, const WindowPaintData &data)
+{
+    const QVector<QPointF> controlPoints = data.deformationControlPoints();
+
+    // QMatrix4x4 takes row-major values, so every matrix row holds one row of control points
+    float x[16];
+    float y[16];
+    for (int i = 0; i < 16; ++i) {
+        x[i] = controlPoints[i].x();
+        y[i] = controlPoints[i].y();
+    }
+
+    const QRectF rect = data.deformationRect();
+    shader->setUniform(GLShader::DeformationX, QMatrix4x4(x));
+    shader->setUniform(GLShader::DeformationY, QMatrix4x4(y));
+    shader->setUniform(GLShader::DeformationRect, QVector4D(rect.x(), rect.y(), rect.width(), rect.height()));
+    shader->setUniform(GLShader::DeformationProgress, float(data.deformationProgress()));
+}
+
+GLShader *SceneOpenGL2Window::pushPlaneShader(ShaderTraits traits, SceneOpenGLTexture *texture, const QMatrix4x4 &mvp, const WindowPaintData &data)
+{
+    GLShader *shader = ShaderManager::instance()->pushShader(traits | texture->planeTraits());
+    shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+    shader->setUniform(GLShader::Saturation, data.saturation());
+    shader->setUniform(GLShader::YuvToRgbMatrix, texture->yuvToRgbMatrix());
+    if (traits & ShaderTrait::Deform) {
+        setDeformationUniforms(shader, data);
+    }
+    texture->bindPlanes();
+    return shader;
+}
+
 void SceneOpenGL2Window::performPaint(int mask, QRegion region, WindowPaintData data)
 {
+    GLProfilerScope profile(GLProfiler::isEnabled() ? QStringLiteral("window:") + QString::fromUtf8(toplevel->resourceClass()) : QString());
     if (!beginRenderWindow(mask, region, data))
         return;
 
@@ -1365,8 +1509,10 @@ void SceneOpenGL2Window::performPaint(int mask, QRegion region, WindowPaintData
     const QMatrix4x4 mvpMatrix = modelViewProjection * windowMatrix;
 
     GLShader *shader = data.shader;
+    // custom shaders can't convert YUV planes, they only get the luma plane
+    ShaderTraits traits;
     if (!shader) {
-        ShaderTraits traits = ShaderTrait::MapTexture;
+        traits = ShaderTrait::MapTexture;
 
         if (data.opacity() != 1.0 || data.brightness() != 1.0 || data.crossFadeProgress() != 1.0)
             traits |= ShaderTrait::Modulate;
@@ -1374,12 +1520,29 @@ void SceneOpenGL2Window::performPaint(int mask, QRegion region, WindowPaintData
         if (data.saturation() != 1.0)
             traits |= ShaderTrait::AdjustSaturation;
 
+        if (data.isDeformed())
+            traits |= ShaderTrait::Deform;
+
         shader = ShaderManager::instance()->pushShader(traits);
     }
     shader->setUniform(GLShader::ModelViewProjectionMatrix, mvpMatrix);
 
     shader->setUniform(GLShader::Saturation, data.saturation());
 
+    if (data.isDeformed()) {
+        if (data.shader) {
+            // Custom shaders don't know about the deformation, move the vertices on the CPU
+            for (WindowQuad &quad : data.quads) {
+                for (int i = 0; i < 4; ++i) {
+                    const QPointF deformed = data.mapDeformed(QPointF(quad[i].x(), quad[i].y()));
+                    quad[i].move(deformed.x(), deformed.y());
+                }
+            }
+        } else {
+            setDeformationUniforms(shader, data);
+        }
+    }
+
     GLenum filter;
     if (waylandServer()) {
         filter = GL_LINEAR;
@@ -1479,7 +1642,13 @@ void SceneOpenGL2Window::performPaint(int mask, QRegion region, WindowPaintData
 
         setBlendEnabled(nodes[i].hasAlpha || nodes[i].opacity < 1.0);
 
-        if (opacity != nodes[i].opacity) {
+        SceneOpenGLTexture *planeTexture = nullptr;
+        if (traits && nodes[i].planeTraits) {
+            planeTexture = static_cast<SceneOpenGLTexture *>(nodes[i].texture);
+            GLShader *planeShader = pushPlaneShader(traits, planeTexture, mvpMatrix, data);
+            planeShader->setUniform(GLShader::ModulationConstant,
+                                    modulate(nodes[i].opacity, data.brightness()));
+        } else if (opacity != nodes[i].opacity) {
             shader->setUniform(GLShader::ModulationConstant,
                                modulate(nodes[i].opacity, data.brightness()));
             opacity = nodes[i].opacity;
@@ -1490,10 +1659,20 @@ void SceneOpenGL2Window::performPaint(int mask, QRegion region, WindowPaintData
         nodes[i].texture->bind();
 
         vbo->draw(region, primitiveType, nodes[i].firstVertex, nodes[i].vertexCount, m_hardwareClipping);
+
+        if (planeTexture) {
+            planeTexture->unbindPlanes();
+            ShaderManager::instance()->popShader();
+        }
     }
 
     vbo->unbindArrays();
 
+    // sub-surfaces are not deformed
+    if (data.isDeformed() && !data.shader) {
+        shader->setUniform(GLShader::DeformationProgress, 0.0f);
+    }
+
     // render sub-surfaces
     auto wp = windowPixmap<OpenGLWindowPixmap>();
     const auto &children = wp ? wp->children() : QVector<WindowPixmap*>();
@@ -1502,7 +1681,8 @@ void SceneOpenGL2Window::performPaint(int mask, QRegion region, WindowPaintData
         if (pixmap->subSurface().isNull() || pixmap->subSurface()->surface().isNull() || !pixmap->subSurface()->surface()->isMapped()) {
             continue;
         }
-        renderSubSurface(shader, modelViewProjection, windowMatrix, static_cast<OpenGLWindowPixmap*>(pixmap), region, m_hardwareClipping);
+        renderSubSurface(shader, traits & ~ShaderTraits(ShaderTrait::Deform), modelViewProjection, windowMatrix,
+                         static_cast<OpenGLWindowPixmap*>(pixmap), region, m_hardwareClipping, data);
     }
 
     setBlendEnabled(false);
@@ -1586,6 +1766,21 @@ WindowPixmap *OpenGLWindowPixmap::createChild(const QPointer<KWayland::Server::S
     return new OpenGLWindowPixmap(subSurface, this, m_scene);
 }
 
+void OpenGLWindowPixmap::markAsDiscarded()
+{
+    WindowPixmap::markAsDiscarded();
+    // only kept for cross-fading from now on
+    setMemoryCategory(GLTexture::MemoryCategory::PreviousWindowPixmap);
+}
+
+void OpenGLWindowPixmap::setMemoryCategory(GLTexture::MemoryCategory category)
+{
+    m_texture->setMemoryCategory(category);
+    for (WindowPixmap *child : children()) {
+        static_cast<OpenGLWindowPixmap*>(child)->setMemoryCategory(category);
+    }
+}
+
 bool OpenGLWindowPixmap::isValid() const
 {
     if (!m_texture->isNull()) {
@@ -1603,13 +1798,6 @@ QPixmap* SceneOpenGL::EffectFrame::m_unstyledPixmap = nullptr;
 
 SceneOpenGL::EffectFrame::EffectFrame(EffectFrameImpl* frame, SceneOpenGL *scene)
     : Scene::EffectFrame(frame)
-    , m_texture(nullptr)
-    , m_textTexture(nullptr)
-    , m_oldTextTexture(nullptr)
-    , m_textPixmap(nullptr)
-    , m_iconTexture(nullptr)
-    , m_oldIconTexture(nullptr)
-    , m_selectionTexture(nullptr)
     , m_unstyledVBO(nullptr)
     , m_scene(scene)
 {
@@ -1620,69 +1808,47 @@ SceneOpenGL::EffectFrame::EffectFrame(EffectFrameImpl* frame, SceneOpenGL *scene
 
 SceneOpenGL::EffectFrame::~EffectFrame()
 {
-    delete m_texture;
-    delete m_textTexture;
-    delete m_textPixmap;
-    delete m_oldTextTexture;
-    delete m_iconTexture;
-    delete m_oldIconTexture;
-    delete m_selectionTexture;
     delete m_unstyledVBO;
 }
 
 void SceneOpenGL::EffectFrame::free()
 {
     glFlush();
-    delete m_texture;
-    m_texture = nullptr;
-    delete m_textTexture;
-    m_textTexture = nullptr;
-    delete m_textPixmap;
-    m_textPixmap = nullptr;
-    delete m_iconTexture;
-    m_iconTexture = nullptr;
-    delete m_selectionTexture;
-    m_selectionTexture = nullptr;
+    m_texture.reset();
+    m_textTexture.reset();
+    m_iconTexture.reset();
+    m_selectionTexture.reset();
     delete m_unstyledVBO;
     m_unstyledVBO = nullptr;
-    delete m_oldIconTexture;
-    m_oldIconTexture = nullptr;
-    delete m_oldTextTexture;
-    m_oldTextTexture = nullptr;
+    m_oldIconTexture.reset();
+    m_oldTextTexture.reset();
 }
 
 void SceneOpenGL::EffectFrame::freeIconFrame()
 {
-    delete m_iconTexture;
-    m_iconTexture = nullptr;
+    m_iconTexture.reset();
 }
 
 void SceneOpenGL::EffectFrame::freeTextFrame()
 {
-    delete m_textTexture;
-    m_textTexture = nullptr;
-    delete m_textPixmap;
-    m_textPixmap = nullptr;
+    m_textTexture.reset();
 }
 
 void SceneOpenGL::EffectFrame::freeSelection()
 {
-    delete m_selectionTexture;
-    m_selectionTexture = nullptr;
+    m_selectionTexture.reset();
 }
 
 void SceneOpenGL::EffectFrame::crossFadeIcon()
 {
-    delete m_oldIconTexture;
     m_oldIconTexture = m_iconTexture;
-    m_iconTexture = nullptr;
+    m_iconTexture.reset();
 }
 
 void SceneOpenGL::EffectFrame::crossFadeText()
 {
-    delete m_oldTextTexture;
     m_oldTextTexture = m_textTexture;
-    m_textTexture = nullptr;
+    m_textTexture.reset();
 }
 
 void SceneOpenGL::EffectFrame::render(QRegion region, double opacity, double frameOpacity)
@@ -1855,7 +2021,7 @@ void SceneOpenGL::EffectFrame::render(QRegion region, double opacity, double fra
         if (!m_selectionTexture) { // Lazy creation
             QPixmap pixmap = m_effectFrame->selectionFrame().framePixmap();
             if (!pixmap.isNull())
-                m_selectionTexture = new GLTexture(pixmap);
+                m_selectionTexture = EffectFrameTextureCache::instance().pixmapTexture(pixmap);
         }
         if (m_selectionTexture) {
             if (shader) {
@@ -1903,7 +2069,7 @@ void SceneOpenGL::EffectFrame::render(QRegion region, double opacity, double fra
         }
 
         if (!m_iconTexture) { // lazy creation
-            m_iconTexture = new GLTexture(m_effectFrame->icon().pixmap(m_effectFrame->iconSize()));
+            m_iconTexture = EffectFrameTextureCache::instance().pixmapTexture(m_effectFrame->icon().pixmap(m_effectFrame->iconSize()));
         }
         m_iconTexture->bind();
         m_iconTexture->render(region, QRect(topLeft, m_effectFrame->iconSize()));
@@ -1912,18 +2078,24 @@ void SceneOpenGL::EffectFrame::render(QRegion region, double opacity, double fra
 
     // Render text
     if (!m_effectFrame->text().isEmpty()) {
-        QMatrix4x4 mvp(projection);
-        mvp.translate(m_effectFrame->geometry().x(), m_effectFrame->geometry().y());
-        shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+        // the text textures are rasterized at their bounding size, place them in the frame
+        const QRect textRect = this->textRect().translated(m_effectFrame->geometry().topLeft());
+        auto renderText = [&](GLTexture *texture) {
+            const QRect rect = EffectFrameTextureCache::alignedRect(m_effectFrame->alignment(), texture->size(), textRect);
+            QMatrix4x4 mvp(projection);
+            mvp.translate(rect.x(), rect.y());
+            shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+            texture->bind();
+            texture->render(region, rect);
+            texture->unbind();
+        };
         if (m_effectFrame->isCrossFade() && m_oldTextTexture) {
             if (shader) {
                 const float a = opacity * (1.0 - m_effectFrame->crossFadeProgress());
                 shader->setUniform(GLShader::ModulationConstant, QVector4D(a, a, a, a));
             }
 
-            m_oldTextTexture->bind();
-            m_oldTextTexture->render(region, m_effectFrame->geometry());
-            m_oldTextTexture->unbind();
+            renderText(m_oldTextTexture.data());
             if (shader) {
                 const float a = opacity * m_effectFrame->crossFadeProgress();
                 shader->setUniform(GLShader::ModulationConstant, QVector4D(a, a, a, a));
@@ -1938,9 +2110,7 @@ void SceneOpenGL::EffectFrame::render(QRegion region, double opacity, double fra
             updateTextTexture();
 
         if (m_textTexture) {
-            m_textTexture->bind();
-            m_textTexture->render(region, m_effectFrame->geometry());
-            m_textTexture->unbind();
+            renderText(m_textTexture.data());
         }
     }
 
@@ -1952,47 +2122,44 @@ void SceneOpenGL::EffectFrame::render(QRegion region, double opacity, double fra
 
 void SceneOpenGL::EffectFrame::updateTexture()
 {
-    delete m_texture;
-    m_texture = nullptr;
+    m_texture.reset();
     if (m_effectFrame->style() == EffectFrameStyled) {
         QPixmap pixmap = m_effectFrame->frame().framePixmap();
-        m_texture = new GLTexture(pixmap);
+        m_texture = EffectFrameTextureCache::instance().pixmapTexture(pixmap);
     }
 }
 
 void SceneOpenGL::EffectFrame::updateTextTexture()
 {
-    delete m_textTexture;
-    m_textTexture = nullptr;
-    delete m_textPixmap;
-    m_textPixmap = nullptr;
+    m_textTexture.reset();
 
     if (m_effectFrame->text().isEmpty())
         return;
 
-    // Determine position on texture to paint text
-    QRect rect(QPoint(0, 0), m_effectFrame->geometry().size());
-    if (!m_effectFrame->icon().isNull() && !m_effectFrame->iconSize().isEmpty())
-        rect.setLeft(m_effectFrame->iconSize().width());
-
     // If static size elide text as required
     QString text = m_effectFrame->text();
     if (m_effectFrame->isStatic()) {
         QFontMetrics metrics(m_effectFrame->font());
-        text = metrics.elidedText(text, Qt::ElideRight, rect.width());
+        text = metrics.elidedText(text, Qt::ElideRight, textRect().width());
     }
 
-    m_textPixmap = new QPixmap(m_effectFrame->geometry().size());
-    m_textPixmap->fill(Qt::transparent);
-    QPainter p(m_textPixmap);
-    p.setFont(m_effectFrame->font());
+    EffectFrameTextureCache::Text key;
+    key.text = text;
+    key.font = m_effectFrame->font();
     if (m_effectFrame->style() == EffectFrameStyled)
-        p.setPen(m_effectFrame->styledTextColor());
+        key.color = m_effectFrame->styledTextColor().rgba();
     else // TODO: What about no frame? Custom color setting required
-        p.setPen(Qt::white);
-    p.drawText(rect, m_effectFrame->alignment(), text);
-    p.end();
-    m_textTexture = new GLTexture(*m_textPixmap);
+        key.color = QColor(Qt::white).rgba();
+    key.alignment = m_effectFrame->alignment();
+    m_textTexture = EffectFrameTextureCache::instance().textTexture(key);
+}
+
+QRect SceneOpenGL::EffectFrame::textRect() const
+{
+    QRect rect(QPoint(0, 0), m_effectFrame->geometry().size());
+    if (!m_effectFrame->icon().isNull() && !m_effectFrame->iconSize().isEmpty())
+        rect.setLeft(m_effectFrame->iconSize().width());
+    return rect;
 }
 
 void SceneOpenGL::EffectFrame::updateUnstyledTexture()
@@ -2017,6 +2184,7 @@ void SceneOpenGL::EffectFrame::updateUnstyledTexture()
 
 void SceneOpenGL::EffectFrame::cleanup()
 {
+    EffectFrameTextureCache::instance().clear();
     delete m_unstyledTexture;
     m_unstyledTexture = nullptr;
     delete m_unstyledPixmap;
@@ -2094,10 +2262,114 @@ QSharedPointer<GLTexture> DecorationShadowTextureCache::getTexture(SceneOpenGLSh
     Data d;
     d.shadows << shadow;
     d.texture = QSharedPointer<GLTexture>::create(shadow->decorationShadowImage());
+    d.texture->setMemoryCategory(GLTexture::MemoryCategory::Shadow);
     m_cache.insert(decoShadow.data(), d);
     return d.texture;
 }
 
+static QSharedPointer<GLTexture> createShadowTexture(QImage image)
+{
+    // Check if the image is alpha-only in practice, and if so convert it to an 8-bpp format
+    if (!GLPlatform::instance()->isGLES() && GLTexture::supportsSwizzle() && GLTexture::supportsFormatRG()) {
+        QImage alphaImage(image.size(), QImage::Format_Indexed8); // Change to Format_Alpha8 w/ Qt 5.5
+        bool alphaOnly = true;
+
+        for (ptrdiff_t y = 0; alphaOnly && y < image.height(); y++) {
+            const uint32_t * const src = reinterpret_cast<const uint32_t *>(image.scanLine(y));
+            uint8_t * const dst = reinterpret_cast<uint8_t *>(alphaImage.scanLine(y));
+
+            for (ptrdiff_t x = 0; x < image.width(); x++) {
+                if (src[x] & 0x00ffffff)
+                    alphaOnly = false;
+
+                dst[x] = qAlpha(src[x]);
+            }
+        }
+
+        if (alphaOnly) {
+            image = alphaImage;
+        }
+    }
+
+    QSharedPointer<GLTexture> texture = QSharedPointer<GLTexture>::create(image);
+    texture->setMemoryCategory(GLTexture::MemoryCategory::Shadow);
+
+    if (texture->internalFormat() == GL_R8) {
+        // Swizzle red to alpha and all other channels to zero
+        texture->bind();
+        texture->setSwizzle(GL_ZERO, GL_ZERO, GL_ZERO, GL_RED);
+    }
+    return texture;
+}
+
+/**
+ * Shares the textures of X11 and Wayland shadows with identical content, e.g. the
+ * shadows of all menus and tooltips of a widget style.
+ */
+class ShadowTextureCache
+{
+public:
+    ~ShadowTextureCache();
+    ShadowTextureCache(const ShadowTextureCache&) = delete;
+    static ShadowTextureCache &instance();
+
+    void unregister(SceneOpenGLShadow *shadow);
+    QSharedPointer<GLTexture> getTexture(SceneOpenGLShadow *shadow, const QImage &image);
+
+private:
+    ShadowTextureCache() = default;
+    struct Data {
+        // kept to tell hash collisions apart
+        QImage image;
+        QSharedPointer<GLTexture> texture;
+        QVector<SceneOpenGLShadow*> shadows;
+    };
+    QMultiHash<uint, Data> m_cache;
+};
+
+ShadowTextureCache &ShadowTextureCache::instance()
+{
+    static ShadowTextureCache s_instance;
+    return s_instance;
+}
+
+ShadowTextureCache::~ShadowTextureCache()
+{
+    Q_ASSERT(m_cache.isEmpty());
+}
+
+void ShadowTextureCache::unregister(SceneOpenGLShadow *shadow)
+{
+    auto it = m_cache.begin();
+    while (it != m_cache.end()) {
+        auto &d = it.value();
+        d.shadows.removeAll(shadow);
+        if (d.shadows.isEmpty()) {
+            it = m_cache.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+QSharedPointer<GLTexture> ShadowTextureCache::getTexture(SceneOpenGLShadow *shadow, const QImage &image)
+{
+    unregister(shadow);
+    const uint key = qHashBits(image.constBits(), image.sizeInBytes(), uint(image.width() << 16 | image.height()));
+    for (auto it = m_cache.find(key); it != m_cache.end() && it.key() == key; ++it) {
+        if (it.value().image == image) {
+            it.value().shadows << shadow;
+            return it.value().texture;
+        }
+    }
+    Data d;
+    d.image = image;
+    d.shadows << shadow;
+    d.texture = createShadowTexture(image);
+    m_cache.insert(key, d);
+    return d.texture;
+}
+
 SceneOpenGLShadow::SceneOpenGLShadow(Toplevel *toplevel)
     : Shadow(toplevel)
 {
@@ -2109,6 +2381,7 @@ SceneOpenGLShadow::~SceneOpenGLShadow()
     if (scene) {
         scene->makeOpenGLContextCurrent();
         DecorationShadowTextureCache::instance().unregister(this);
+        ShadowTextureCache::instance().unregister(this);
         m_texture.reset();
     }
 }
@@ -2368,6 +2641,7 @@ bool SceneOpenGLShadow::prepareBackend()
         // simplifies a lot by going directly to
         Scene *scene = Compositor::self()->scene();
         scene->makeOpenGLContextCurrent();
+        ShadowTextureCache::instance().unregister(this);
         m_texture = DecorationShadowTextureCache::instance().getTexture(this);
 
         return true;
@@ -2414,37 +2688,9 @@ bool SceneOpenGLShadow::prepareBackend()
 
     p.end();
 
-    // Check if the image is alpha-only in practice, and if so convert it to an 8-bpp format
-    if (!GLPlatform::instance()->isGLES() && GLTexture::supportsSwizzle() && GLTexture::supportsFormatRG()) {
-        QImage alphaImage(image.size(), QImage::Format_Indexed8); // Change to Format_Alpha8 w/ Qt 5.5
-        bool alphaOnly = true;
-
-        for (ptrdiff_t y = 0; alphaOnly && y < image.height(); y++) {
-            const uint32_t * const src = reinterpret_cast<const uint32_t *>(image.scanLine(y));
-            uint8_t * const dst = reinterpret_cast<uint8_t *>(alphaImage.scanLine(y));
-
-            for (ptrdiff_t x = 0; x < image.width(); x++) {
-                if (src[x] & 0x00ffffff)
-                    alphaOnly = false;
-
-                dst[x] = qAlpha(src[x]);
-            }
-        }
-
-        if (alphaOnly) {
-            image = alphaImage;
-        }
-    }
-
     Scene *scene = Compositor::self()->scene();
     scene->makeOpenGLContextCurrent();
-    m_texture = QSharedPointer<GLTexture>::create(image);
-
-    if (m_texture->internalFormat() == GL_R8) {
-        // Swizzle red to alpha and all other channels to zero
-        m_texture->bind();
-        m_texture->setSwizzle(GL_ZERO, GL_ZERO, GL_ZERO, GL_RED);
-    }
+    m_texture = ShadowTextureCache::instance().getTexture(this, image);
 
     return true;
 }
@@ -2551,6 +2797,7 @@ void SceneOpenGLDecorationRenderer::resizeTexture()
 
     if (!size.isEmpty()) {
         m_texture.reset(new GLTexture(GL_RGBA8, size.width(), size.height()));
+        m_texture->setMemoryCategory(GLTexture::MemoryCategory::Decoration);
         m_texture->setYInverted(true);
         m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
         m_texture->clear();
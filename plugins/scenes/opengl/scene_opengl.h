@@ -30,6 +30,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "decorations/decorationrenderer.h"
 #include "platformsupport/scenes/opengl/backend.h"
 
+#include <QElapsedTimer>
+
 namespace KWin
 {
 class LanczosFilter;
@@ -95,16 +97,31 @@ protected:
 
     virtual void doPaintBackground(const QVector<float> &vertices) = 0;
     virtual void updateProjectionMatrix() = 0;
+    /**
+     * Called after a frame if the textures exceed GLTexture::memoryBudget() and
+     * evicting brings them below it.
+     * Frees textures which can be recreated or are only nice to have.
+     */
+    virtual void evictTextureCaches();
 
 protected:
     bool init_ok;
 private:
     bool viewportLimitsMatched(const QSize &size) const;
+    /**
+     * Binds the retained back buffer as the screen render target if the swap strategy
+     * asks for it. Adds the whole screen to @p repaint if the buffer got (re)created.
+     */
+    bool prepareBackBuffer(QRegion *repaint);
+    void enforceTextureMemoryBudget();
 private:
     bool m_debug;
     OpenGLBackend *m_backend;
     SyncManager *m_syncManager;
     SyncObject *m_currentFence;
+    QScopedPointer<GLTexture> m_backBufferTexture;
+    QScopedPointer<GLRenderTarget> m_backBuffer;
+    QElapsedTimer m_memoryBudgetLogTimer;
 };
 
 class SceneOpenGL2 : public SceneOpenGL
@@ -130,6 +147,7 @@ protected:
     void finalDrawWindow(EffectWindowImpl* w, int mask, QRegion region, WindowPaintData& data) override;
     void updateProjectionMatrix() override;
     void paintCursor() override;
+    void evictTextureCaches() override;
 
 private:
     void performPaintWindow(EffectWindowImpl* w, int mask, QRegion region, WindowPaintData& data);
@@ -198,6 +216,8 @@ public:
         float opacity;
         bool hasAlpha;
         TextureCoordinateType coordinateType;
+        // the texture is a SceneOpenGLTexture with several planes, see SceneOpenGLTexture::planeTraits()
+        ShaderTraits planeTraits;
     };
 
     explicit SceneOpenGL2Window(Toplevel *c);
@@ -211,7 +231,13 @@ protected:
     void performPaint(int mask, QRegion region, WindowPaintData data) override;
 
 private:
-    void renderSubSurface(GLShader *shader, const QMatrix4x4 &mvp, const QMatrix4x4 &windowMatrix, OpenGLWindowPixmap *pixmap, const QRegion &region, bool hardwareClipping);
+    void renderSubSurface(GLShader *shader, ShaderTraits traits, const QMatrix4x4 &mvp, const QMatrix4x4 &windowMatrix, OpenGLWindowPixmap *pixmap,
+                          const QRegion &region, bool hardwareClipping, const WindowPaintData &data);
+    static void setDeformationUniforms(GLShader *shader, const WindowPaintData &data);
+    /**
+     * Pushes the shader with @p traits sampling the planes of @p texture and binds the planes.
+     */
+    static GLShader *pushPlaneShader(ShaderTraits traits, SceneOpenGLTexture *texture, const QMatrix4x4 &mvp, const WindowPaintData &data);
     /**
      * Whether prepareStates enabled blending and restore states should disable again.
      */
@@ -226,10 +252,12 @@ public:
     SceneOpenGLTexture *texture() const;
     bool bind();
     bool isValid() const override;
+    void markAsDiscarded() override;
 protected:
     WindowPixmap *createChild(const QPointer<KWayland::Server::SubSurfaceInterface> &subSurface) override;
 private:
     explicit OpenGLWindowPixmap(const QPointer<KWayland::Server::SubSurfaceInterface> &subSurface, WindowPixmap *parent, SceneOpenGL *scene);
+    void setMemoryCategory(GLTexture::MemoryCategory category);
     QScopedPointer<SceneOpenGLTexture> m_texture;
     SceneOpenGL *m_scene;
 };
@@ -256,14 +284,16 @@ public:
 private:
     void updateTexture();
     void updateTextTexture();
+    // the area of the frame next to the icon, relative to the frame
+    QRect textRect() const;
 
-    GLTexture *m_texture;
-    GLTexture *m_textTexture;
-    GLTexture *m_oldTextTexture;
-    QPixmap *m_textPixmap; // need to keep the pixmap around to workaround some driver problems
-    GLTexture *m_iconTexture;
-    GLTexture *m_oldIconTexture;
-    GLTexture *m_selectionTexture;
+    // shared with other frames showing the same content
+    QSharedPointer<GLTexture> m_texture;
+    QSharedPointer<GLTexture> m_textTexture;
+    QSharedPointer<GLTexture> m_oldTextTexture;
+    QSharedPointer<GLTexture> m_iconTexture;
+    QSharedPointer<GLTexture> m_oldIconTexture;
+    QSharedPointer<GLTexture> m_selectionTexture;
     GLVertexBuffer *m_unstyledVBO;
     SceneOpenGL *m_scene;
 
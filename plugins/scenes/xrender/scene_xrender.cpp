@@ -45,6 +45,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QPainter>
 #include <QtMath>
 
+#include <cstring>
+
 namespace KWin
 {
 
@@ -232,6 +234,7 @@ SceneXrender* SceneXrender::createScene(QObject *parent)
 SceneXrender::SceneXrender(XRenderBackend *backend, QObject *parent)
     : Scene(parent)
     , m_backend(backend)
+    , m_requestStats(qEnvironmentVariableIntValue("KWIN_XRENDER_REQUEST_STATS") != 0)
 {
 }
 
@@ -251,6 +254,8 @@ qint64 SceneXrender::paint(QRegion damage, ToplevelList toplevels)
 {
     QElapsedTimer renderTimer;
     renderTimer.start();
+    // the sequence numbers of two no-op requests enclose all requests of the frame
+    const unsigned int firstRequest = m_requestStats ? xcb_no_operation(connection()).sequence : 0;
 
     createStackingOrder(toplevels);
 
@@ -264,6 +269,11 @@ qint64 SceneXrender::paint(QRegion damage, ToplevelList toplevels)
     // do cleanup
     clearStackingOrder();
 
+    if (m_requestStats) {
+        const unsigned int lastRequest = xcb_no_operation(connection()).sequence;
+        qCDebug(KWIN_XRENDER) << "Frame issued" << (lastRequest - firstRequest - 1) << "X requests";
+    }
+
     return renderTimer.nsecsElapsed();
 }
 
@@ -313,6 +323,7 @@ Decoration::Renderer *SceneXrender::createDecorationRenderer(Decoration::Decorat
 //****************************************
 
 XRenderPicture *SceneXrender::Window::s_tempPicture = nullptr;
+XRenderPictureState SceneXrender::Window::s_tempPictureState;
 QRect SceneXrender::Window::temp_visibleRect;
 XRenderPicture *SceneXrender::Window::s_fadeAlphaPicture = nullptr;
 
@@ -332,6 +343,7 @@ void SceneXrender::Window::cleanup()
 {
     delete s_tempPicture;
     s_tempPicture = nullptr;
+    s_tempPictureState.reset();
     delete s_fadeAlphaPicture;
     s_fadeAlphaPicture = nullptr;
 }
@@ -399,6 +411,7 @@ void SceneXrender::Window::prepareTempPixmap()
         xcb_pixmap_t pix = xcb_generate_id(connection());
         xcb_create_pixmap(connection(), 32, pix, rootWindow(), temp_visibleRect.width(), temp_visibleRect.height());
         s_tempPicture = new XRenderPicture(pix, 32);
+        s_tempPictureState.reset();
         xcb_free_pixmap(connection(), pix);
     }
     const xcb_render_color_t transparent = {0, 0, 0, 0};
@@ -525,6 +538,8 @@ void SceneXrender::Window::performPaint(int mask, QRegion region, WindowPaintDat
     const bool blitInTempPixmap = xRenderOffscreen() || (data.crossFadeProgress() < 1.0 && !opaque) ||
                                  (scaled && (wantShadow || (client && !client->noBorder()) || (deleted && !deleted->noBorder())));
 
+    // the attributes of the window picture are kept between frames, only changes cause requests
+    XRenderPictureState &picState = pixmap->pictureState();
     xcb_render_picture_t renderTarget = m_scene->xrenderBufferPicture();
     if (blitInTempPixmap) {
         if (scene_xRenderOffscreenTarget()) {
@@ -534,11 +549,12 @@ void SceneXrender::Window::performPaint(int mask, QRegion region, WindowPaintDat
             prepareTempPixmap();
             renderTarget = *s_tempPicture;
         }
+        picState.setTransform(pic, identity);
+        picState.setFilter(pic, ImageFilterFast);
+        picState.setRepeat(pic, XCB_RENDER_REPEAT_NONE);
     } else {
-        xcb_render_set_picture_transform(connection(), pic, xform);
-        if (filter == ImageFilterGood) {
-            setPictureFilter(pic, KWin::Scene::ImageFilterGood);
-        }
+        picState.setTransform(pic, xform);
+        picState.setFilter(pic, filter);
 
         //BEGIN OF STUPID RADEON HACK
         // This is needed to avoid hitting a fallback in the radeon driver.
@@ -551,10 +567,7 @@ void SceneXrender::Window::performPaint(int mask, QRegion region, WindowPaintDat
         // transformation matrix, and doesn't have an alpha channel.
         // Since we only scale the picture, we can work around this by setting
         // the repeat mode to RepeatPad.
-        if (!window()->hasAlpha()) {
-            const uint32_t values[] = {XCB_RENDER_REPEAT_PAD};
-            xcb_render_change_picture(connection(), pic, XCB_RENDER_CP_REPEAT, values);
-        }
+        picState.setRepeat(pic, window()->hasAlpha() ? XCB_RENDER_REPEAT_NONE : XCB_RENDER_REPEAT_PAD);
         //END OF STUPID RADEON HACK
     }
 #define MAP_RECT_TO_TARGET(_RECT_) \
@@ -637,6 +650,7 @@ void SceneXrender::Window::performPaint(int mask, QRegion region, WindowPaintDat
     for (PaintClipper::Iterator iterator; !iterator.isDone(); iterator.next()) {
 
 #define RENDER_SHADOW_TILE(_TILE_, _RECT_) \
+if (!_RECT_.isEmpty()) \
 xcb_render_composite(connection(), XCB_RENDER_PICT_OP_OVER, m_xrenderShadow->picture(SceneXRenderShadow::ShadowElement##_TILE_), \
                  shadowAlpha, renderTarget, 0, 0, 0, 0, _RECT_.x(), _RECT_.y(), _RECT_.width(), _RECT_.height())
 
@@ -644,7 +658,7 @@ xcb_render_composite(connection(), XCB_RENDER_PICT_OP_OVER, m_xrenderShadow->pic
         if (wantShadow) {
             xcb_render_picture_t shadowAlpha = XCB_RENDER_PICTURE_NONE;
             if (!opaque) {
-                shadowAlpha = xRenderBlendPicture(data.opacity());
+                shadowAlpha = alphaPicture(data.opacity());
             }
             RENDER_SHADOW_TILE(TopLeft, stlr);
             RENDER_SHADOW_TILE(Top, str);
@@ -661,7 +675,7 @@ xcb_render_composite(connection(), XCB_RENDER_PICT_OP_OVER, m_xrenderShadow->pic
         if (!(client && client->isShade())) {
             xcb_render_picture_t clientAlpha = XCB_RENDER_PICTURE_NONE;
             if (!opaque) {
-                clientAlpha = xRenderBlendPicture(data.opacity());
+                clientAlpha = alphaPicture(data.opacity());
             }
             xcb_render_composite(connection(), clientRenderOp, pic, clientAlpha, renderTarget,
                                  cr.x(), cr.y(), 0, 0, dr.x(), dr.y(), dr.width(), dr.height());
@@ -682,16 +696,15 @@ xcb_render_composite(connection(), XCB_RENDER_PICT_OP_OVER, m_xrenderShadow->pic
                             DOUBLE_TO_FIXED(0), DOUBLE_TO_FIXED(FIXED_TO_DOUBLE(xform.matrix22) * previous->size().height() / pixmap->size().height()), DOUBLE_TO_FIXED(0),
                             DOUBLE_TO_FIXED(0), DOUBLE_TO_FIXED(0), DOUBLE_TO_FIXED(1)
                             };
-                        xcb_render_set_picture_transform(connection(), previous->picture(), xform2);
+                        previous->pictureState().setTransform(previous->picture(), xform2);
+                    } else {
+                        previous->pictureState().setTransform(previous->picture(), identity);
                     }
 
                     xcb_render_composite(connection(), opaque ? XCB_RENDER_PICT_OP_OVER : XCB_RENDER_PICT_OP_ATOP,
                                          previous->picture(), *s_fadeAlphaPicture, renderTarget,
                                          cr.x(), cr.y(), 0, 0, dr.x(), dr.y(), dr.width(), dr.height());
 
-                    if (previous->size() != pixmap->size()) {
-                        xcb_render_set_picture_transform(connection(), previous->picture(), identity);
-                    }
                 }
             }
             if (!opaque)
@@ -700,7 +713,7 @@ xcb_render_composite(connection(), XCB_RENDER_PICT_OP_OVER, m_xrenderShadow->pic
 
         if (client || deleted) {
             if (!noBorder) {
-                xcb_render_picture_t decorationAlpha = xRenderBlendPicture(data.opacity());
+                xcb_render_picture_t decorationAlpha = alphaPicture(data.opacity());
                 auto renderDeco = [decorationAlpha, renderTarget](xcb_render_picture_t deco, const QRect &rect) {
                     if (deco == XCB_RENDER_PICTURE_NONE) {
                         return;
@@ -736,39 +749,30 @@ xcb_render_composite(connection(), XCB_RENDER_PICT_OP_OVER, m_xrenderShadow->pic
         }
         if (blitInTempPixmap) {
             const QRect r = mapToScreen(mask, data, temp_visibleRect);
-            xcb_render_set_picture_transform(connection(), *s_tempPicture, xform);
-            setPictureFilter(*s_tempPicture, filter);
+            s_tempPictureState.setTransform(*s_tempPicture, xform);
+            s_tempPictureState.setFilter(*s_tempPicture, filter);
             xcb_render_composite(connection(), XCB_RENDER_PICT_OP_OVER, *s_tempPicture,
                                  XCB_RENDER_PICTURE_NONE, m_scene->xrenderBufferPicture(),
                                  0, 0, 0, 0, r.x(), r.y(), r.width(), r.height());
-            xcb_render_set_picture_transform(connection(), *s_tempPicture, identity);
-        }
-    }
-    if (scaled && !blitInTempPixmap) {
-        xcb_render_set_picture_transform(connection(), pic, identity);
-        if (filter == ImageFilterGood)
-            setPictureFilter(pic, KWin::Scene::ImageFilterFast);
-        if (!window()->hasAlpha()) {
-            const uint32_t values[] = {XCB_RENDER_REPEAT_NONE};
-            xcb_render_change_picture(connection(), pic, XCB_RENDER_CP_REPEAT, values);
+            s_tempPictureState.setTransform(*s_tempPicture, identity);
         }
     }
     if (xRenderOffscreen())
         scene_setXRenderOffscreenTarget(*s_tempPicture);
 }
 
-void SceneXrender::Window::setPictureFilter(xcb_render_picture_t pic, Scene::ImageFilterType filter)
+xcb_render_picture_t SceneXrender::Window::alphaPicture(qreal opacity)
 {
-    QByteArray filterName;
-    switch (filter) {
-    case KWin::Scene::ImageFilterFast:
-        filterName = QByteArray("fast");
-        break;
-    case KWin::Scene::ImageFilterGood:
-        filterName = QByteArray("good");
-        break;
+    if (!m_alphaPicture) {
+        xcb_render_color_t color = {0, 0, 0, uint16_t(opacity * 0xffff)};
+        m_alphaPicture.reset(new XRenderPicture(xRenderFill(color)));
+    } else if (m_alphaPictureOpacity != opacity) {
+        xcb_render_color_t color = {0, 0, 0, uint16_t(opacity * 0xffff)};
+        xcb_rectangle_t rect = {0, 0, 1, 1};
+        xcb_render_fill_rectangles(connection(), XCB_RENDER_PICT_OP_SRC, *m_alphaPicture, color, 1, &rect);
     }
-    xcb_render_set_picture_filter(connection(), pic, filterName.length(), filterName.constData(), 0, nullptr);
+    m_alphaPictureOpacity = opacity;
+    return *m_alphaPicture;
 }
 
 WindowPixmap* SceneXrender::Window::createWindowPixmap()
@@ -782,6 +786,65 @@ void SceneXrender::screenGeometryChanged(const QSize &size)
     m_backend->screenGeometryChanged(size);
 }
 
+//****************************************
+// XRenderPictureState
+//****************************************
+
+static const xcb_render_transform_t s_identityTransform = {
+    DOUBLE_TO_FIXED(1), DOUBLE_TO_FIXED(0), DOUBLE_TO_FIXED(0),
+    DOUBLE_TO_FIXED(0), DOUBLE_TO_FIXED(1), DOUBLE_TO_FIXED(0),
+    DOUBLE_TO_FIXED(0), DOUBLE_TO_FIXED(0), DOUBLE_TO_FIXED(1)
+};
+
+XRenderPictureState::XRenderPictureState()
+{
+    reset();
+}
+
+void XRenderPictureState::reset()
+{
+    m_transform = s_identityTransform;
+    m_filter = Scene::ImageFilterFast;
+    m_repeat = XCB_RENDER_REPEAT_NONE;
+}
+
+void XRenderPictureState::setTransform(xcb_render_picture_t picture, const xcb_render_transform_t &transform)
+{
+    if (memcmp(&m_transform, &transform, sizeof(xcb_render_transform_t)) == 0) {
+        return;
+    }
+    xcb_render_set_picture_transform(connection(), picture, transform);
+    m_transform = transform;
+}
+
+void XRenderPictureState::setFilter(xcb_render_picture_t picture, Scene::ImageFilterType filter)
+{
+    if (m_filter == filter) {
+        return;
+    }
+    QByteArray filterName;
+    switch (filter) {
+    case KWin::Scene::ImageFilterFast:
+        filterName = QByteArray("fast");
+        break;
+    case KWin::Scene::ImageFilterGood:
+        filterName = QByteArray("good");
+        break;
+    }
+    xcb_render_set_picture_filter(connection(), picture, filterName.length(), filterName.constData(), 0, nullptr);
+    m_filter = filter;
+}
+
+void XRenderPictureState::setRepeat(xcb_render_picture_t picture, uint32_t repeat)
+{
+    if (m_repeat == repeat) {
+        return;
+    }
+    const uint32_t values[] = {repeat};
+    xcb_render_change_picture(connection(), picture, XCB_RENDER_CP_REPEAT, values);
+    m_repeat = repeat;
+}
+
 //****************************************
 // XRenderWindowPixmap
 //****************************************
@@ -143,6 +143,27 @@ private:
     xcb_render_pictformat_t m_format;
 };
 
+/**
+ * Remembers the transformation, filter and repeat mode last set on a picture, so that
+ * requests which wouldn't change anything are not sent to the X server.
+ */
+class XRenderPictureState
+{
+public:
+    XRenderPictureState();
+    void setTransform(xcb_render_picture_t picture, const xcb_render_transform_t &transform);
+    void setFilter(xcb_render_picture_t picture, Scene::ImageFilterType filter);
+    void setRepeat(xcb_render_picture_t picture, uint32_t repeat);
+    /**
+     * The picture got recreated with the default attributes.
+     */
+    void reset();
+private:
+    xcb_render_transform_t m_transform;
+    Scene::ImageFilterType m_filter;
+    uint32_t m_repeat;
+};
+
 class SceneXrender
     : public Scene
 {
@@ -183,6 +204,8 @@ private:
     static ScreenPaintData screen_paint;
     class Window;
     QScopedPointer<XRenderBackend> m_backend;
+    // log the number of X requests per frame, set through KWIN_XRENDER_REQUEST_STATS
+    bool m_requestStats = false;
 };
 
 class SceneXrender::Window
@@ -201,12 +224,16 @@ private:
     QRect mapToScreen(int mask, const WindowPaintData &data, const QRect &rect) const;
     QPoint mapToScreen(int mask, const WindowPaintData &data, const QPoint &point) const;
     void prepareTempPixmap();
-    void setPictureFilter(xcb_render_picture_t pic, ImageFilterType filter);
+    xcb_render_picture_t alphaPicture(qreal opacity);
     SceneXrender *m_scene;
     xcb_render_pictformat_t format;
     QRegion transformed_shape;
+    // 1x1 picture holding the opacity the window got painted with last
+    QScopedPointer<XRenderPicture> m_alphaPicture;
+    qreal m_alphaPictureOpacity = -1.0;
     static QRect temp_visibleRect;
     static XRenderPicture *s_tempPicture;
+    static XRenderPictureState s_tempPictureState;
     static XRenderPicture *s_fadeAlphaPicture;
 };
 
@@ -216,10 +243,14 @@ public:
     explicit XRenderWindowPixmap(Scene::Window *window, xcb_render_pictformat_t format);
     ~XRenderWindowPixmap() override;
     xcb_render_picture_t picture() const;
+    XRenderPictureState &pictureState() {
+        return m_pictureState;
+    }
     void create() override;
 private:
     xcb_render_picture_t m_picture;
     xcb_render_pictformat_t m_format;
+    XRenderPictureState m_pictureState;
 };
 
 class SceneXrender::EffectFrame
@@ -0,0 +1,271 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "presentation_time.h"
+#include "abstract_output.h"
+#include "main.h"
+#include "platform.h"
+#include "toplevel.h"
+
+#include <KWayland/Server/display.h>
+#include <KWayland/Server/subcompositor_interface.h>
+#include <KWayland/Server/surface_interface.h>
+
+#include <wayland-server.h>
+#include "wayland-presentation-time-server-protocol.h"
+
+using namespace KWayland::Server;
+
+namespace KWin
+{
+
+static const quint32 s_version = 1;
+
+const struct wp_presentation_interface PresentationTime::s_interface = {
+    PresentationTime::destroyCallback,
+    PresentationTime::feedbackCallback
+};
+
+PresentationTime::PresentationTime(Display *display, QObject *parent)
+    : QObject(parent)
+{
+    m_global = wl_global_create(*display, &wp_presentation_interface, s_version, this, bind);
+    connect(display, &Display::aboutToTerminate, this,
+        [this] {
+            if (m_global) {
+                wl_global_destroy(m_global);
+                m_global = nullptr;
+            }
+        }
+    );
+}
+
+PresentationTime::~PresentationTime()
+{
+    if (m_global) {
+        wl_global_destroy(m_global);
+    }
+}
+
+void PresentationTime::bind(wl_client *client, void *data, uint32_t version, uint32_t id)
+{
+    wl_resource *resource = wl_resource_create(client, &wp_presentation_interface, qMin(version, s_version), id);
+    if (!resource) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    wl_resource_set_implementation(resource, &s_interface, data, nullptr);
+    wp_presentation_send_clock_id(resource, CLOCK_MONOTONIC);
+}
+
+void PresentationTime::destroyCallback(wl_client *client, wl_resource *resource)
+{
+    Q_UNUSED(client)
+    wl_resource_destroy(resource);
+}
+
+void PresentationTime::feedbackCallback(wl_client *client, wl_resource *resource, wl_resource *surface, uint32_t callback)
+{
+    PresentationTime *p = reinterpret_cast<PresentationTime*>(wl_resource_get_user_data(resource));
+    wl_resource *feedback = wl_resource_create(client, &wp_presentation_feedback_interface, wl_resource_get_version(resource), callback);
+    if (!feedback) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    wl_resource_set_implementation(feedback, nullptr, p, feedbackDestroyed);
+    p->addFeedback(SurfaceInterface::get(surface), feedback);
+}
+
+void PresentationTime::feedbackDestroyed(wl_resource *resource)
+{
+    PresentationTime *p = reinterpret_cast<PresentationTime*>(wl_resource_get_user_data(resource));
+    p->removeFeedback(resource);
+}
+
+void PresentationTime::addFeedback(SurfaceInterface *surface, wl_resource *feedback)
+{
+    if (!surface) {
+        discard({feedback});
+        return;
+    }
+    m_pending[surface] << feedback;
+    m_feedbackSurfaces.insert(feedback, surface);
+    if (m_trackedSurfaces.contains(surface)) {
+        return;
+    }
+    m_trackedSurfaces.insert(surface);
+    connect(surface, &SurfaceInterface::committed, this, [this, surface] { surfaceCommitted(surface); });
+    connect(surface, &QObject::destroyed, this, [this, surface] { surfaceDestroyed(surface); });
+}
+
+template <typename Key>
+static void removeFromHash(QHash<Key, QVector<wl_resource*>> &hash, wl_resource *feedback)
+{
+    for (auto it = hash.begin(); it != hash.end();) {
+        if (it->removeOne(feedback) && it->isEmpty()) {
+            it = hash.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PresentationTime::removeFeedback(wl_resource *feedback)
+{
+    // the client destroyed the feedback before it got answered
+    removeFromHash(m_pending, feedback);
+    removeFromHash(m_committed, feedback);
+    removeFromHash(m_latched, feedback);
+    m_feedbackSurfaces.remove(feedback);
+}
+
+void PresentationTime::surfaceCommitted(SurfaceInterface *surface)
+{
+    auto it = m_pending.find(surface);
+    if (it == m_pending.end()) {
+        return;
+    }
+    const QVector<wl_resource*> feedbacks = *it;
+    m_pending.erase(it);
+    // the previous content update never made it to screen
+    const QVector<wl_resource*> replaced = m_committed.take(surface);
+    discard(replaced);
+    m_committed.insert(surface, feedbacks);
+}
+
+void PresentationTime::surfaceDestroyed(SurfaceInterface *surface)
+{
+    m_trackedSurfaces.remove(surface);
+    discard(m_pending.take(surface));
+    discard(m_committed.take(surface));
+    // painted, but the surface is gone before the frame reached the screen
+    QVector<wl_resource*> latched;
+    for (auto it = m_feedbackSurfaces.constBegin(); it != m_feedbackSurfaces.constEnd(); ++it) {
+        if (it.value() == surface) {
+            latched << it.key();
+        }
+    }
+    for (wl_resource *feedback : qAsConst(latched)) {
+        removeFromHash(m_latched, feedback);
+    }
+    discard(latched);
+}
+
+void PresentationTime::outputRemoved(AbstractOutput *output)
+{
+    // the output won't present the frame any more
+    discard(m_latched.take(output));
+}
+
+void PresentationTime::lock(const QList<Toplevel*> &windows)
+{
+    if (m_committed.isEmpty()) {
+        return;
+    }
+    const Outputs outputs = kwinApp()->platform()->enabledOutputs();
+    for (Toplevel *window : windows) {
+        SurfaceInterface *surface = window->surface();
+        if (!surface) {
+            continue;
+        }
+        // the output showing the largest part of the window defines the presentation
+        AbstractOutput *output = nullptr;
+        int largestArea = 0;
+        for (AbstractOutput *candidate : outputs) {
+            const QRect intersected = candidate->geometry() & window->geometry();
+            const int area = intersected.width() * intersected.height();
+            if (area > largestArea) {
+                largestArea = area;
+                output = candidate;
+            }
+        }
+        lockSurface(surface, output);
+    }
+}
+
+void PresentationTime::lockSurface(SurfaceInterface *surface, AbstractOutput *output)
+{
+    auto it = m_committed.find(surface);
+    if (it != m_committed.end()) {
+        const QVector<wl_resource*> feedbacks = *it;
+        m_committed.erase(it);
+        if (output) {
+            m_latched[output] << feedbacks;
+        } else {
+            // not on any output, so no output will present it
+            discard(feedbacks);
+        }
+    }
+    const auto children = surface->childSubSurfaces();
+    for (const auto &child : children) {
+        if (child && child->surface()) {
+            lockSurface(child->surface().data(), output);
+        }
+    }
+}
+
+static void sendPresented(const QVector<wl_resource*> &feedbacks, const timespec &timestamp,
+                          quint32 refresh, quint64 sequence, quint32 flags)
+{
+    const quint64 seconds = timestamp.tv_sec;
+    for (wl_resource *feedback : feedbacks) {
+        wp_presentation_feedback_send_presented(feedback,
+                                                seconds >> 32, seconds & 0xffffffff,
+                                                timestamp.tv_nsec,
+                                                refresh,
+                                                sequence >> 32, sequence & 0xffffffff,
+                                                flags);
+        wl_resource_destroy(feedback);
+    }
+}
+
+void PresentationTime::presented(AbstractOutput *output, const timespec &timestamp, quint64 sequence, Kinds flags)
+{
+    const QVector<wl_resource*> feedbacks = m_latched.take(output);
+    if (feedbacks.isEmpty()) {
+        return;
+    }
+    // refreshRate is in mHz, the protocol wants the refresh interval in nanoseconds
+    const int refreshRate = output->refreshRate();
+    const quint32 refresh = refreshRate > 0 ? 1000000000000ull / refreshRate : 0;
+    sendPresented(feedbacks, timestamp, refresh, sequence, uint(flags));
+}
+
+void PresentationTime::presentedUnsynchronized()
+{
+    if (m_latched.isEmpty()) {
+        return;
+    }
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    // the outputs might be gone already, so don't look at them
+    const auto latched = m_latched;
+    m_latched.clear();
+    for (auto it = latched.begin(); it != latched.end(); ++it) {
+        sendPresented(it.value(), now, 0, 0, 0);
+    }
+}
+
+void PresentationTime::discard(const QVector<wl_resource*> &feedbacks)
+{
+    for (wl_resource *feedback : feedbacks) {
+        wp_presentation_feedback_send_discarded(feedback);
+        wl_resource_destroy(feedback);
+    }
+}
+
+}
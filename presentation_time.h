@@ -0,0 +1,123 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#pragma once
+
+#include <kwinglobals.h>
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+#include <time.h>
+
+struct wl_client;
+struct wl_global;
+struct wl_resource;
+struct wp_presentation_interface;
+
+namespace KWayland
+{
+namespace Server
+{
+class Display;
+class SurfaceInterface;
+}
+}
+
+namespace KWin
+{
+class AbstractOutput;
+class Toplevel;
+
+/**
+ * Implementation of the wp_presentation protocol.
+ *
+ * Clients request a feedback for the next content update of a surface. When the
+ * Compositor painted a frame showing the update, the feedback gets latched to the output
+ * showing most of the window. Once the platform reports that the frame is on screen, the
+ * feedback is answered with the timestamp, the refresh interval and the sequence counter
+ * of the output. Feedbacks of updates which got replaced before they were painted are
+ * discarded.
+ *
+ * All timestamps use CLOCK_MONOTONIC.
+ */
+class KWIN_EXPORT PresentationTime : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Kind {
+        Vsync = 0x1,
+        HwClock = 0x2,
+        HwCompletion = 0x4,
+        ZeroCopy = 0x8
+    };
+    Q_DECLARE_FLAGS(Kinds, Kind)
+
+    explicit PresentationTime(KWayland::Server::Display *display, QObject *parent = nullptr);
+    ~PresentationTime() override;
+
+    /**
+     * The content of @p windows is part of the frame the Compositor just painted.
+     */
+    void lock(const QList<Toplevel*> &windows);
+    /**
+     * The frame painted last is on screen of @p output since @p timestamp.
+     * @p sequence is the output's vertical retrace counter, if known.
+     */
+    void presented(AbstractOutput *output, const timespec &timestamp, quint64 sequence, Kinds flags);
+    /**
+     * The frame painted last is on screen of all outputs which didn't report
+     * their presentation, e.g. because the platform doesn't provide page flip events.
+     * Uses the current time as timestamp.
+     */
+    void presentedUnsynchronized();
+    /**
+     * Discards the feedbacks waiting for @p output, which got removed or disabled.
+     */
+    void outputRemoved(AbstractOutput *output);
+
+private:
+    static void bind(wl_client *client, void *data, uint32_t version, uint32_t id);
+    static void destroyCallback(wl_client *client, wl_resource *resource);
+    static void feedbackCallback(wl_client *client, wl_resource *resource, wl_resource *surface, uint32_t callback);
+    static void feedbackDestroyed(wl_resource *resource);
+    static const struct wp_presentation_interface s_interface;
+
+    void addFeedback(KWayland::Server::SurfaceInterface *surface, wl_resource *feedback);
+    void removeFeedback(wl_resource *feedback);
+    void surfaceCommitted(KWayland::Server::SurfaceInterface *surface);
+    void surfaceDestroyed(KWayland::Server::SurfaceInterface *surface);
+    void lockSurface(KWayland::Server::SurfaceInterface *surface, AbstractOutput *output);
+    static void discard(const QVector<wl_resource*> &feedbacks);
+
+    wl_global *m_global = nullptr;
+    // requested for the next commit of the surface
+    QHash<KWayland::Server::SurfaceInterface*, QVector<wl_resource*>> m_pending;
+    // committed, but not yet painted
+    QHash<KWayland::Server::SurfaceInterface*, QVector<wl_resource*>> m_committed;
+    // painted, waiting for the output to present the frame
+    QHash<AbstractOutput*, QVector<wl_resource*>> m_latched;
+    QSet<KWayland::Server::SurfaceInterface*> m_trackedSurfaces;
+    // the surface each feedback got requested for
+    QHash<wl_resource*, KWayland::Server::SurfaceInterface*> m_feedbackSurfaces;
+};
+
+}
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(KWin::PresentationTime::Kinds)
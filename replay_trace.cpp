@@ -0,0 +1,332 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "replay_trace.h"
+#include "client.h"
+#include "input.h"
+#include "input_event.h"
+#include "shell_client.h"
+#include "utils.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+namespace KWin
+{
+
+static const quint32 s_magic = 0x4b575254; // KWRT
+static const quint16 s_version = 1;
+
+bool ReplayEvent::operator==(const ReplayEvent &other) const
+{
+    return type == other.type && time == other.time && window == other.window && code == other.code &&
+           position == other.position && geometry == other.geometry && damage == other.damage;
+}
+
+static void setupStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    // positions and deltas don't need more
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+}
+
+ReplayTraceWriter::ReplayTraceWriter(QIODevice *device)
+    : m_stream(device)
+{
+    setupStream(m_stream);
+    m_stream << s_magic << s_version;
+}
+
+void ReplayTraceWriter::write(const ReplayEvent &event)
+{
+    m_stream << quint8(event.type) << event.time;
+    switch (event.type) {
+    case ReplayEvent::Type::PointerMotion:
+        m_stream << event.position.x() << event.position.y();
+        break;
+    case ReplayEvent::Type::PointerButtonPressed:
+    case ReplayEvent::Type::PointerButtonReleased:
+    case ReplayEvent::Type::KeyPressed:
+    case ReplayEvent::Type::KeyReleased:
+    case ReplayEvent::Type::TouchUp:
+        m_stream << event.code;
+        break;
+    case ReplayEvent::Type::PointerAxis:
+        m_stream << quint8(event.code) << event.position.x();
+        break;
+    case ReplayEvent::Type::TouchDown:
+    case ReplayEvent::Type::TouchMotion:
+        m_stream << event.code << event.position.x() << event.position.y();
+        break;
+    case ReplayEvent::Type::WindowMapped:
+        m_stream << event.window
+                 << qint32(event.geometry.x()) << qint32(event.geometry.y())
+                 << quint16(event.geometry.width()) << quint16(event.geometry.height());
+        break;
+    case ReplayEvent::Type::WindowUnmapped:
+        m_stream << event.window;
+        break;
+    case ReplayEvent::Type::Commit:
+        m_stream << event.window
+                 << quint16(event.geometry.width()) << quint16(event.geometry.height())
+                 << quint16(event.damage.width()) << quint16(event.damage.height());
+        break;
+    }
+}
+
+ReplayTraceReader::ReplayTraceReader(QIODevice *device)
+    : m_stream(device)
+{
+    setupStream(m_stream);
+    quint32 magic = 0;
+    quint16 version = 0;
+    m_stream >> magic >> version;
+    m_valid = m_stream.status() == QDataStream::Ok && magic == s_magic && version == s_version;
+}
+
+bool ReplayTraceReader::read(ReplayEvent *event)
+{
+    if (!m_valid || m_stream.atEnd()) {
+        return false;
+    }
+    quint8 type;
+    m_stream >> type >> event->time;
+    if (type > quint8(ReplayEvent::Type::Commit)) {
+        m_valid = false;
+        return false;
+    }
+    event->type = ReplayEvent::Type(type);
+    event->window = 0;
+    event->code = 0;
+    event->position = QPointF();
+    event->geometry = QRect();
+    event->damage = QSize();
+    double x = 0;
+    double y = 0;
+    switch (event->type) {
+    case ReplayEvent::Type::PointerMotion:
+        m_stream >> x >> y;
+        event->position = QPointF(x, y);
+        break;
+    case ReplayEvent::Type::PointerButtonPressed:
+    case ReplayEvent::Type::PointerButtonReleased:
+    case ReplayEvent::Type::KeyPressed:
+    case ReplayEvent::Type::KeyReleased:
+    case ReplayEvent::Type::TouchUp:
+        m_stream >> event->code;
+        break;
+    case ReplayEvent::Type::PointerAxis: {
+        quint8 orientation;
+        m_stream >> orientation >> x;
+        event->code = orientation;
+        event->position = QPointF(x, 0);
+        break;
+    }
+    case ReplayEvent::Type::TouchDown:
+    case ReplayEvent::Type::TouchMotion:
+        m_stream >> event->code >> x >> y;
+        event->position = QPointF(x, y);
+        break;
+    case ReplayEvent::Type::WindowMapped: {
+        qint32 left, top;
+        quint16 width, height;
+        m_stream >> event->window >> left >> top >> width >> height;
+        event->geometry = QRect(left, top, width, height);
+        break;
+    }
+    case ReplayEvent::Type::WindowUnmapped:
+        m_stream >> event->window;
+        break;
+    case ReplayEvent::Type::Commit: {
+        quint16 width, height, damageWidth, damageHeight;
+        m_stream >> event->window >> width >> height >> damageWidth >> damageHeight;
+        event->geometry = QRect(0, 0, width, height);
+        event->damage = QSize(damageWidth, damageHeight);
+        break;
+    }
+    }
+    if (m_stream.status() != QDataStream::Ok) {
+        m_valid = false;
+        return false;
+    }
+    return true;
+}
+
+ReplayRecorder::ReplayRecorder(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_file(fileName)
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KWIN_CORE) << "Failed to open replay trace" << fileName << m_file.errorString();
+        return;
+    }
+    m_writer.reset(new ReplayTraceWriter(&m_file));
+    m_timer.start();
+
+    input()->installInputEventSpy(this);
+    if (waylandServer()) {
+        connect(waylandServer(), &WaylandServer::shellClientAdded, this, &ReplayRecorder::windowMapped);
+        const auto clients = waylandServer()->clients();
+        for (ShellClient *c : clients) {
+            windowMapped(c);
+        }
+    }
+    if (Workspace *ws = workspace()) {
+        connect(ws, &Workspace::clientAdded, this, &ReplayRecorder::windowMapped);
+        const auto clients = ws->clientList();
+        for (Client *c : clients) {
+            windowMapped(c);
+        }
+    }
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+    m_writer.reset();
+    m_file.close();
+}
+
+void ReplayRecorder::record(ReplayEvent &event)
+{
+    event.time = m_timer.elapsed();
+    m_writer->write(event);
+}
+
+void ReplayRecorder::pointerEvent(MouseEvent *event)
+{
+    ReplayEvent e;
+    switch (event->type()) {
+    case QEvent::MouseMove:
+        e.type = ReplayEvent::Type::PointerMotion;
+        e.position = event->screenPos();
+        break;
+    case QEvent::MouseButtonPress:
+        e.type = ReplayEvent::Type::PointerButtonPressed;
+        e.code = event->nativeButton();
+        break;
+    case QEvent::MouseButtonRelease:
+        e.type = ReplayEvent::Type::PointerButtonReleased;
+        e.code = event->nativeButton();
+        break;
+    default:
+        return;
+    }
+    record(e);
+}
+
+void ReplayRecorder::wheelEvent(WheelEvent *event)
+{
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::PointerAxis;
+    e.code = event->orientation();
+    e.position = QPointF(event->delta(), 0);
+    record(e);
+}
+
+void ReplayRecorder::keyEvent(KeyEvent *event)
+{
+    if (event->isAutoRepeat()) {
+        // the replay generates the repeats itself
+        return;
+    }
+    ReplayEvent e;
+    e.type = event->type() == QEvent::KeyPress ? ReplayEvent::Type::KeyPressed : ReplayEvent::Type::KeyReleased;
+    e.code = event->nativeScanCode();
+    record(e);
+}
+
+void ReplayRecorder::touchDown(qint32 id, const QPointF &pos, quint32 time)
+{
+    Q_UNUSED(time)
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::TouchDown;
+    e.code = id;
+    e.position = pos;
+    record(e);
+}
+
+void ReplayRecorder::touchMotion(qint32 id, const QPointF &pos, quint32 time)
+{
+    Q_UNUSED(time)
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::TouchMotion;
+    e.code = id;
+    e.position = pos;
+    record(e);
+}
+
+void ReplayRecorder::touchUp(qint32 id, quint32 time)
+{
+    Q_UNUSED(time)
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::TouchUp;
+    e.code = id;
+    record(e);
+}
+
+void ReplayRecorder::windowMapped(Toplevel *toplevel)
+{
+    if (m_windows.contains(toplevel)) {
+        return;
+    }
+    if (ShellClient *c = qobject_cast<ShellClient*>(toplevel)) {
+        if (c->isInternal()) {
+            // KWin's own windows get created by the replayed KWin as well
+            return;
+        }
+    }
+    const quint32 id = m_nextWindow++;
+    m_windows.insert(toplevel, id);
+    connect(toplevel, &Toplevel::damaged, this, &ReplayRecorder::windowDamaged);
+    connect(toplevel, &Toplevel::windowClosed, this, &ReplayRecorder::windowUnmapped);
+
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::WindowMapped;
+    e.window = id;
+    e.geometry = toplevel->geometry();
+    record(e);
+}
+
+void ReplayRecorder::windowUnmapped(Toplevel *toplevel)
+{
+    const quint32 id = m_windows.take(toplevel);
+    if (id == 0) {
+        return;
+    }
+    disconnect(toplevel, nullptr, this, nullptr);
+
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::WindowUnmapped;
+    e.window = id;
+    record(e);
+}
+
+void ReplayRecorder::windowDamaged(Toplevel *toplevel, const QRect &damage)
+{
+    const quint32 id = m_windows.value(toplevel);
+    if (id == 0) {
+        return;
+    }
+    ReplayEvent e;
+    e.type = ReplayEvent::Type::Commit;
+    e.window = id;
+    e.geometry = QRect(QPoint(0, 0), toplevel->size());
+    e.damage = damage.size();
+    record(e);
+}
+
+}
@@ -0,0 +1,151 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#pragma once
+
+#include "input_event_spy.h"
+
+#include <kwinglobals.h>
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QPointF>
+#include <QRect>
+#include <QScopedPointer>
+
+namespace KWin
+{
+class Toplevel;
+
+/**
+ * One entry of a replay trace.
+ *
+ * Which of the members are meaningful depends on the type:
+ * @li pointer and touch events use @c code for the button, key or touch id and @c position
+ * @li axis events store the orientation in @c code and the delta in @c position.x()
+ * @li window events use @c window, mapped windows their @c geometry
+ * @li commits store the size of the window in @c geometry and the size of the damage in @c damage
+ */
+struct KWIN_EXPORT ReplayEvent
+{
+    enum class Type : quint8 {
+        PointerMotion,
+        PointerButtonPressed,
+        PointerButtonReleased,
+        PointerAxis,
+        KeyPressed,
+        KeyReleased,
+        TouchDown,
+        TouchMotion,
+        TouchUp,
+        WindowMapped,
+        WindowUnmapped,
+        Commit
+    };
+    Type type = Type::PointerMotion;
+    // milliseconds since the start of the recording
+    quint32 time = 0;
+    quint32 window = 0;
+    quint32 code = 0;
+    QPointF position;
+    QRect geometry;
+    QSize damage;
+
+    bool operator==(const ReplayEvent &other) const;
+};
+
+/**
+ * Writes ReplayEvents in the compact binary trace format to a device.
+ */
+class KWIN_EXPORT ReplayTraceWriter
+{
+public:
+    explicit ReplayTraceWriter(QIODevice *device);
+
+    void write(const ReplayEvent &event);
+
+private:
+    QDataStream m_stream;
+};
+
+/**
+ * Reads a trace written by ReplayTraceWriter.
+ */
+class KWIN_EXPORT ReplayTraceReader
+{
+public:
+    explicit ReplayTraceReader(QIODevice *device);
+
+    /**
+     * Whether the device starts with a trace header of a supported version.
+     */
+    bool isValid() const {
+        return m_valid;
+    }
+    /**
+     * Reads the next event into @p event, returns @c false at the end of the trace
+     * or if the trace is corrupt.
+     */
+    bool read(ReplayEvent *event);
+
+private:
+    QDataStream m_stream;
+    bool m_valid = false;
+};
+
+/**
+ * Records input events, window mapping and client commits into a replay trace.
+ *
+ * The trace can be replayed headless with the testReplay integration test to get
+ * reproducible load profiles of real sessions. KWin records a trace if the environment
+ * variable KWIN_REPLAY_RECORD points to the file to write.
+ */
+class KWIN_EXPORT ReplayRecorder : public QObject, public InputEventSpy
+{
+    Q_OBJECT
+public:
+    explicit ReplayRecorder(const QString &fileName, QObject *parent = nullptr);
+    ~ReplayRecorder() override;
+
+    bool isRecording() const {
+        return m_file.isOpen();
+    }
+
+    void pointerEvent(MouseEvent *event) override;
+    void wheelEvent(WheelEvent *event) override;
+    void keyEvent(KeyEvent *event) override;
+    void touchDown(qint32 id, const QPointF &pos, quint32 time) override;
+    void touchMotion(qint32 id, const QPointF &pos, quint32 time) override;
+    void touchUp(qint32 id, quint32 time) override;
+
+private:
+    void windowMapped(Toplevel *toplevel);
+    void windowUnmapped(Toplevel *toplevel);
+    void windowDamaged(Toplevel *toplevel, const QRect &damage);
+    void record(ReplayEvent &event);
+
+    QFile m_file;
+    QScopedPointer<ReplayTraceWriter> m_writer;
+    QElapsedTimer m_timer;
+    QHash<Toplevel*, quint32> m_windows;
+    quint32 m_nextWindow = 1;
+};
+
+}
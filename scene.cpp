@@ -140,6 +140,7 @@ void Scene::paintScreen(int* mask, const QRegion &damage, const QRegion &repaint
 
     painted_region = region;
     repaint_region = repaint;
+    m_outputGeometry = outputGeometry.isValid() ? outputGeometry : displayRegion.boundingRect();
 
     if (*mask & PAINT_SCREEN_BACKGROUND_FIRST) {
         paintBackground(region);
@@ -232,6 +233,8 @@ void Scene::paintGenericScreen(int orig_mask, ScreenPaintData)
         if (!w->isPaintingEnabled()) {
             continue;
         }
+        // the transformed windows cannot be tested for occlusion
+        w->setVisibleInFrame(true);
         phase2.append({w, infiniteRegion(), data.clip, data.mask, data.quads});
     }
 
@@ -343,6 +346,13 @@ void Scene::paintSimpleScreen(int orig_mask, QRegion region)
         // a higher opaque window
         data->region -= allclips;
 
+        // windows fully covered by the opaque windows above or outside of the output don't
+        // contribute to the frame, the output may still show them if painted before
+        if (!data->window->isVisibleInFrame()) {
+            const QRect visibleRect = data->window->window()->visibleRect() & m_outputGeometry;
+            data->window->setVisibleInFrame(!(QRegion(visibleRect) - allclips).isEmpty());
+        }
+
         // Here we rely on WindowPrePaintData::setTranslucent() to remove
         // the clip if needed.
         if (!data->clip.isEmpty() && !(data->mask & PAINT_WINDOW_TRANSLUCENT)) {
@@ -447,12 +457,28 @@ void Scene::windowGeometryShapeChanged(Toplevel *c)
     w->discardShape();
 }
 
+bool Scene::isVisibleInFrame(Toplevel *toplevel) const
+{
+    Window *w = m_windows.value(toplevel);
+    return w && w->isVisibleInFrame();
+}
+
 void Scene::createStackingOrder(ToplevelList toplevels)
 {
     // TODO: cache the stacking_order in case it has not changed
     foreach (Toplevel *c, toplevels) {
         Q_ASSERT(m_windows.contains(c));
-        stacking_order.append(m_windows[ c ]);
+        Window *w = m_windows[ c ];
+        // a new frame starts, the painting passes determine the visibility again
+        w->setVisibleInFrame(false);
+        stacking_order.append(w);
+    }
+}
+
+void Scene::discardPreviousWindowPixmaps()
+{
+    for (Window *window : qAsConst(m_windows)) {
+        window->discardPreviousPixmap();
     }
 }
 
@@ -562,6 +588,7 @@ void Scene::paintWindowThumbnails(Scene::Window *w, QRegion region, qreal opacit
         clippingRegion &= QRegion(wImpl->x(), wImpl->y(), wImpl->width(), wImpl->height());
         adjustClipRegion(item, clippingRegion);
         effects->drawWindow(thumb, thumbMask, clippingRegion, thumbData);
+        thumb->sceneWindow()->setVisibleInFrame(true);
     }
 }
 
@@ -695,6 +722,7 @@ Scene::Window::Window(Toplevel * c)
     , m_previousPixmap()
     , m_referencePixmapCounter(0)
     , disable_painting(0)
+    , m_visibleInFrame(false)
     , shape_valid(false)
     , cached_quad_list(nullptr)
 {
@@ -723,6 +751,15 @@ void Scene::Window::unreferencePreviousPixmap()
     }
 }
 
+void Scene::Window::discardPreviousPixmap()
+{
+    if (m_referencePixmapCounter > 0) {
+        // an effect is still cross-fading from it
+        return;
+    }
+    m_previousPixmap.reset();
+}
+
 void Scene::Window::pixmapDiscarded()
 {
     if (!m_currentPixmap.isNull()) {
@@ -782,6 +819,16 @@ QRegion Scene::Window::clientShape() const
     return r.isEmpty() ? QRegion() : r;
 }
 
+bool Scene::Window::isVisibleInFrame() const
+{
+    return m_visibleInFrame;
+}
+
+void Scene::Window::setVisibleInFrame(bool visible)
+{
+    m_visibleInFrame = visible;
+}
+
 bool Scene::Window::isVisible() const
 {
     if (toplevel->isDeleted())
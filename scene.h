@@ -183,6 +183,21 @@ public:
      */
     virtual QPainter *scenePainter() const;
 
+    /**
+     * The region painted so far in the current painting pass, in screen coordinates.
+     * Might be an infinite region if the screen is painted transformed.
+     */
+    QRegion paintedRegion() const {
+        return painted_region;
+    }
+
+    /**
+     * Whether @p toplevel contributed to the frame painted last, that is it was neither
+     * hidden nor fully covered by opaque windows on all outputs. Windows shown through a
+     * thumbnail count as visible as well.
+     */
+    bool isVisibleInFrame(Toplevel *toplevel) const;
+
     /**
      * The render buffer used by a QPainter based compositor.
      * Default implementation returns @c nullptr.
@@ -211,6 +226,8 @@ protected:
     virtual Window *createWindow(Toplevel *toplevel) = 0;
     void createStackingOrder(ToplevelList toplevels);
     void clearStackingOrder();
+    // drops the unreferenced previous pixmaps of all windows, used under memory pressure
+    void discardPreviousWindowPixmaps();
     // shared implementation, starts painting the screen
     void paintScreen(int *mask, const QRegion &damage, const QRegion &repaint,
                      QRegion *updateRegion, QRegion *validRegion, const QMatrix4x4 &projection = QMatrix4x4(), const QRect &outputGeometry = QRect());
@@ -256,6 +273,8 @@ protected:
     QRegion repaint_region;
     // The dirty region before it was unioned with repaint_region
     QRegion damaged_region;
+    // The part of the screen painted by the current paintScreen() call
+    QRect m_outputGeometry;
     // time since last repaint
     int time_diff;
     QElapsedTimer last_time;
@@ -326,6 +345,9 @@ public:
     void disablePainting(int reason);
     // is the window visible at all
     bool isVisible() const;
+    // did the window contribute to the current frame
+    bool isVisibleInFrame() const;
+    void setVisibleInFrame(bool visible);
     // is the window fully opaque
     bool isOpaque() const;
     // shape of the window
@@ -340,6 +362,10 @@ public:
     Shadow* shadow();
     void referencePreviousPixmap();
     void unreferencePreviousPixmap();
+    /**
+     * Drops the previous pixmap unless an effect still references it.
+     */
+    void discardPreviousPixmap();
     void invalidateQuadsCache();
 protected:
     WindowQuadList makeQuads(WindowQuadType type, const QRegion& reg, const QPoint &textureOffset = QPoint(0, 0), qreal textureScale = 1.0) const;
@@ -376,6 +402,7 @@ private:
     QScopedPointer<WindowPixmap> m_previousPixmap;
     int m_referencePixmapCounter;
     int disable_painting;
+    bool m_visibleInFrame;
     mutable QRegion shape_region;
     mutable bool shape_valid;
     mutable QScopedPointer<WindowQuadList> cached_quad_list;
@@ -439,7 +466,7 @@ public:
      *
      * @see isDiscarded
      */
-    void markAsDiscarded();
+    virtual void markAsDiscarded();
     /**
      * The size of the pixmap.
      */
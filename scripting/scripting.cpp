@@ -41,6 +41,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDBusPendingCallWatcher>
 #include <QDebug>
 #include <QFutureWatcher>
+#include <QJSEngine>
 #include <QSettings>
 #include <QtConcurrentRun>
 #include <QMenu>
@@ -51,6 +52,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QtScript/QScriptValue>
 #include <QStandardPaths>
 #include <QQuickWindow>
+#include <QTimer>
 
 QScriptValue kwinScriptPrint(QScriptContext *context, QScriptEngine *engine)
 {
@@ -631,6 +633,249 @@ void KWin::DeclarativeScript::createComponent()
     setRunning(true);
 }
 
+// defines the global functions of a JSEngineScript on top of JSEngineScriptMethods
+static const char s_jsEngineScriptPrelude[] = R"JS(
+(function(global, methods) {
+    global.print = function() {
+        methods.print(Array.prototype.slice.call(arguments).join(" "));
+    };
+    global.readConfig = function(key, defaultValue) {
+        return methods.readConfig(key, defaultValue);
+    };
+    global.registerShortcut = function(name, text, keys, callback) {
+        return methods.registerShortcut(name, text, keys, callback);
+    };
+    global.registerScreenEdge = function(edge, callback) {
+        return methods.registerScreenEdge(edge, callback);
+    };
+    global.unregisterScreenEdge = function(edge) {
+        return methods.unregisterScreenEdge(edge);
+    };
+    global.callDBus = function(service, path, iface, method) {
+        var args = Array.prototype.slice.call(arguments, 4);
+        var callback = null;
+        if (args.length > 0 && typeof args[args.length - 1] === "function") {
+            callback = args.pop();
+        }
+        methods.callDBus(service, path, iface, method, args, callback);
+    };
+    global.QTimer = function() {
+        return methods.createTimer();
+    };
+    function fail(message, fallback) {
+        throw new Error(message === undefined ? fallback : message);
+    }
+    global.assertTrue = function(value, message) {
+        if (value !== true) {
+            fail(message, "Assertion failed");
+        }
+    };
+    global.assert = global.assertTrue;
+    global.assertFalse = function(value, message) {
+        if (value !== false) {
+            fail(message, "Assertion failed");
+        }
+    };
+    global.assertEquals = function(expected, actual, message) {
+        if (expected !== actual) {
+            fail(message, "Expected: " + expected + " Actual: " + actual);
+        }
+    };
+    global.assertNull = function(value, message) {
+        if (value !== null) {
+            fail(message, "Assertion failed");
+        }
+    };
+    global.assertNotNull = function(value, message) {
+        if (value === null) {
+            fail(message, "Assertion failed");
+        }
+    };
+})
+)JS";
+
+KWin::JSEngineScript::JSEngineScript(int id, QString scriptName, QString pluginName, QObject *parent)
+    : AbstractScript(id, scriptName, pluginName, parent)
+    , m_engine(new QJSEngine(this))
+{
+    QDBusConnection::sessionBus().registerObject(QLatin1Char('/') + QString::number(scriptId()), this, QDBusConnection::ExportScriptableContents | QDBusConnection::ExportScriptableInvokables);
+}
+
+KWin::JSEngineScript::~JSEngineScript()
+{
+    QDBusConnection::sessionBus().unregisterObject(QLatin1Char('/') + QString::number(scriptId()));
+}
+
+void KWin::JSEngineScript::run()
+{
+    if (running()) {
+        return;
+    }
+    QFile file(fileName());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCDebug(KWIN_SCRIPTING) << "Could not open" << fileName();
+        deleteLater();
+        return;
+    }
+    installGlobals();
+    const QJSValue ret = m_engine->evaluate(QString::fromUtf8(file.readAll()), fileName());
+    if (ret.isError()) {
+        reportError(ret);
+        deleteLater();
+        return;
+    }
+    setRunning(true);
+}
+
+void KWin::JSEngineScript::installGlobals()
+{
+    QJSValue global = m_engine->globalObject();
+    // the wrappers are owned by Scripting, the engine must never delete them
+    QQmlEngine::setObjectOwnership(options, QQmlEngine::CppOwnership);
+    global.setProperty(QStringLiteral("options"), m_engine->newQObject(options));
+    JSEngineWorkspaceWrapper *workspace = Scripting::self()->jsEngineWorkspaceWrapper();
+    QQmlEngine::setObjectOwnership(workspace, QQmlEngine::CppOwnership);
+    global.setProperty(QStringLiteral("workspace"), m_engine->newQObject(workspace));
+    global.setProperty(QStringLiteral("KWin"), m_engine->newQMetaObject(&WorkspaceWrapper::staticMetaObject));
+
+    JSEngineScriptMethods *methods = new JSEngineScriptMethods(this);
+    QQmlEngine::setObjectOwnership(methods, QQmlEngine::CppOwnership);
+    QJSValue prelude = m_engine->evaluate(QString::fromLatin1(s_jsEngineScriptPrelude));
+    prelude.call(QJSValueList{global, m_engine->newQObject(methods)});
+}
+
+void KWin::JSEngineScript::call(QJSValue callback, const QJSValueList &arguments)
+{
+    const QJSValue ret = callback.call(arguments);
+    if (ret.isError()) {
+        reportError(ret);
+    }
+}
+
+void KWin::JSEngineScript::reportError(const QJSValue &error)
+{
+    const QString message = QStringLiteral("%1:%2: %3").arg(fileName())
+                                                        .arg(error.property(QStringLiteral("lineNumber")).toInt())
+                                                        .arg(error.toString());
+    qCDebug(KWIN_SCRIPTING) << message;
+    emit printError(message);
+}
+
+KWin::JSEngineScriptMethods::JSEngineScriptMethods(KWin::JSEngineScript *parent)
+    : QObject(parent)
+    , m_script(parent)
+{
+}
+
+KWin::JSEngineScriptMethods::~JSEngineScriptMethods()
+{
+}
+
+void KWin::JSEngineScriptMethods::print(const QString &text)
+{
+    m_script->printMessage(text);
+}
+
+QVariant KWin::JSEngineScriptMethods::readConfig(const QString &key, const QVariant &defaultValue)
+{
+    return m_script->config().readEntry(key, defaultValue);
+}
+
+bool KWin::JSEngineScriptMethods::registerShortcut(const QString &name, const QString &text, const QString &keys, const QJSValue &callback)
+{
+    if (!callback.isCallable()) {
+        qCDebug(KWIN_SCRIPTING) << "Fourth and final argument must be a javascript function";
+        return false;
+    }
+
+    QAction *a = new QAction(this);
+    a->setObjectName(name);
+    a->setText(text);
+    const QKeySequence shortcut = QKeySequence(keys);
+    KGlobalAccel::self()->setShortcut(a, QList<QKeySequence>{shortcut});
+    KWin::input()->registerShortcut(shortcut, a);
+
+    connect(a, &QAction::triggered, this, [this, a, callback] {
+        m_script->call(callback, QJSValueList{m_script->engine()->newQObject(a)});
+    });
+    return true;
+}
+
+bool KWin::JSEngineScriptMethods::registerScreenEdge(int edge, const QJSValue &callback)
+{
+    if (!callback.isCallable()) {
+        qCDebug(KWIN_SCRIPTING) << "Second argument to registerScreenEdge needs to be a callback";
+        return false;
+    }
+    auto it = m_screenEdgeCallbacks.find(edge);
+    if (it == m_screenEdgeCallbacks.end()) {
+        // not yet registered
+        ScreenEdges::self()->reserve(static_cast<KWin::ElectricBorder>(edge), this, "borderActivated");
+        m_screenEdgeCallbacks.insert(edge, QList<QJSValue>{callback});
+    } else {
+        it->append(callback);
+    }
+    return true;
+}
+
+bool KWin::JSEngineScriptMethods::unregisterScreenEdge(int edge)
+{
+    auto it = m_screenEdgeCallbacks.find(edge);
+    if (it == m_screenEdgeCallbacks.end()) {
+        //not previously registered
+        return false;
+    }
+    ScreenEdges::self()->unreserve(static_cast<KWin::ElectricBorder>(edge), this);
+    m_screenEdgeCallbacks.erase(it);
+    return true;
+}
+
+bool KWin::JSEngineScriptMethods::borderActivated(KWin::ElectricBorder edge)
+{
+    const QList<QJSValue> callbacks = m_screenEdgeCallbacks.value(edge);
+    if (callbacks.isEmpty()) {
+        return false;
+    }
+    for (const QJSValue &callback : callbacks) {
+        m_script->call(callback);
+    }
+    return true;
+}
+
+void KWin::JSEngineScriptMethods::callDBus(const QString &service, const QString &path, const QString &interface,
+                                           const QString &method, const QVariantList &arguments, const QJSValue &callback)
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall(service, path, interface, method);
+    if (!arguments.isEmpty()) {
+        msg.setArguments(arguments);
+    }
+    if (!callback.isCallable()) {
+        // no callback, just fire and forget
+        QDBusConnection::sessionBus().asyncCall(msg);
+        return;
+    }
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(msg), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, callback] (QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        if (watcher->isError()) {
+            qCDebug(KWIN_SCRIPTING) << "Received D-Bus message is error";
+            return;
+        }
+        QJSValueList arguments;
+        const auto replyArguments = watcher->reply().arguments();
+        for (const QVariant &argument : replyArguments) {
+            arguments << m_script->engine()->toScriptValue(argument);
+        }
+        m_script->call(callback, arguments);
+    });
+}
+
+QObject *KWin::JSEngineScriptMethods::createTimer()
+{
+    // parented to the script, so all timers go away when the script gets unloaded
+    return new QTimer(m_script);
+}
+
 KWin::JSEngineGlobalMethodsWrapper::JSEngineGlobalMethodsWrapper(KWin::DeclarativeScript *parent)
     : QObject(parent)
     , m_script(parent)
@@ -736,10 +981,16 @@ void KWin::Scripting::start()
     for (LoadScriptList::const_iterator it = scriptsToLoad.constBegin();
             it != scriptsToLoad.constEnd();
             ++it) {
-        if (it->first) {
+        switch (it->first) {
+        case ScriptType::QtScript:
             loadScript(it->second.first, it->second.second);
-        } else {
+            break;
+        case ScriptType::JSEngine:
+            loadJSEngineScript(it->second.first, it->second.second);
+            break;
+        case ScriptType::Declarative:
             loadDeclarativeScript(it->second.first, it->second.second);
+            break;
         }
     }
 
@@ -785,7 +1036,12 @@ LoadScriptList KWin::Scripting::queryScriptsToLoad()
             qCDebug(KWIN_SCRIPTING) << "Could not find script file for " << pluginName;
             continue;
         }
-        scriptsToLoad << qMakePair(javaScript, qMakePair(file, pluginName));
+        ScriptType type = ScriptType::Declarative;
+        if (javaScript) {
+            const bool jsEngine = service.value(QStringLiteral("X-KWin-Script-Engine")) == QLatin1String("jsengine");
+            type = jsEngine ? ScriptType::JSEngine : ScriptType::QtScript;
+        }
+        scriptsToLoad << qMakePair(type, qMakePair(file, pluginName));
     }
     return scriptsToLoad;
 }
@@ -802,10 +1058,16 @@ void KWin::Scripting::slotScriptsQueried()
     for (LoadScriptList::const_iterator it = scriptsToLoad.constBegin();
             it != scriptsToLoad.constEnd();
             ++it) {
-        if (it->first) {
+        switch (it->first) {
+        case ScriptType::QtScript:
             loadScript(it->second.first, it->second.second);
-        } else {
+            break;
+        case ScriptType::JSEngine:
+            loadJSEngineScript(it->second.first, it->second.second);
+            break;
+        case ScriptType::Declarative:
             loadDeclarativeScript(it->second.first, it->second.second);
+            break;
         }
     }
 
@@ -881,6 +1143,27 @@ int KWin::Scripting::loadDeclarativeScript(const QString& filePath, const QStrin
     return id;
 }
 
+int KWin::Scripting::loadJSEngineScript(const QString& filePath, const QString& pluginName)
+{
+    QMutexLocker locker(m_scriptsLock.data());
+    if (isScriptLoaded(pluginName)) {
+        return -1;
+    }
+    const int id = scripts.size();
+    KWin::JSEngineScript *script = new KWin::JSEngineScript(id, filePath, pluginName, this);
+    connect(script, SIGNAL(destroyed(QObject*)), SLOT(scriptDestroyed(QObject*)));
+    scripts.append(script);
+    return id;
+}
+
+KWin::JSEngineWorkspaceWrapper *KWin::Scripting::jsEngineWorkspaceWrapper()
+{
+    if (!m_jsEngineWorkspaceWrapper) {
+        m_jsEngineWorkspaceWrapper = new JSEngineWorkspaceWrapper(this);
+    }
+    return m_jsEngineWorkspaceWrapper;
+}
+
 KWin::Scripting::~Scripting()
 {
     QDBusConnection::sessionBus().unregisterObject(QStringLiteral("/Scripting"));
@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDBusContext>
 #include <QDBusMessage>
 
+class QJSEngine;
 class QQmlComponent;
 class QQmlContext;
 class QQmlEngine;
@@ -46,8 +47,22 @@ class QScriptValue;
 class QQuickWindow;
 class KConfigGroup;
 
-/// @c true == javascript, @c false == qml
-typedef QList< QPair<bool, QPair<QString, QString > > > LoadScriptList;
+namespace KWin
+{
+/**
+ * The runtime a script is loaded into.
+ */
+enum class ScriptType {
+    /// X-Plasma-API javascript, run by a QScriptEngine
+    QtScript,
+    /// X-Plasma-API javascript with X-KWin-Script-Engine jsengine, run by a QJSEngine
+    JSEngine,
+    /// X-Plasma-API declarativescript
+    Declarative
+};
+}
+
+typedef QList< QPair<KWin::ScriptType, QPair<QString, QString > > > LoadScriptList;
 
 namespace KWin
 {
@@ -55,6 +70,7 @@ class AbstractClient;
 class Client;
 class ScriptUnloaderAgent;
 class QtScriptWorkspaceWrapper;
+class JSEngineWorkspaceWrapper;
 
 class KWIN_EXPORT AbstractScript : public QObject
 {
@@ -292,6 +308,68 @@ private:
     QQmlComponent *m_component;
 };
 
+/**
+ * A plain JavaScript script run by its own QJSEngine.
+ *
+ * Offers the same global API as Script, except for the user actions menu, but uses
+ * the JSEngineWorkspaceWrapper which allows to get workspace changes in batches.
+ */
+class JSEngineScript : public AbstractScript
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.kwin.Scripting")
+public:
+    JSEngineScript(int id, QString scriptName, QString pluginName, QObject *parent = nullptr);
+    ~JSEngineScript() override;
+
+    QJSEngine *engine() {
+        return m_engine;
+    }
+    /**
+     * Calls @p callback with @p arguments and reports an exception thrown by it.
+     */
+    void call(QJSValue callback, const QJSValueList &arguments = QJSValueList());
+
+public Q_SLOTS:
+    Q_SCRIPTABLE void run() override;
+
+Q_SIGNALS:
+    Q_SCRIPTABLE void printError(const QString &text);
+
+private:
+    void installGlobals();
+    void reportError(const QJSValue &error);
+
+    QJSEngine *m_engine;
+};
+
+/**
+ * The native functions behind the globals of a JSEngineScript.
+ */
+class JSEngineScriptMethods : public QObject
+{
+    Q_OBJECT
+public:
+    explicit JSEngineScriptMethods(JSEngineScript *parent);
+    ~JSEngineScriptMethods() override;
+
+    Q_INVOKABLE void print(const QString &text);
+    Q_INVOKABLE QVariant readConfig(const QString &key, const QVariant &defaultValue = QVariant());
+    Q_INVOKABLE bool registerShortcut(const QString &name, const QString &text, const QString &keys, const QJSValue &callback);
+    Q_INVOKABLE bool registerScreenEdge(int edge, const QJSValue &callback);
+    Q_INVOKABLE bool unregisterScreenEdge(int edge);
+    Q_INVOKABLE void callDBus(const QString &service, const QString &path, const QString &interface,
+                              const QString &method, const QVariantList &arguments, const QJSValue &callback);
+    Q_INVOKABLE QObject *createTimer();
+
+public Q_SLOTS:
+    bool borderActivated(ElectricBorder edge);
+
+private:
+    JSEngineScript *m_script;
+    QHash<int, QList<QJSValue>> m_screenEdgeCallbacks;
+};
+
 class JSEngineGlobalMethodsWrapper : public QObject
 {
     Q_OBJECT
@@ -353,6 +431,7 @@ public:
     ~Scripting() override;
     Q_SCRIPTABLE Q_INVOKABLE int loadScript(const QString &filePath, const QString &pluginName = QString());
     Q_SCRIPTABLE Q_INVOKABLE int loadDeclarativeScript(const QString &filePath, const QString &pluginName = QString());
+    Q_SCRIPTABLE Q_INVOKABLE int loadJSEngineScript(const QString &filePath, const QString &pluginName = QString());
     Q_SCRIPTABLE Q_INVOKABLE bool isScriptLoaded(const QString &pluginName) const;
     Q_SCRIPTABLE Q_INVOKABLE bool unloadScript(const QString &pluginName);
 
@@ -370,6 +449,10 @@ public:
     QQmlContext *declarativeScriptSharedContext() const;
     QQmlContext *declarativeScriptSharedContext();
     QtScriptWorkspaceWrapper *workspaceWrapper() const;
+    /**
+     * The workspace shared by all JSEngineScripts, created on first use.
+     */
+    JSEngineWorkspaceWrapper *jsEngineWorkspaceWrapper();
 
     AbstractScript *findScript(const QString &pluginName) const;
 
@@ -390,6 +473,7 @@ private:
     QQmlEngine *m_qmlEngine;
     QQmlContext *m_declarativeScriptSharedContext;
     QtScriptWorkspaceWrapper *m_workspaceWrapper;
+    JSEngineWorkspaceWrapper *m_jsEngineWorkspaceWrapper = nullptr;
 };
 
 inline
@@ -33,6 +33,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QDesktopWidget>
 #include <QApplication>
+#include <QMetaMethod>
+#include <QQmlEngine>
 
 namespace KWin {
 
@@ -375,4 +377,155 @@ KWin::AbstractClient *DeclarativeScriptWorkspaceWrapper::atClientList(QQmlListPr
 DeclarativeScriptWorkspaceWrapper::DeclarativeScriptWorkspaceWrapper(QObject* parent)
     : WorkspaceWrapper(parent) {}
 
+JSEngineWorkspaceWrapper::JSEngineWorkspaceWrapper(QObject* parent)
+    : WorkspaceWrapper(parent)
+{
+}
+
+static QVariant clientToVariant(AbstractClient *client)
+{
+    // the engine must not take ownership of clients returned from invokables
+    QQmlEngine::setObjectOwnership(client, QQmlEngine::CppOwnership);
+    return QVariant::fromValue(client);
+}
+
+template <typename T>
+static QVariantList clientsToVariantList(const T &clients)
+{
+    QVariantList ret;
+    ret.reserve(clients.size());
+    for (AbstractClient *client : clients) {
+        ret << clientToVariant(client);
+    }
+    return ret;
+}
+
+QVariantList JSEngineWorkspaceWrapper::clientList() const
+{
+    return clientsToVariantList(workspace()->allClientList());
+}
+
+void JSEngineWorkspaceWrapper::connectNotify(const QMetaMethod &signal)
+{
+    WorkspaceWrapper::connectNotify(signal);
+    if (signal == QMetaMethod::fromSignal(&JSEngineWorkspaceWrapper::changesBatched)) {
+        startBatching();
+    }
+}
+
+void JSEngineWorkspaceWrapper::startBatching()
+{
+    if (m_batching) {
+        return;
+    }
+    m_batching = true;
+    // only track the per client changes once a script is interested in them
+    const auto clients = workspace()->allClientList();
+    for (AbstractClient *client : clients) {
+        trackClient(client);
+    }
+    connect(this, &WorkspaceWrapper::clientAdded, this,
+        [this] (AbstractClient *client) {
+            trackClient(client);
+            addChange(m_added, client);
+        }
+    );
+    connect(this, &WorkspaceWrapper::clientRemoved, this, &JSEngineWorkspaceWrapper::clientRemovedFromBatch);
+    connect(this, &WorkspaceWrapper::desktopPresenceChanged, this,
+        [this] (AbstractClient *client) {
+            addChange(m_desktopChanged, client);
+        }
+    );
+    connect(this, &WorkspaceWrapper::clientMinimized, this,
+        [this] (AbstractClient *client) {
+            addChange(m_minimizedChanged, client);
+        }
+    );
+    connect(this, &WorkspaceWrapper::clientUnminimized, this,
+        [this] (AbstractClient *client) {
+            addChange(m_minimizedChanged, client);
+        }
+    );
+    connect(this, &WorkspaceWrapper::clientActivated, this,
+        [this] {
+            m_activeClientChanged = true;
+            scheduleChanges();
+        }
+    );
+    connect(this, &WorkspaceWrapper::currentDesktopChanged, this,
+        [this] {
+            m_currentDesktopChanged = true;
+            scheduleChanges();
+        }
+    );
+    auto screensChanged = [this] {
+        m_screensChanged = true;
+        scheduleChanges();
+    };
+    connect(this, &WorkspaceWrapper::numberScreensChanged, this, screensChanged);
+    connect(this, &WorkspaceWrapper::virtualScreenGeometryChanged, this, screensChanged);
+}
+
+void JSEngineWorkspaceWrapper::trackClient(AbstractClient *client)
+{
+    connect(client, &Toplevel::geometryChanged, this,
+        [this, client] {
+            addChange(m_geometryChanged, client);
+        }
+    );
+}
+
+void JSEngineWorkspaceWrapper::addChange(QVector<AbstractClient*> &changes, AbstractClient *client)
+{
+    if (!changes.contains(client)) {
+        changes << client;
+    }
+    scheduleChanges();
+}
+
+void JSEngineWorkspaceWrapper::clientRemovedFromBatch(AbstractClient *client)
+{
+    disconnect(client, &Toplevel::geometryChanged, this, nullptr);
+    m_geometryChanged.removeOne(client);
+    m_desktopChanged.removeOne(client);
+    m_minimizedChanged.removeOne(client);
+    // a client which came and went within one batch is not worth a notification
+    if (!m_added.removeOne(client)) {
+        m_removed << client->internalId().toString();
+    }
+    scheduleChanges();
+}
+
+void JSEngineWorkspaceWrapper::scheduleChanges()
+{
+    if (m_changesScheduled) {
+        return;
+    }
+    m_changesScheduled = true;
+    QMetaObject::invokeMethod(this, &JSEngineWorkspaceWrapper::emitChanges, Qt::QueuedConnection);
+}
+
+void JSEngineWorkspaceWrapper::emitChanges()
+{
+    m_changesScheduled = false;
+    QVariantMap changes;
+    changes.insert(QStringLiteral("added"), clientsToVariantList(m_added));
+    changes.insert(QStringLiteral("geometryChanged"), clientsToVariantList(m_geometryChanged));
+    changes.insert(QStringLiteral("desktopChanged"), clientsToVariantList(m_desktopChanged));
+    changes.insert(QStringLiteral("minimizedChanged"), clientsToVariantList(m_minimizedChanged));
+    changes.insert(QStringLiteral("removed"), m_removed);
+    changes.insert(QStringLiteral("activeClientChanged"), m_activeClientChanged);
+    changes.insert(QStringLiteral("currentDesktopChanged"), m_currentDesktopChanged);
+    changes.insert(QStringLiteral("screensChanged"), m_screensChanged);
+    m_added.clear();
+    m_geometryChanged.clear();
+    m_desktopChanged.clear();
+    m_minimizedChanged.clear();
+    m_removed.clear();
+    m_activeClientChanged = false;
+    m_currentDesktopChanged = false;
+    m_screensChanged = false;
+    emit changesBatched(changes);
+}
+
 } // KWin
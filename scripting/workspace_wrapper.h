@@ -27,6 +27,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QStringList>
 #include <QRect>
 #include <QQmlListProperty>
+#include <QVariant>
+#include <QVector>
 #include <kwinglobals.h>
 
 namespace KWin
@@ -375,6 +377,58 @@ public:
     explicit DeclarativeScriptWorkspaceWrapper(QObject* parent = nullptr);
 };
 
+/**
+ * The workspace of scripts run by a QJSEngine.
+ *
+ * In addition to the fine grained signals of the WorkspaceWrapper it provides changesBatched,
+ * which collects all changes of one event loop iteration. Scripts reacting on mass changes, e.g.
+ * tiling scripts, only need to relayout once instead of once per moved window.
+ */
+class JSEngineWorkspaceWrapper : public WorkspaceWrapper
+{
+    Q_OBJECT
+public:
+    /**
+     * List of Clients currently managed by KWin.
+     */
+    Q_INVOKABLE QVariantList clientList() const;
+
+    explicit JSEngineWorkspaceWrapper(QObject* parent = nullptr);
+
+Q_SIGNALS:
+    /**
+     * Emitted once after an event loop iteration in which the workspace changed.
+     *
+     * @p changes contains the lists of clients @c added, @c geometryChanged, @c desktopChanged and
+     * @c minimizedChanged, the internal ids of the @c removed clients and the booleans
+     * @c activeClientChanged, @c currentDesktopChanged and @c screensChanged. Each client is
+     * listed at most once per list, removed clients don't show up in any other list.
+     */
+    void changesBatched(const QVariantMap &changes);
+
+protected:
+    void connectNotify(const QMetaMethod &signal) override;
+
+private:
+    void startBatching();
+    void trackClient(KWin::AbstractClient *client);
+    void addChange(QVector<KWin::AbstractClient*> &changes, KWin::AbstractClient *client);
+    void clientRemovedFromBatch(KWin::AbstractClient *client);
+    void scheduleChanges();
+    void emitChanges();
+
+    bool m_batching = false;
+    bool m_changesScheduled = false;
+    QVector<KWin::AbstractClient*> m_added;
+    QVector<KWin::AbstractClient*> m_geometryChanged;
+    QVector<KWin::AbstractClient*> m_desktopChanged;
+    QVector<KWin::AbstractClient*> m_minimizedChanged;
+    QStringList m_removed;
+    bool m_activeClientChanged = false;
+    bool m_currentDesktopChanged = false;
+    bool m_screensChanged = false;
+};
+
 }
 
 #endif
@@ -36,6 +36,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 namespace KWin
 {
 
+/**
+ * The pixmaps of a _KDE_NET_WM_SHADOW property, shared by all windows referencing
+ * the same pixmap ids. Plasma uses the same pixmaps for all its menus and tooltips,
+ * so a new window usually doesn't need to fetch them from the X server again.
+ */
+class X11ShadowPixmaps
+{
+public:
+    QVector<uint32_t> ids;
+    QVector<QPixmap> elements;
+};
+
+// the windows using a set of pixmaps keep the entry alive
+static QHash<QVector<uint32_t>, QWeakPointer<X11ShadowPixmaps>> s_x11ShadowPixmaps;
+
 Shadow::Shadow(Toplevel *toplevel)
     : m_topLevel(toplevel)
     , m_cachedSize(toplevel->geometry().size())
@@ -138,6 +153,32 @@ QVector< uint32_t > Shadow::readX11ShadowProperty(xcb_window_t id)
 }
 
 bool Shadow::init(const QVector< uint32_t > &data)
+{
+    const QVector<uint32_t> ids = data.mid(0, ShadowElementsCount);
+    QSharedPointer<X11ShadowPixmaps> pixmaps = s_x11ShadowPixmaps.value(ids).toStrongRef();
+    if (!pixmaps) {
+        pixmaps = fetchX11ShadowPixmaps(ids);
+        if (!pixmaps) {
+            return false;
+        }
+    }
+    m_x11ShadowPixmaps = pixmaps;
+    for (int i = 0; i < ShadowElementsCount; ++i) {
+        m_shadowElements[i] = pixmaps->elements[i];
+    }
+    m_topOffset = data[ShadowElementsCount];
+    m_rightOffset = data[ShadowElementsCount+1];
+    m_bottomOffset = data[ShadowElementsCount+2];
+    m_leftOffset = data[ShadowElementsCount+3];
+    updateShadowRegion();
+    if (!prepareBackend()) {
+        return false;
+    }
+    buildQuads();
+    return true;
+}
+
+QSharedPointer<X11ShadowPixmaps> Shadow::fetchX11ShadowPixmaps(const QVector<uint32_t> &data)
 {
     QVector<Xcb::WindowGeometry> pixmapGeometries(ShadowElementsCount);
     QVector<xcb_get_image_cookie_t> getImageCookies(ShadowElementsCount);
@@ -154,32 +195,34 @@ bool Shadow::init(const QVector< uint32_t > &data)
         auto &geo = pixmapGeometries[i];
         if (geo.isNull()) {
             discardReplies(0);
-            return false;
+            return nullptr;
         }
         getImageCookies[i] = xcb_get_image_unchecked(c, XCB_IMAGE_FORMAT_Z_PIXMAP, data[i],
                                                      0, 0, geo->width, geo->height, ~0);
     }
+    QSharedPointer<X11ShadowPixmaps> pixmaps = QSharedPointer<X11ShadowPixmaps>::create();
+    pixmaps->ids = data;
+    pixmaps->elements.resize(ShadowElementsCount);
     for (int i = 0; i < ShadowElementsCount; ++i) {
         auto *reply = xcb_get_image_reply(c, getImageCookies.at(i), nullptr);
         if (!reply) {
             discardReplies(i+1);
-            return false;
+            return nullptr;
         }
         auto &geo = pixmapGeometries[i];
         QImage image(xcb_get_image_data(reply), geo->width, geo->height, QImage::Format_ARGB32);
-        m_shadowElements[i] = QPixmap::fromImage(image);
+        pixmaps->elements[i] = QPixmap::fromImage(image);
         free(reply);
     }
-    m_topOffset = data[ShadowElementsCount];
-    m_rightOffset = data[ShadowElementsCount+1];
-    m_bottomOffset = data[ShadowElementsCount+2];
-    m_leftOffset = data[ShadowElementsCount+3];
-    updateShadowRegion();
-    if (!prepareBackend()) {
-        return false;
+    for (auto it = s_x11ShadowPixmaps.begin(); it != s_x11ShadowPixmaps.end();) {
+        if (it->isNull()) {
+            it = s_x11ShadowPixmaps.erase(it);
+        } else {
+            ++it;
+        }
     }
-    buildQuads();
-    return true;
+    s_x11ShadowPixmaps.insert(data, pixmaps);
+    return pixmaps;
 }
 
 bool Shadow::init(KDecoration2::Decoration *decoration)
@@ -361,6 +404,10 @@ bool Shadow::updateShadow()
         return false;
     }
 
+    if (m_x11ShadowPixmaps && m_x11ShadowPixmaps->ids == data.mid(0, ShadowElementsCount)) {
+        // the property got set again with the same pixmaps, their content might have changed
+        s_x11ShadowPixmaps.remove(m_x11ShadowPixmaps->ids);
+    }
     init(data);
 
     return true;
@@ -41,6 +41,7 @@ class ShadowInterface;
 namespace KWin {
 
 class Toplevel;
+class X11ShadowPixmaps;
 
 /**
  * @short Class representing a Window's Shadow to be rendered by the Compositor.
@@ -169,6 +170,7 @@ private:
     static Shadow *createShadowFromDecoration(Toplevel *toplevel);
     static Shadow *createShadowFromWayland(Toplevel *toplevel);
     static QVector<uint32_t> readX11ShadowProperty(xcb_window_t id);
+    static QSharedPointer<X11ShadowPixmaps> fetchX11ShadowPixmaps(const QVector<uint32_t> &data);
     bool init(const QVector<uint32_t> &data);
     bool init(KDecoration2::Decoration *decoration);
     bool init(const QPointer<KWayland::Server::ShadowInterface> &shadow);
@@ -185,6 +187,8 @@ private:
     QSize m_cachedSize;
     // Decoration based shadows
     QSharedPointer<KDecoration2::DecorationShadow> m_decorationShadow;
+    // X11 based shadows
+    QSharedPointer<X11ShadowPixmaps> m_x11ShadowPixmaps;
 };
 
 }
@@ -66,6 +66,12 @@ using namespace KWayland::Server;
 namespace KWin
 {
 
+static bool resizePacingEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("KWIN_WAYLAND_NO_RESIZE_PACING") == 0;
+    return enabled;
+}
+
 ShellClient::ShellClient(ShellSurfaceInterface *surface)
     : AbstractClient()
     , m_shellSurface(surface)
@@ -675,6 +681,8 @@ void ShellClient::setGeometry(int x, int y, int w, int h, ForceGeometry_t force)
         // size didn't change, and we don't need to explicitly request a new size
         doSetGeometry(newGeometry);
         updateMaximizeMode(m_requestedMaximizeMode);
+    } else if (isResize() && resizePacingEnabled()) {
+        requestPacedGeometry(newGeometry);
     } else {
         // size did change, Client needs to provide a new buffer
         requestGeometry(newGeometry);
@@ -1252,6 +1260,47 @@ void ShellClient::updatePendingGeometry()
     }
     doSetGeometry(QRect(position, m_clientSize + QSize(borderLeft() + borderRight(), borderTop() + borderBottom())));
     updateMaximizeMode(maximizeMode);
+    if (m_pacedGeometry.isValid() && m_pendingConfigureRequests.isEmpty()) {
+        schedulePacedGeometry();
+    }
+}
+
+void ShellClient::requestPacedGeometry(const QRect &rect)
+{
+    m_pacedGeometry = rect;
+    if (!m_pendingConfigureRequests.isEmpty()) {
+        // the client is still busy with the previous size, the commit
+        // after its ack triggers the next configure
+        return;
+    }
+    schedulePacedGeometry();
+}
+
+void ShellClient::schedulePacedGeometry()
+{
+    if (m_pacedGeometryConnection) {
+        return;
+    }
+    if (!Compositor::compositing()) {
+        sendPacedGeometry();
+        return;
+    }
+    // send the configure at the start of the next frame, so the client gets
+    // a whole frame to render the new size
+    m_pacedGeometryConnection = connect(Compositor::self(), &Compositor::aboutToComposite, this, &ShellClient::sendPacedGeometry);
+    Compositor::self()->scheduleRepaint();
+}
+
+void ShellClient::sendPacedGeometry()
+{
+    disconnect(m_pacedGeometryConnection);
+    m_pacedGeometryConnection = QMetaObject::Connection();
+    const QRect rect = m_pacedGeometry;
+    m_pacedGeometry = QRect();
+    // a finished resize already sent its final geometry
+    if (isResize() && rect.isValid()) {
+        requestGeometry(rect);
+    }
 }
 
 void ShellClient::clientFullScreenChanged(bool fullScreen)
@@ -1764,7 +1813,11 @@ bool ShellClient::isWaitingForMoveResizeSync() const
 
 void ShellClient::doResizeSync()
 {
-    requestGeometry(moveResizeGeometry());
+    if (resizePacingEnabled()) {
+        requestPacedGeometry(moveResizeGeometry());
+    } else {
+        requestGeometry(moveResizeGeometry());
+    }
 }
 
 QMatrix4x4 ShellClient::inputTransformation() const
@@ -221,6 +221,10 @@ private:
     void updateMaximizeMode(MaximizeMode maximizeMode);
     // called on surface commit and processes all m_pendingConfigureRequests up to m_lastAckedConfigureReqest
     void updatePendingGeometry();
+    // interactive resize: keeps at most one configure in flight, newer sizes replace older ones
+    void requestPacedGeometry(const QRect &rect);
+    void schedulePacedGeometry();
+    void sendPacedGeometry();
     QPoint popupOffset(const QRect &anchorRect, const Qt::Edges anchorEdge, const Qt::Edges gravity, const QSize popupSize) const;
     static void deleteClient(ShellClient *c);
 
@@ -246,6 +250,9 @@ private:
     };
     QVector<PendingConfigureRequest> m_pendingConfigureRequests;
     quint32 m_lastAckedConfigureRequest = 0;
+    // latest geometry of an interactive resize not yet sent to the client
+    QRect m_pacedGeometry;
+    QMetaObject::Connection m_pacedGeometryConnection;
 
     //mode in use by the current buffer
     MaximizeMode m_maximizeMode = MaximizeRestore;
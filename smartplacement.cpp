@@ -0,0 +1,162 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#include "smartplacement.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+static void sortUnique(QVector<int> &values)
+{
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+static int indexOf(const QVector<int> &lines, int value)
+{
+    return std::lower_bound(lines.constBegin(), lines.constEnd(), value) - lines.constBegin();
+}
+
+SmartPlacement::SmartPlacement(const QRect &area)
+    : m_area(area)
+{
+}
+
+void SmartPlacement::addWindow(const QRect &geometry, int weight)
+{
+    m_windows.append({geometry, weight});
+}
+
+QPoint SmartPlacement::place(const QSize &size) const
+{
+    // the window covers [x, x + cw) x [y, y + ch) when testing the overlap
+    const int cw = size.width() - 1;
+    const int ch = size.height() - 1;
+
+    if (m_area.left() + cw > m_area.right()) {
+        // not enough room in x direction at all
+        return m_area.topLeft();
+    }
+
+    QVector<int> xs;
+    QVector<int> ys;
+    xs.reserve(2 * m_windows.count() + 2);
+    ys.reserve(2 * m_windows.count() + 2);
+    xs << m_area.left() << m_area.right() - cw;
+    ys << m_area.top() << m_area.bottom() - ch;
+    for (const Window &window : m_windows) {
+        const QRect &geo = window.geometry;
+        xs << geo.x() + geo.width() << geo.x() - cw;
+        ys << geo.y() + geo.height() << geo.y() - ch;
+    }
+    sortUnique(xs);
+    sortUnique(ys);
+    xs.erase(std::remove_if(xs.begin(), xs.end(),
+        [this, cw] (int x) {
+            return x < m_area.left() || x + cw > m_area.right();
+        }), xs.end());
+    ys.erase(std::remove_if(ys.begin(), ys.end(),
+        [this] (int y) {
+            return y < m_area.top() || (y >= m_area.bottom() && y != m_area.top());
+        }), ys.end());
+
+    // the grid lines are all vertical window edges and all vertical edges of the candidates
+    QVector<int> gridX = xs;
+    for (int x : xs) {
+        gridX << x + cw;
+    }
+    for (const Window &window : m_windows) {
+        const QRect &geo = window.geometry;
+        gridX << geo.x() << geo.x() + geo.width();
+    }
+    sortUnique(gridX);
+    const int columns = gridX.count();
+
+    // the columns every weighted window covers
+    struct Span {
+        int left;
+        int right;
+    };
+    QVector<Span> spans;
+    spans.reserve(m_windows.count());
+    for (const Window &window : m_windows) {
+        const QRect &geo = window.geometry;
+        spans.append({indexOf(gridX, geo.x()), indexOf(gridX, geo.x() + geo.width())});
+    }
+
+    // Candidates are tested top down, one row at a time. The weighted height of every window
+    // overlapping the row gets spread over the columns it covers, which makes the overlap of a
+    // candidate the difference of two prefix sums. Only the current row is kept, so memory
+    // grows linearly with the number of windows.
+    QVector<qint64> columnWeights(columns);
+    // sums[column] holds the weighted overlap of the row left of the grid line
+    QVector<qint64> sums(columns);
+
+    QPoint optimal = m_area.topLeft();
+    qint64 minOverlap = -1;
+    for (int y : ys) {
+        if (y + ch > m_area.bottom() && ch < m_area.height()) {
+            // not enough room in y direction below this row
+            break;
+        }
+        std::fill(columnWeights.begin(), columnWeights.end(), 0);
+        for (int i = 0; i < m_windows.count(); ++i) {
+            const Window &window = m_windows.at(i);
+            if (window.weight == IgnoreWeight) {
+                continue;
+            }
+            const QRect &geo = window.geometry;
+            const qint64 height = qMin(y + ch, geo.y() + geo.height()) - qMax(y, geo.y());
+            if (height <= 0) {
+                continue;
+            }
+            columnWeights[spans.at(i).left] += window.weight * height;
+            columnWeights[spans.at(i).right] -= window.weight * height;
+        }
+        qint64 weight = 0;
+        sums[0] = 0;
+        for (int column = 0; column < columns - 1; ++column) {
+            weight += columnWeights.at(column);
+            sums[column + 1] = sums.at(column) + weight * (gridX.at(column + 1) - gridX.at(column));
+        }
+
+        for (int x : xs) {
+            const qint64 overlap = sums.at(indexOf(gridX, x + cw)) - sums.at(indexOf(gridX, x));
+            if (overlap == 0) {
+                optimal = QPoint(x, y);
+                minOverlap = 0;
+                break;
+            }
+            if (minOverlap < 0 || overlap < minOverlap) {
+                minOverlap = overlap;
+                optimal = QPoint(x, y);
+            }
+        }
+        if (minOverlap == 0) {
+            break;
+        }
+    }
+
+    if (ch >= m_area.height()) {
+        optimal.setY(m_area.top());
+    }
+    return optimal;
+}
+
+}
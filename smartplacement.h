@@ -0,0 +1,76 @@
+/********************************************************************
+ KWin - the KDE window manager
+ This file is part of the KDE project.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*********************************************************************/
+#ifndef KWIN_SMARTPLACEMENT_H
+#define KWIN_SMARTPLACEMENT_H
+
+#include <kwin_export.h>
+
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+namespace KWin
+{
+
+/**
+ * Finds the position with the least overlap for a new window, the algorithm
+ * behind Placement::placeSmart().
+ *
+ * Candidate positions are the area's top left corner and all positions where the
+ * new window touches one of the existing windows or the area's right or bottom edge.
+ * They are tested row by row, left to right, and the first position without any
+ * overlap is taken. If every position overlaps, the one with the least weighted
+ * overlap wins.
+ *
+ * For every row of candidates, the weighted overlap of the windows with the row is
+ * summed up over the columns spanned by the vertical edges of the windows and the
+ * candidates. Testing a position in the row is then a lookup of two prefix sums, and
+ * memory grows linearly with the number of windows.
+ */
+class KWIN_EXPORT SmartPlacement
+{
+public:
+    /**
+     * Weights of the overlap with a window, the overlapping area gets multiplied by it.
+     */
+    enum Weight {
+        IgnoreWeight = 0,
+        NormalWeight = 1,
+        KeepAboveWeight = 16
+    };
+
+    explicit SmartPlacement(const QRect &area);
+
+    void addWindow(const QRect &geometry, int weight = NormalWeight);
+    /**
+     * The top left position for a window of @p size.
+     */
+    QPoint place(const QSize &size) const;
+
+private:
+    struct Window {
+        QRect geometry;
+        int weight;
+    };
+    QRect m_area;
+    QVector<Window> m_windows;
+};
+
+}
+
+#endif
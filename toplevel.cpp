@@ -106,6 +106,15 @@ void Toplevel::detectShape(xcb_window_t id)
     }
 }
 
+void Toplevel::detectShape(Xcb::ShapeExtents &extents)
+{
+    const bool wasShape = is_shape;
+    is_shape = !extents.isNull() && extents->bounding_shaped > 0;
+    if (wasShape != is_shape) {
+        emit shapedChanged();
+    }
+}
+
 // used only by Deleted::copy()
 void Toplevel::copyToDeleted(Toplevel* c)
 {
@@ -153,7 +162,12 @@ QRect Toplevel::visibleRect() const
 
 Xcb::Property Toplevel::fetchWmClientLeader() const
 {
-    return Xcb::Property(false, window(), atoms->wm_client_leader, XCB_ATOM_WINDOW, 0, 10000);
+    return fetchWmClientLeader(window());
+}
+
+Xcb::Property Toplevel::fetchWmClientLeader(xcb_window_t window)
+{
+    return Xcb::Property(false, window, atoms->wm_client_leader, XCB_ATOM_WINDOW, 0, 10000);
 }
 
 void Toplevel::readWmClientLeader(Xcb::Property &prop)
@@ -199,6 +213,11 @@ void Toplevel::getWmClientMachine()
     m_clientMachine->resolve(window(), wmClientLeader());
 }
 
+void Toplevel::readWmClientMachine(const QByteArray &windowHostName)
+{
+    m_clientMachine->resolve(windowHostName, window(), wmClientLeader());
+}
+
 /**
  * Returns client machine for this client,
  * taken either from its window or from the leader window.
@@ -676,7 +695,12 @@ xcb_window_t Toplevel::frameId() const
 
 Xcb::Property Toplevel::fetchSkipCloseAnimation() const
 {
-    return Xcb::Property(false, window(), atoms->kde_skip_close_animation, XCB_ATOM_CARDINAL, 0, 1);
+    return fetchSkipCloseAnimation(window());
+}
+
+Xcb::Property Toplevel::fetchSkipCloseAnimation(xcb_window_t window)
+{
+    return Xcb::Property(false, window, atoms->kde_skip_close_animation, XCB_ATOM_CARDINAL, 0, 1);
 }
 
 void Toplevel::readSkipCloseAnimation(Xcb::Property &property)
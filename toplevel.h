@@ -587,6 +587,7 @@ protected:
     ~Toplevel() override;
     void setWindowHandles(xcb_window_t client);
     void detectShape(xcb_window_t id);
+    void detectShape(Xcb::ShapeExtents &extents);
     virtual void propertyNotifyEvent(xcb_property_notify_event_t *e);
     virtual void damageNotifyEvent();
     virtual void clientMessageEvent(xcb_client_message_event_t *e);
@@ -594,9 +595,11 @@ protected:
     void addDamageFull();
     virtual void addDamage(const QRegion &damage);
     Xcb::Property fetchWmClientLeader() const;
+    static Xcb::Property fetchWmClientLeader(xcb_window_t window);
     void readWmClientLeader(Xcb::Property &p);
     void getWmClientLeader();
     void getWmClientMachine();
+    void readWmClientMachine(const QByteArray &windowHostName);
     /**
      * @returns Whether there is a compositor and it is active.
      */
@@ -611,6 +614,7 @@ protected:
     void getResourceClass();
     void setResourceClass(const QByteArray &name, const QByteArray &className = QByteArray());
     Xcb::Property fetchSkipCloseAnimation() const;
+    static Xcb::Property fetchSkipCloseAnimation(xcb_window_t window);
     void readSkipCloseAnimation(Xcb::Property &prop);
     void getSkipCloseAnimation();
     virtual void debug(QDebug& stream) const = 0;
@@ -47,23 +47,21 @@ Unmanaged::~Unmanaged()
 {
 }
 
-bool Unmanaged::track(xcb_window_t w)
+bool Unmanaged::track(xcb_window_t w, const xcb_get_window_attributes_reply_t *attr, const xcb_get_geometry_reply_t *geo)
 {
     GRAB_SERVER_DURING_CONTEXT
-    Xcb::WindowAttributes attr(w);
-    Xcb::WindowGeometry geo(w);
-    if (attr.isNull() || attr->map_state != XCB_MAP_STATE_VIEWABLE) {
+    if (!attr || attr->map_state != XCB_MAP_STATE_VIEWABLE) {
         return false;
     }
     if (attr->_class == XCB_WINDOW_CLASS_INPUT_ONLY) {
         return false;
     }
-    if (geo.isNull()) {
+    if (!geo) {
         return false;
     }
     setWindowHandles(w);   // the window is also the frame
     Xcb::selectInput(w, attr->your_event_mask | XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_PROPERTY_CHANGE);
-    geom = geo.rect();
+    geom = QRect(geo->x, geo->y, geo->width, geo->height);
     checkScreen();
     m_visual = attr->visual;
     bit_depth = geo->depth;
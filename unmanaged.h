@@ -35,7 +35,7 @@ class Unmanaged
 public:
     explicit Unmanaged();
     bool windowEvent(xcb_generic_event_t *e);
-    bool track(xcb_window_t w);
+    bool track(xcb_window_t w, const xcb_get_window_attributes_reply_t *attr, const xcb_get_geometry_reply_t *geo);
     static void deleteUnmanaged(Unmanaged* c);
     int desktop() const override;
     QStringList activities() const override;
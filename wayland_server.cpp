@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "composite.h"
 #include "idle_inhibition.h"
 #include "internal_client.h"
+#include "presentation_time.h"
 #include "screens.h"
 #include "shell_client.h"
 #include "workspace.h"
@@ -189,6 +190,10 @@ void WaylandServer::createSurface(T *surface)
     } else {
         m_clients << client;
     }
+    m_clientsBySurface.insert(client->surface(), client);
+    if (client->windowId() != 0) {
+        m_clientsById.insert(client->windowId(), client);
+    }
     if (client->readyForPainting()) {
         emit shellClientAdded(client);
     } else {
@@ -358,6 +363,7 @@ bool WaylandServer::init(const QByteArray &socketName, InitalizationFlags flags)
     m_display->createPointerConstraints(PointerConstraintsInterfaceVersion::UnstableV1, m_display)->create();
     m_dataDeviceManager = m_display->createDataDeviceManager(m_display);
     m_dataDeviceManager->create();
+    m_presentationTime = new PresentationTime(m_display, m_display);
     m_idle = m_display->createIdle(m_display);
     m_idle->create();
     auto idleInhibition = new IdleInhibition(m_idle);
@@ -661,6 +667,21 @@ void WaylandServer::removeClient(ShellClient *c)
 {
     m_clients.removeAll(c);
     m_internalClients.removeAll(c);
+    if (c->surface() && m_clientsBySurface.value(c->surface()) == c) {
+        m_clientsBySurface.remove(c->surface());
+    } else {
+        // the surface is already destroyed and reset in the client, a new surface could
+        // get allocated at the same address, so find the stale entry by its value
+        for (auto it = m_clientsBySurface.begin(); it != m_clientsBySurface.end(); ++it) {
+            if (it.value() == c) {
+                m_clientsBySurface.erase(it);
+                break;
+            }
+        }
+    }
+    if (m_clientsById.value(c->windowId()) == c) {
+        m_clientsById.remove(c->windowId());
+    }
     emit shellClientRemoved(c);
 }
 
@@ -675,44 +696,12 @@ void WaylandServer::dispatch()
     m_display->dispatchEvents(0);
 }
 
-static ShellClient *findClientInList(const QList<ShellClient*> &clients, quint32 id)
-{
-    auto it = std::find_if(clients.begin(), clients.end(),
-        [id] (ShellClient *c) {
-            return c->windowId() == id;
-        }
-    );
-    if (it == clients.end()) {
-        return nullptr;
-    }
-    return *it;
-}
-
-static ShellClient *findClientInList(const QList<ShellClient*> &clients, KWayland::Server::SurfaceInterface *surface)
-{
-    auto it = std::find_if(clients.begin(), clients.end(),
-        [surface] (ShellClient *c) {
-            return c->surface() == surface;
-        }
-    );
-    if (it == clients.end()) {
-        return nullptr;
-    }
-    return *it;
-}
-
 ShellClient *WaylandServer::findClient(quint32 id) const
 {
     if (id == 0) {
         return nullptr;
     }
-    if (ShellClient *c = findClientInList(m_clients, id)) {
-        return c;
-    }
-    if (ShellClient *c = findClientInList(m_internalClients, id)) {
-        return c;
-    }
-    return nullptr;
+    return m_clientsById.value(id);
 }
 
 ShellClient *WaylandServer::findClient(SurfaceInterface *surface) const
@@ -720,13 +709,7 @@ ShellClient *WaylandServer::findClient(SurfaceInterface *surface) const
     if (!surface) {
         return nullptr;
     }
-    if (ShellClient *c = findClientInList(m_clients, surface)) {
-        return c;
-    }
-    if (ShellClient *c = findClientInList(m_internalClients, surface)) {
-        return c;
-    }
-    return nullptr;
+    return m_clientsBySurface.value(surface);
 }
 
 AbstractClient *WaylandServer::findAbstractClient(SurfaceInterface *surface) const
@@ -772,21 +755,21 @@ quint32 WaylandServer::createWindowId(SurfaceInterface *surface)
 
 quint16 WaylandServer::createClientId(ClientConnection *c)
 {
-    auto ids = m_clientIds.values().toSet();
-    quint16 id = 1;
-    if (!ids.isEmpty()) {
-        for (quint16 i = ids.count() + 1; i >= 1 ; i--) {
-            if (!ids.contains(i)) {
-                id = i;
-                break;
-            }
-        }
+    quint16 id;
+    if (!m_freeClientIds.isEmpty()) {
+        id = m_freeClientIds.takeLast();
+    } else {
+        Q_ASSERT(m_nextClientId != 0);
+        id = m_nextClientId++;
     }
-    Q_ASSERT(!ids.contains(id));
     m_clientIds.insert(c, id);
     connect(c, &ClientConnection::disconnected, this,
         [this] (ClientConnection *c) {
-            m_clientIds.remove(c);
+            auto it = m_clientIds.find(c);
+            if (it != m_clientIds.end()) {
+                m_freeClientIds << it.value();
+                m_clientIds.erase(it);
+            }
         }
     );
     return id;
@@ -76,6 +76,7 @@ class LinuxDmabufUnstableV1Buffer;
 namespace KWin
 {
 class ShellClient;
+class PresentationTime;
 
 class AbstractClient;
 class Toplevel;
@@ -125,6 +126,9 @@ public:
         return m_xdgOutputManager;
     }
     KWayland::Server::LinuxDmabufUnstableV1Interface *linuxDmabuf();
+    PresentationTime *presentationTime() const {
+        return m_presentationTime;
+    }
 
     QList<ShellClient*> clients() const {
         return m_clients;
@@ -270,6 +274,7 @@ private:
     KWayland::Server::XdgOutputManagerInterface *m_xdgOutputManager = nullptr;
     KWayland::Server::XdgDecorationManagerInterface *m_xdgDecorationManager = nullptr;
     KWayland::Server::LinuxDmabufUnstableV1Interface *m_linuxDmabuf = nullptr;
+    PresentationTime *m_presentationTime = nullptr;
     QSet<KWayland::Server::LinuxDmabufUnstableV1Buffer*> m_linuxDmabufBuffers;
     struct {
         KWayland::Server::ClientConnection *client = nullptr;
@@ -293,7 +298,13 @@ private:
     KWayland::Server::KeyStateInterface *m_keyState = nullptr;
     QList<ShellClient*> m_clients;
     QList<ShellClient*> m_internalClients;
+    // indexes for the lookups in findClient
+    QHash<KWayland::Server::SurfaceInterface*, ShellClient*> m_clientsBySurface;
+    QHash<quint32, ShellClient*> m_clientsById;
     QHash<KWayland::Server::ClientConnection*, quint16> m_clientIds;
+    // client ids of disconnected clients, reused before new ones get allocated
+    QVector<quint16> m_freeClientIds;
+    quint16 m_nextClientId = 1;
     InitalizationFlags m_initFlags;
     QVector<KWayland::Server::PlasmaShellSurfaceInterface*> m_plasmaShellSurfaces;
     KWIN_SINGLETON(WaylandServer)
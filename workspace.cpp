@@ -66,6 +66,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <KLocalizedString>
 #include <KStartupInfo>
 // Qt
+#include <QElapsedTimer>
 #include <QtConcurrentRun>
 
 namespace KWin
@@ -454,6 +455,9 @@ void Workspace::initWithX11()
         // Begin updates blocker block
         StackingUpdatesBlocker blocker(this);
 
+        QElapsedTimer adoptionTimer;
+        adoptionTimer.start();
+
         Xcb::Tree tree(rootWindow());
         xcb_window_t *wins = xcb_query_tree_children(tree.data());
 
@@ -466,9 +470,12 @@ void Workspace::initWithX11()
             windowGeometries[i] = Xcb::WindowGeometry(wins[i]);
         }
 
-        // Get the replies
+        // Get the replies and request everything needed to manage the windows. The
+        // replies of the manage requests are only waited for once all of them are issued.
+        std::vector<std::unique_ptr<ClientManageRequests>> manageRequests;
+        int unmanagedCount = 0;
         for (int i = 0; i < tree->children_len; i++) {
-            Xcb::WindowAttributes attr(windowAttributes.at(i));
+            Xcb::WindowAttributes &attr = windowAttributes[i];
 
             if (attr.isNull()) {
                 continue;
@@ -476,19 +483,32 @@ void Workspace::initWithX11()
 
             if (attr->override_redirect) {
                 if (attr->map_state == XCB_MAP_STATE_VIEWABLE &&
-                    attr->_class != XCB_WINDOW_CLASS_INPUT_ONLY)
-                    // ### This will request the attributes again
-                    createUnmanaged(wins[i]);
+                    attr->_class != XCB_WINDOW_CLASS_INPUT_ONLY) {
+                    if (createUnmanaged(wins[i], attr.data(), windowGeometries[i].data())) {
+                        unmanagedCount++;
+                    }
+                }
             } else if (attr->map_state != XCB_MAP_STATE_UNMAPPED) {
                 if (Application::wasCrash()) {
-                    fixPositionAfterCrash(wins[i], windowGeometries.at(i).data());
+                    fixPositionAfterCrash(wins[i], windowGeometries[i].data());
                 }
 
-                // ### This will request the attributes again
-                createClient(wins[i], true);
+                manageRequests.emplace_back(new ClientManageRequests(wins[i], attr, windowGeometries[i]));
             }
         }
 
+        int clientCount = 0;
+        for (const auto &requests : manageRequests) {
+            if (createClient(*requests, true)) {
+                clientCount++;
+            }
+        }
+        manageRequests.clear();
+
+        qCDebug(KWIN_CORE) << "Adopted" << clientCount << "clients and" << unmanagedCount
+                           << "unmanaged windows out of" << tree->children_len << "in"
+                           << adoptionTimer.elapsed() << "ms";
+
         // Propagate clients, will really happen at the end of the updates blocker block
         updateStackingOrder(true);
 
@@ -605,6 +625,12 @@ void Workspace::setupClientConnections(AbstractClient *c)
 }
 
 Client* Workspace::createClient(xcb_window_t w, bool is_mapped)
+{
+    ClientManageRequests requests(w);
+    return createClient(requests, is_mapped);
+}
+
+Client* Workspace::createClient(ClientManageRequests &requests, bool is_mapped)
 {
     StackingUpdatesBlocker blocker(this);
     Client* c = new Client();
@@ -613,7 +639,7 @@ Client* Workspace::createClient(xcb_window_t w, bool is_mapped)
         connect(c, &Client::blockingCompositingChanged, compositor, &X11Compositor::updateClientCompositeBlocking);
     }
     connect(c, SIGNAL(clientFullScreenSet(KWin::Client*,bool,bool)), ScreenEdges::self(), SIGNAL(checkBlocking()));
-    if (!c->manage(w, is_mapped)) {
+    if (!c->manage(requests, is_mapped)) {
         Client::deleteClient(c);
         return nullptr;
     }
@@ -622,6 +648,14 @@ Client* Workspace::createClient(xcb_window_t w, bool is_mapped)
 }
 
 Unmanaged* Workspace::createUnmanaged(xcb_window_t w)
+{
+    GRAB_SERVER_DURING_CONTEXT
+    Xcb::WindowAttributes attr(w);
+    Xcb::WindowGeometry geometry(w);
+    return createUnmanaged(w, attr.data(), geometry.data());
+}
+
+Unmanaged* Workspace::createUnmanaged(xcb_window_t w, const xcb_get_window_attributes_reply_t *attr, const xcb_get_geometry_reply_t *geometry)
 {
     if (X11Compositor *compositor = X11Compositor::self()) {
         if (compositor->checkForOverlayWindow(w)) {
@@ -629,7 +663,7 @@ Unmanaged* Workspace::createUnmanaged(xcb_window_t w)
         }
     }
     Unmanaged* c = new Unmanaged();
-    if (!c->track(w)) {
+    if (!c->track(w, attr, geometry)) {
         Unmanaged::deleteUnmanaged(c);
         return nullptr;
     }
@@ -924,7 +958,7 @@ void Workspace::slotCurrentDesktopChanged(uint oldDesktop, uint newDesktop)
     closeActivePopup();
     ++block_focus;
     StackingUpdatesBlocker blocker(this);
-    updateClientVisibilityOnDesktopChange(newDesktop);
+    updateClientVisibilityOnDesktopChange(oldDesktop, newDesktop);
     // Restore the focus on this desktop
     --block_focus;
 
@@ -932,35 +966,42 @@ void Workspace::slotCurrentDesktopChanged(uint oldDesktop, uint newDesktop)
     emit currentDesktopChanged(oldDesktop, movingClient);
 }
 
-void Workspace::updateClientVisibilityOnDesktopChange(uint newDesktop)
+void Workspace::updateClientVisibilityOnDesktopChange(uint oldDesktop, uint newDesktop)
 {
-    for (ToplevelList::ConstIterator it = stacking_order.constBegin();
-            it != stacking_order.constEnd();
-            ++it) {
-        Client *c = qobject_cast<Client*>(*it);
-        if (!c) {
+    // Only windows which are on exactly one of the two desktops change their visibility,
+    // e.g. windows on all desktops stay as they are. Decide on them before touching any:
+    // first all windows to hide, then the current desktop property, then all windows to show.
+    ClientList hide;
+    ClientList show;
+    for (Toplevel *toplevel : qAsConst(stacking_order)) {
+        Client *c = qobject_cast<Client*>(toplevel);
+        if (!c || !c->isOnCurrentActivity()) {
             continue;
         }
-        if (!c->isOnDesktop(newDesktop) && c != movingClient && c->isOnCurrentActivity()) {
-            (c)->updateVisibility();
+        const bool wasOnDesktop = c->isOnDesktop(oldDesktop);
+        const bool isOnDesktop = c->isOnDesktop(newDesktop);
+        if (wasOnDesktop && !isOnDesktop && c != movingClient) {
+            hide.append(c);
+        } else if (!wasOnDesktop && isOnDesktop) {
+            // shown top to bottom
+            show.prepend(c);
         }
     }
+    for (Client *c : qAsConst(hide)) {
+        c->updateVisibility();
+    }
     // Now propagate the change, after hiding, before showing
     if (rootInfo()) {
         rootInfo()->setCurrentDesktop(VirtualDesktopManager::self()->current());
     }
 
+    // updates its visibility itself
     if (movingClient && !movingClient->isOnDesktop(newDesktop)) {
         movingClient->setDesktop(newDesktop);
     }
 
-    for (int i = stacking_order.size() - 1; i >= 0 ; --i) {
-        Client *c = qobject_cast<Client*>(stacking_order.at(i));
-        if (!c) {
-            continue;
-        }
-        if (c->isOnDesktop(newDesktop) && c->isOnCurrentActivity())
-            c->updateVisibility();
+    for (Client *c : qAsConst(show)) {
+        c->updateVisibility();
     }
     if (showingDesktop())   // Do this only after desktop change to avoid flicker
         setShowingDesktop(false);
@@ -52,6 +52,7 @@ class Window;
 
 class AbstractClient;
 class Client;
+class ClientManageRequests;
 class Compositor;
 class KillWindow;
 class ShortcutDialog;
@@ -523,9 +524,11 @@ private:
 
     /// This is the right way to create a new client
     Client* createClient(xcb_window_t w, bool is_mapped);
+    Client* createClient(ClientManageRequests &requests, bool is_mapped);
     void setupClientConnections(AbstractClient *client);
     void addClient(Client* c);
     Unmanaged* createUnmanaged(xcb_window_t w);
+    Unmanaged* createUnmanaged(xcb_window_t w, const xcb_get_window_attributes_reply_t *attr, const xcb_get_geometry_reply_t *geometry);
     void addUnmanaged(Unmanaged* c);
 
     //---------------------------------------------------------------------
@@ -533,7 +536,7 @@ private:
     void closeActivePopup();
     void updateClientArea(bool force);
     void resetClientAreas(uint desktopCount);
-    void updateClientVisibilityOnDesktopChange(uint newDesktop);
+    void updateClientVisibilityOnDesktopChange(uint oldDesktop, uint newDesktop);
     void activateClientOnNewDesktop(uint desktop);
     AbstractClient *findClientToActivateOnDesktop(uint desktop);
 
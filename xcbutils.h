@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <xcb/xcb.h>
 #include <xcb/composite.h>
 #include <xcb/randr.h>
+#include <xcb/shape.h>
 
 #include <xcb/shm.h>
 
@@ -551,6 +552,7 @@ private:
 
 XCB_WRAPPER(WindowAttributes, xcb_get_window_attributes, xcb_window_t)
 XCB_WRAPPER(OverlayWindow, xcb_composite_get_overlay_window, xcb_window_t)
+XCB_WRAPPER(ShapeExtents, xcb_shape_query_extents, xcb_window_t)
 
 XCB_WRAPPER_DATA(GeometryData, xcb_get_geometry, xcb_drawable_t)
 class WindowGeometry : public Wrapper<GeometryData, xcb_window_t>